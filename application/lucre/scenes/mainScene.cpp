@@ -111,6 +111,8 @@ namespace LucreApp
         );
         m_VolcanoSmoke = std::make_shared<ParticleSystem>(poolSize, zaxis, &m_SpritesheetSmoke, 5.0f /*amplification*/, 1/*unlit*/);
 
+        // restored on reset, see OnEvent()
+        m_Checkpoint.Capture(*this);
     }
 
     void MainScene::Load()
@@ -119,6 +121,12 @@ namespace LucreApp
         loader.Deserialize();
     }
 
+    void MainScene::Save()
+    {
+        SceneLoader loader(*this);
+        loader.Serialize();
+    }
+
     void MainScene::LoadScripts()
     {
         auto duck = m_Dictionary.Retrieve("application/lucre/models/duck/duck.gltf::SceneWithDuck::duck");
@@ -217,6 +225,8 @@ namespace LucreApp
                 switch(event.GetKeyCode())
                 {
                     case ENGINE_KEY_R:
+                        // the camera controller and the physics bodies are not part of the registry
+                        m_Checkpoint.Restore(*this);
                         ResetScene();
                         ResetBananas();
                         break;
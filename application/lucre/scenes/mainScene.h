@@ -28,6 +28,7 @@
 #include "scene/entity.h"
 #include "scene/components.h"
 #include "scene/particleSystem.h"
+#include "scene/sceneSnapshot.h"
 #include "sprite/spriteAnimation.h"
 #include "renderer/texture.h"
 #include "renderer/renderer.h"
@@ -58,7 +59,7 @@ namespace LucreApp
         virtual void OnResize() override;
 
         virtual void Load() override;
-        virtual void Save() override {}
+        virtual void Save() override;
         virtual void LoadScripts() override;
         virtual void StartScripts() override;
 
@@ -104,6 +105,9 @@ namespace LucreApp
 
         std::shared_ptr<ParticleSystem> m_VolcanoSmoke;
 
+        // state after loading, restored on reset
+        SceneSnapshot m_Checkpoint;
+
         static constexpr uint HORN_ANIMATION_SPRITES = 25;
         entt::entity m_Guybrush[HORN_ANIMATION_SPRITES];
         SpriteSheet m_SpritesheetHorn;
@@ -0,0 +1,66 @@
+-- assetcooker.lua
+project "assetcooker"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+    targetdir "bin/%{cfg.buildcfg}"
+    objdir ("bin-int/%{cfg.buildcfg}")
+
+    defines
+    {
+        "ENGINE_VERSION=\"0.1.1\"",
+    }
+
+    files 
+    {
+        "assetcooker/**.h",
+        "assetcooker/**.cpp",
+        "engine/auxiliary/assetPak.cpp",
+        "engine/auxiliary/lz4.cpp",
+        "engine/auxiliary/mappedFile.cpp",
+        "engine/auxiliary/file.cpp",
+        "engine/log/log.cpp",
+    }
+
+    includedirs 
+    {
+        "./",
+        "assetcooker",
+        "engine",
+        "vendor",
+        "vendor/spdlog/include",
+        "vendor/yaml-cpp/include",
+        "vendor/json",
+        "vendor/glm",
+    }
+
+    flags
+    {
+        "MultiProcessorCompile"
+    }
+
+    links
+    {
+        "yaml-cpp",
+    }
+
+    filter "system:linux"
+        defines
+        {
+            "LINUX",
+        }
+
+    filter { "configurations:Debug" }
+        defines { "DEBUG" }
+        symbols "On"
+
+    filter { "configurations:Release" }
+        defines { "NDEBUG" }
+        optimize "On"
+
+    filter { "configurations:Dist" }
+        defines {
+            "NDEBUG",
+            "DISTRIBUTION_BUILD"
+        }
+        optimize "On"
@@ -0,0 +1,359 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+// assetcooker <output.pak> <input>...
+//
+// packs assets and their dependencies into one package:
+//   *.scene, *.prefab  the description, its glTF files and prefabs
+//   *.gltf             the glTF file, its buffers and images
+//   *.obj              the OBJ file, its material libraries and their textures
+//   directories        every asset file below the directory
+//   other files        the file as is
+// images and sounds are already compressed and are stored raw
+
+#include <set>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+
+#include "engine.h"
+#include "auxiliary/assetPak.h"
+#include "yaml-cpp/yaml.h"
+#include "json.hpp"
+
+using namespace GfxRenderEngine;
+
+namespace
+{
+    const std::set<std::string> ASSET_EXTENSIONS
+    {
+        ".scene", ".prefab", ".gltf", ".glb", ".bin", ".obj", ".mtl", ".png", ".jpg", ".jpeg", ".ogg", ".wav"
+    };
+    const std::set<std::string> COMPRESSED_EXTENSIONS
+    {
+        ".png", ".jpg", ".jpeg", ".ogg"
+    };
+
+    class AssetCooker
+    {
+
+    public:
+
+        void Cook(const std::string& input);
+        bool Write(const std::string& filepath) { return m_Writer.Write(filepath); }
+        const AssetPakWriter& GetWriter() const { return m_Writer; }
+        uint GetErrors() const { return m_Errors; }
+
+    private:
+
+        bool AddFile(const std::string& filepath);
+        void CookSceneDescription(const std::string& filepath);
+        void CookGLTF(const std::string& filepath);
+        void CookOBJ(const std::string& filepath);
+        void CookMTL(const std::string& filepath);
+
+        static std::string Extension(const std::string& filepath);
+        static std::string Directory(const std::string& filepath);
+        static std::string DecodeURI(const std::string& uri);
+        static bool ReadFile(const std::string& filepath, std::vector<uchar>& data);
+
+    private:
+
+        AssetPakWriter m_Writer;
+        std::set<std::string> m_Visited;
+        uint m_Errors{0};
+
+    };
+
+    std::string AssetCooker::Extension(const std::string& filepath)
+    {
+        std::string extension = std::filesystem::path(filepath).extension().string();
+        for (auto& character : extension)
+        {
+            character = static_cast<char>(std::tolower(character));
+        }
+        return extension;
+    }
+
+    std::string AssetCooker::Directory(const std::string& filepath)
+    {
+        std::string directory = std::filesystem::path(filepath).parent_path().generic_string();
+        return directory.empty() ? directory : directory + "/";
+    }
+
+    // glTF URIs are percent-encoded
+    std::string AssetCooker::DecodeURI(const std::string& uri)
+    {
+        std::string decoded;
+        for (size_t index = 0; index < uri.size(); index++)
+        {
+            if ((uri[index] == '%') && (index + 2 < uri.size()))
+            {
+                decoded += static_cast<char>(std::stoi(uri.substr(index + 1, 2), nullptr, 16));
+                index += 2;
+            }
+            else
+            {
+                decoded += uri[index];
+            }
+        }
+        return decoded;
+    }
+
+    bool AssetCooker::ReadFile(const std::string& filepath, std::vector<uchar>& data)
+    {
+        std::ifstream inputFile(filepath, std::ios::binary | std::ios::ate);
+        if (!inputFile.is_open())
+        {
+            return false;
+        }
+        data.resize(static_cast<size_t>(inputFile.tellg()));
+        inputFile.seekg(0);
+        inputFile.read(reinterpret_cast<char*>(data.data()), data.size());
+        return inputFile.good();
+    }
+
+    // false if the file was added before or could not be read
+    bool AssetCooker::AddFile(const std::string& filepath)
+    {
+        std::string path = AssetPak::NormalizePath(filepath);
+        if (!m_Visited.insert(path).second)
+        {
+            return false;
+        }
+
+        std::vector<uchar> data;
+        if (!ReadFile(path, data))
+        {
+            LOG_CORE_ERROR("assetcooker: could not read {0}", path);
+            m_Errors++;
+            return false;
+        }
+        bool compress = COMPRESSED_EXTENSIONS.find(Extension(path)) == COMPRESSED_EXTENSIONS.end();
+        m_Writer.Add(path, std::move(data), compress);
+        return true;
+    }
+
+    void AssetCooker::Cook(const std::string& input)
+    {
+        if (std::filesystem::is_directory(input))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(input))
+            {
+                auto filepath = entry.path().generic_string();
+                if (entry.is_regular_file() && (ASSET_EXTENSIONS.find(Extension(filepath)) != ASSET_EXTENSIONS.end()))
+                {
+                    Cook(filepath);
+                }
+            }
+            return;
+        }
+
+        auto extension = Extension(input);
+        if ((extension == ".scene") || (extension == ".prefab"))
+        {
+            CookSceneDescription(input);
+        }
+        else if (extension == ".gltf")
+        {
+            CookGLTF(input);
+        }
+        else if (extension == ".obj")
+        {
+            CookOBJ(input);
+        }
+        else if (extension == ".mtl")
+        {
+            CookMTL(input);
+        }
+        else
+        {
+            AddFile(input);
+        }
+    }
+
+    // paths in scene descriptions are relative to the working directory, like in the engine
+    void AssetCooker::CookSceneDescription(const std::string& filepath)
+    {
+        if (!AddFile(filepath))
+        {
+            return;
+        }
+
+        YAML::Node yamlNode;
+        try
+        {
+            yamlNode = YAML::LoadFile(filepath);
+        }
+        catch (const YAML::Exception& exception)
+        {
+            LOG_CORE_ERROR("assetcooker: could not parse {0} ({1})", filepath, exception.what());
+            m_Errors++;
+            return;
+        }
+
+        for (auto key : {"glTF-files", "prefabs"})
+        {
+            if (yamlNode[key])
+            {
+                for (const auto& file : yamlNode[key])
+                {
+                    Cook(file.as<std::string>());
+                }
+            }
+        }
+    }
+
+    void AssetCooker::CookGLTF(const std::string& filepath)
+    {
+        if (!AddFile(filepath))
+        {
+            return;
+        }
+
+        nlohmann::json gltf;
+        {
+            std::ifstream inputFile(filepath);
+            gltf = nlohmann::json::parse(inputFile, nullptr, false);
+        }
+        if (gltf.is_discarded())
+        {
+            LOG_CORE_ERROR("assetcooker: could not parse {0}", filepath);
+            m_Errors++;
+            return;
+        }
+
+        // embedded data URIs need no extra file
+        auto directory = Directory(filepath);
+        for (auto key : {"buffers", "images"})
+        {
+            if (!gltf.contains(key))
+            {
+                continue;
+            }
+            for (const auto& resource : gltf[key])
+            {
+                if (resource.contains("uri") && resource["uri"].is_string())
+                {
+                    auto uri = resource["uri"].get<std::string>();
+                    if (uri.rfind("data:", 0) != 0)
+                    {
+                        AddFile(directory + DecodeURI(uri));
+                    }
+                }
+            }
+        }
+    }
+
+    void AssetCooker::CookOBJ(const std::string& filepath)
+    {
+        if (!AddFile(filepath))
+        {
+            return;
+        }
+
+        std::ifstream inputFile(filepath);
+        std::string line;
+        while (std::getline(inputFile, line))
+        {
+            std::istringstream stream(line);
+            std::string keyword, library;
+            stream >> keyword;
+            if (keyword == "mtllib")
+            {
+                while (stream >> library)
+                {
+                    CookMTL(Directory(filepath) + library);
+                }
+            }
+        }
+    }
+
+    void AssetCooker::CookMTL(const std::string& filepath)
+    {
+        if (!AddFile(filepath))
+        {
+            return;
+        }
+
+        // texture maps: the file name is the last token of the line
+        std::ifstream inputFile(filepath);
+        std::string line;
+        while (std::getline(inputFile, line))
+        {
+            std::istringstream stream(line);
+            std::string keyword, token, texture;
+            stream >> keyword;
+            if ((keyword.rfind("map_", 0) == 0) || (keyword == "bump") || (keyword == "disp") || (keyword == "norm"))
+            {
+                while (stream >> token)
+                {
+                    texture = token;
+                }
+                if (!texture.empty())
+                {
+                    AddFile(Directory(filepath) + texture);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Log::Init();
+
+    if (argc < 3)
+    {
+        std::cout << "usage: assetcooker <output.pak> <scene, prefab, glTF, OBJ, file or directory>..." << std::endl;
+        return -1;
+    }
+
+    AssetCooker cooker;
+    for (int index = 2; index < argc; index++)
+    {
+        cooker.Cook(argv[index]);
+    }
+
+    std::string outputFilepath = argv[1];
+    auto outputDirectory = std::filesystem::path(outputFilepath).parent_path();
+    if (!outputDirectory.empty())
+    {
+        std::error_code errorCode;
+        std::filesystem::create_directories(outputDirectory, errorCode);
+    }
+
+    if (!cooker.Write(outputFilepath))
+    {
+        LOG_CORE_CRITICAL("assetcooker: could not write {0}", outputFilepath);
+        return -1;
+    }
+
+    auto& writer = cooker.GetWriter();
+    LOG_CORE_INFO("assetcooker: {0} entries, {1} bytes, {2} bytes stored, written to {3}",
+                  writer.Entries(), writer.GetSize(), writer.GetStoredSize(), outputFilepath);
+    return cooker.GetErrors() ? -1 : 0;
+}
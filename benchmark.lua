@@ -0,0 +1,165 @@
+-- benchmark.lua
+project "benchmark"
+    language "C++"
+    cppdialect "C++17"
+    targetdir "bin/%{cfg.buildcfg}"
+    objdir ("bin-int/%{cfg.buildcfg}")
+
+    defines
+    {
+        "PROFILING"
+    }
+
+    files 
+    {
+        "benchmark/**.h",
+        "benchmark/**.cpp",
+        "vendor/tinygltf/tiny_gltf.cpp",
+    }
+
+    includedirs 
+    {
+        "./",
+        "benchmark",
+        "engine",
+        "engine/platform/Vulkan",
+        "vendor",
+        "vendor/imgui",
+        "resources",
+        "vendor/sdl/include",
+        "vendor/spdlog/include",
+        "vendor/yaml-cpp/include",
+        "vendor/tinyObjLoader",
+        "vendor/box2d/include",
+        "vendor/entt/include",
+        "vendor/json",
+        "vendor/glm",
+        "vendor/stb",
+    }
+
+    libdirs
+    {
+    }
+
+    flags
+    {
+        "MultiProcessorCompile"
+    }
+
+    links
+    {
+        "engine",
+        "glfw3",
+        "sdl_mixer",
+        "sdl",
+        "libvorbis",
+        "libogg",
+        "yaml-cpp",
+        "box2d",
+        "shaderc",
+        "shaderc_util",
+        "SPIRV-Tools-opt",
+        "SPIRV-Tools",
+        "MachineIndependent",
+        "OSDependent",
+        "GenericCodeGen",
+        "OGLCompiler",
+        "SPIRV",
+    }
+
+    prebuildcommands
+    {
+    }
+
+    filter "system:linux"
+
+        linkoptions { "-fno-pie -no-pie" }
+
+        prebuildcommands
+        {
+            "scripts/compileShaders.sh"
+        }
+
+        files 
+        { 
+        }
+        includedirs 
+        {
+            "vendor/pamanager/libpamanager/src",
+
+            -- resource system: glib-2.0
+            -- this should actually be `pkg-config glib-2.0 --cflags`
+            "/usr/include/glib-2.0",
+            "/usr/lib/x86_64-linux-gnu/glib-2.0/include",
+            "/usr/lib/glib-2.0/include/",
+            "/usr/lib64/glib-2.0/include/",
+            -- end resource system: glib-2.0
+        }
+        links
+        {
+            "m",
+            "dl", 
+            "vulkan",
+            "pthread",
+            "X11",
+            "Xrandr",
+            "Xi",
+            "libpamanager",
+            "pulse",
+            "glib-2.0",
+            "gio-2.0",
+        }
+        libdirs
+        {
+        }
+        defines
+        {
+            "LINUX",
+        }
+
+    filter "system:windows"
+        defines
+        {
+        }
+        includedirs 
+        {
+            "vendor/VulkanSDK/Include",
+        }
+        links
+        {
+            "imagehlp", 
+            "dinput8", 
+            "dxguid", 
+            "user32", 
+            "gdi32", 
+            "imm32", 
+            "ole32",
+            "oleaut32",
+            "shell32",
+            "version",
+            "uuid",
+            "Setupapi",
+            "vulkan-1",
+        }
+        libdirs 
+        {
+            "vendor/VulkanSDK/Lib",
+        }
+
+    filter { "configurations:Debug" }
+        defines { "DEBUG" }
+        symbols "On"
+        kind "ConsoleApp"
+
+    filter { "configurations:Release" }
+        defines { "NDEBUG" }
+        optimize "On"
+        kind "ConsoleApp"
+
+    filter { "configurations:Dist" }
+        defines {
+            "NDEBUG",
+            "DISTRIBUTION_BUILD"
+        }
+        optimize "On"
+        kind "ConsoleApp"
@@ -0,0 +1,253 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#include "core.h"
+#include "engine.h"
+#include "VKcore.h"
+#include "VKrenderer.h"
+#include "VKgpuTimer.h"
+
+#include "benchmarkScene.h"
+
+using namespace GfxRenderEngine;
+
+namespace BenchmarkApp
+{
+    static constexpr uint WARMUP_FRAMES = 10;
+
+    struct Options
+    {
+        std::string m_SceneFile;
+        std::string m_OutputFile;
+        uint m_Frames = 500;
+        uint m_Width  = 1280;
+        uint m_Height = 720;
+    };
+
+    struct Summary
+    {
+        double m_Mean = 0.0;
+        double m_Max = 0.0;
+        double m_P50 = 0.0;
+        double m_P95 = 0.0;
+        double m_P99 = 0.0;
+    };
+
+    static void PrintUsage(const char* program)
+    {
+        std::cout << "usage: " << program
+                  << " <scene file> [--frames N] [--width W] [--height H] [--output file.json]"
+                  << std::endl;
+    }
+
+    static bool ParseOptions(int argc, char* argv[], Options& options)
+    {
+        for (int index = 1; index < argc; index++)
+        {
+            std::string argument = argv[index];
+            bool hasValue = (index + 1) < argc;
+            if ((argument == "--frames") && hasValue)
+            {
+                options.m_Frames = std::stoul(argv[++index]);
+            }
+            else if ((argument == "--width") && hasValue)
+            {
+                options.m_Width = std::stoul(argv[++index]);
+            }
+            else if ((argument == "--height") && hasValue)
+            {
+                options.m_Height = std::stoul(argv[++index]);
+            }
+            else if ((argument == "--output") && hasValue)
+            {
+                options.m_OutputFile = argv[++index];
+            }
+            else if (options.m_SceneFile.empty() && (argument.rfind("--", 0) != 0))
+            {
+                options.m_SceneFile = argument;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return !options.m_SceneFile.empty() && options.m_Frames && options.m_Width && options.m_Height;
+    }
+
+    // nearest-rank percentiles
+    static Summary Summarize(std::vector<double> samples)
+    {
+        Summary summary{};
+        if (samples.empty())
+        {
+            return summary;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&](double p)
+        {
+            size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+            return samples[std::clamp(rank, size_t(1), samples.size()) - 1];
+        };
+        double sum = 0.0;
+        for (auto sample : samples)
+        {
+            sum += sample;
+        }
+        summary.m_Mean = sum / samples.size();
+        summary.m_Max  = samples.back();
+        summary.m_P50  = percentile(50.0);
+        summary.m_P95  = percentile(95.0);
+        summary.m_P99  = percentile(99.0);
+        return summary;
+    }
+
+    static void WriteSummary(std::ostream& out, const char* name, const Summary& summary, bool last = false)
+    {
+        out << "    \"" << name << "\": { "
+            << "\"mean\": " << summary.m_Mean << ", "
+            << "\"p50\": "  << summary.m_P50  << ", "
+            << "\"p95\": "  << summary.m_P95  << ", "
+            << "\"p99\": "  << summary.m_P99  << ", "
+            << "\"max\": "  << summary.m_Max  << " }"
+            << (last ? "\n" : ",\n");
+    }
+
+    static int Run(const Options& options)
+    {
+        auto engine = std::make_unique<Engine>("./");
+        if (!engine->StartHeadless(options.m_Width, options.m_Height))
+        {
+            return -1;
+        }
+        auto renderer = std::static_pointer_cast<VK_Renderer>(engine->GetRenderer());
+
+        float aspectRatio = static_cast<float>(options.m_Width) / static_cast<float>(options.m_Height);
+        auto scene = std::make_unique<BenchmarkScene>(options.m_SceneFile, aspectRatio);
+        scene->Load();
+        scene->Start();
+
+        // measure with all textures and meshes resident, not with streaming placeholders
+        VK_Renderer::m_ResourceStreamer->Flush();
+
+        std::vector<double> frameTimes;
+        std::vector<double> cpuTimes;
+        std::vector<double> fenceWaitTimes;
+        std::vector<double> gpuFrameTimes;
+        std::vector<double> gpuStageTimes;
+        std::vector<double> drawCalls;
+        std::vector<double> instances;
+        frameTimes.reserve(options.m_Frames);
+        cpuTimes.reserve(options.m_Frames);
+        fenceWaitTimes.reserve(options.m_Frames);
+        gpuFrameTimes.reserve(options.m_Frames);
+        gpuStageTimes.reserve(options.m_Frames);
+        drawCalls.reserve(options.m_Frames);
+        instances.reserve(options.m_Frames);
+
+        uint totalFrames = WARMUP_FRAMES + options.m_Frames;
+        for (uint frame = 0; (frame < totalFrames) && engine->IsRunning(); frame++)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            scene->SetCameraPath(static_cast<float>(frame) / static_cast<float>(totalFrames));
+            renderer->BeginFrame(&scene->GetCamera(), scene->GetRegistry());
+            renderer->Submit(scene->GetRegistry(), scene->GetSceneHierarchy());
+            renderer->EndScene();
+
+            auto end = std::chrono::steady_clock::now();
+
+            if (frame < WARMUP_FRAMES)
+            {
+                continue;
+            }
+            // the frame time includes waiting for the GPU, the CPU time does not
+            double frameTime = std::chrono::duration<double, std::milli>(end - start).count();
+            double fenceWaitTime = renderer->GetFenceWaitTime();
+            frameTimes.push_back(frameTime);
+            fenceWaitTimes.push_back(fenceWaitTime);
+            cpuTimes.push_back(std::max(frameTime - fenceWaitTime, 0.0));
+            // GPU results arrive MAX_FRAMES_IN_FLIGHT frames late; the warmup covers the gap
+            gpuFrameTimes.push_back(VK_Renderer::m_GpuTimer ? VK_Renderer::m_GpuTimer->GetLastFrameTime() : 0.0);
+            gpuStageTimes.push_back(VK_Renderer::m_GpuTimer ? VK_Renderer::m_GpuTimer->GetLastStageTime() : 0.0);
+            drawCalls.push_back(renderer->GetDrawCalls());
+            instances.push_back(renderer->GetInstanceCount());
+        }
+        VK_Core::m_Device->Shutdown();
+
+        auto memory = VK_Core::m_Device->GetAllocator().GetStatistics();
+
+        std::stringstream json;
+        json << "{\n"
+             << "    \"scene\": \"" << options.m_SceneFile << "\",\n"
+             << "    \"device\": \"" << VK_Core::m_Device->properties.deviceName << "\",\n"
+             << "    \"width\": " << options.m_Width << ",\n"
+             << "    \"height\": " << options.m_Height << ",\n"
+             << "    \"frames\": " << frameTimes.size() << ",\n";
+        WriteSummary(json, "frame time ms", Summarize(frameTimes));
+        WriteSummary(json, "cpu time ms", Summarize(cpuTimes));
+        WriteSummary(json, "fence wait ms", Summarize(fenceWaitTimes));
+        WriteSummary(json, "gpu frame time ms", Summarize(gpuFrameTimes));
+        WriteSummary(json, "gpu stage time ms", Summarize(gpuStageTimes));
+        WriteSummary(json, "draw calls", Summarize(drawCalls));
+        WriteSummary(json, "instances", Summarize(instances));
+        json << "    \"memory\": { "
+             << "\"bytes in use\": " << memory.m_BytesInUse << ", "
+             << "\"bytes allocated\": " << memory.m_BytesAllocated << ", "
+             << "\"blocks\": " << memory.m_BlockCount << " }\n"
+             << "}\n";
+
+        std::cout << json.str();
+        if (!options.m_OutputFile.empty())
+        {
+            std::ofstream outputFile(options.m_OutputFile);
+            if (!outputFile)
+            {
+                LOG_CORE_ERROR("benchmark: could not write {0}", options.m_OutputFile);
+                return -1;
+            }
+            outputFile << json.str();
+        }
+
+        scene->Stop();
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkApp::Options options;
+    if (!BenchmarkApp::ParseOptions(argc, argv, options))
+    {
+        BenchmarkApp::PrintUsage(argv[0]);
+        return -1;
+    }
+    return BenchmarkApp::Run(options);
+}
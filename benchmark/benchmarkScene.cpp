@@ -0,0 +1,66 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "core.h"
+#include "scene/components.h"
+#include "scene/sceneLoader.h"
+
+#include "benchmarkScene.h"
+
+namespace BenchmarkApp
+{
+    BenchmarkScene::BenchmarkScene(const std::string& filepath, float aspectRatio)
+        : Scene(filepath), m_AspectRatio{aspectRatio}
+    {
+    }
+
+    void BenchmarkScene::Load()
+    {
+        SceneLoader loader(*this);
+        loader.Deserialize();
+    }
+
+    void BenchmarkScene::Start()
+    {
+        m_IsRunning = true;
+
+        m_Camera.SetPerspectiveProjection(glm::radians(50.0f), m_AspectRatio, 0.1f, 50.0f);
+        SetCameraPath(0.0f);
+
+        // one light above the center of the scene
+        auto pointLight = CreatePointLight(1.0f, 0.1f);
+        TransformComponent transform{};
+        transform.SetTranslation({0.0f, 2.0f, 0.0f});
+        m_Registry.emplace<TransformComponent>(pointLight, transform);
+    }
+
+    void BenchmarkScene::SetCameraPath(float progress)
+    {
+        // one orbit around the origin, starting at the default view of lucre
+        static constexpr float RADIUS = 3.6f;
+        static constexpr float HEIGHT = 1.08f;
+
+        float angle = progress * glm::two_pi<float>();
+        glm::vec3 position{RADIUS * glm::sin(angle), HEIGHT, RADIUS * glm::cos(angle)};
+        m_Camera.SetViewYXZ(position, {-0.04f, angle, 0.0f});
+    }
+}
@@ -0,0 +1,262 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+#include "auxiliary/assetPak.h"
+#include "auxiliary/hash.h"
+#include "auxiliary/lz4.h"
+
+namespace GfxRenderEngine
+{
+
+    uint64 AssetPak::HashPath(const std::string& path)
+    {
+        return HashBuffer(path.data(), path.size());
+    }
+
+    std::string AssetPak::NormalizePath(const std::string& path)
+    {
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+
+    bool AssetPak::Open(const std::string& filepath)
+    {
+        m_Filepath = filepath;
+        m_Valid = false;
+        m_Entries.clear();
+
+        if (!m_File.Open(filepath) || (m_File.Size() < sizeof(Header)))
+        {
+            LOG_CORE_WARN("AssetPak::Open: could not open {0}", filepath);
+            return false;
+        }
+
+        Header header;
+        memcpy(&header, m_File.Data(), sizeof(Header));
+        uint64 size = m_File.Size();
+        uint64 tocSize = static_cast<uint64>(header.m_EntryCount) * sizeof(Entry);
+        if ((header.m_Magic != MAGIC) || (header.m_Version != VERSION) ||
+            (header.m_TocOffset > size) || (tocSize > size - header.m_TocOffset) ||
+            (header.m_StringsOffset > size) || (header.m_StringsSize > size - header.m_StringsOffset))
+        {
+            LOG_CORE_WARN("AssetPak::Open: invalid or outdated package {0}", filepath);
+            return false;
+        }
+
+        m_Entries.resize(header.m_EntryCount);
+        memcpy(m_Entries.data(), m_File.Data() + header.m_TocOffset, tocSize);
+        for (auto& entry : m_Entries)
+        {
+            if ((entry.m_Offset > size) || (entry.m_StoredSize > size - entry.m_Offset) ||
+                (static_cast<uint64>(entry.m_PathOffset) + entry.m_PathLength > header.m_StringsSize))
+            {
+                LOG_CORE_WARN("AssetPak::Open: corrupt table of contents in {0}", filepath);
+                m_Entries.clear();
+                return false;
+            }
+        }
+        m_Strings = reinterpret_cast<const char*>(m_File.Data() + header.m_StringsOffset);
+        m_Valid = true;
+        return true;
+    }
+
+    const AssetPak::Entry* AssetPak::Find(const std::string& path) const
+    {
+        if (!m_Valid)
+        {
+            return nullptr;
+        }
+
+        std::string normalizedPath = NormalizePath(path);
+        uint64 hash = HashPath(normalizedPath);
+        auto iterator = std::lower_bound(m_Entries.begin(), m_Entries.end(), hash,
+            [](const Entry& entry, uint64 value) { return entry.m_PathHash < value; });
+
+        // entries with colliding hashes are adjacent
+        for (; (iterator != m_Entries.end()) && (iterator->m_PathHash == hash); ++iterator)
+        {
+            if ((iterator->m_PathLength == normalizedPath.size()) &&
+                !memcmp(m_Strings + iterator->m_PathOffset, normalizedPath.data(), normalizedPath.size()))
+            {
+                return &(*iterator);
+            }
+        }
+        return nullptr;
+    }
+
+    const uchar* AssetPak::GetMappedData(const std::string& path, size_t& size) const
+    {
+        auto entry = Find(path);
+        if (!entry || (entry->m_Flags & LZ4_COMPRESSED))
+        {
+            return nullptr;
+        }
+        size = entry->m_Size;
+        return m_File.Data() + entry->m_Offset;
+    }
+
+    bool AssetPak::Read(const std::string& path, std::vector<uchar>& data) const
+    {
+        auto entry = Find(path);
+        if (!entry)
+        {
+            return false;
+        }
+
+        const uchar* storedData = m_File.Data() + entry->m_Offset;
+        data.resize(entry->m_Size);
+        if (entry->m_Flags & LZ4_COMPRESSED)
+        {
+            if (!LZ4::Decompress(storedData, entry->m_StoredSize, data.data(), data.size()))
+            {
+                LOG_CORE_ERROR("AssetPak::Read: corrupt entry {0} in {1}", path, m_Filepath);
+                data.clear();
+                return false;
+            }
+        }
+        else if (entry->m_Size)
+        {
+            memcpy(data.data(), storedData, entry->m_Size);
+        }
+        return true;
+    }
+
+    void AssetPakWriter::Add(const std::string& path, std::vector<uchar>&& data, bool compress)
+    {
+        m_Entries.push_back({AssetPak::NormalizePath(path), std::move(data), compress});
+    }
+
+    bool AssetPakWriter::Contains(const std::string& path) const
+    {
+        std::string normalizedPath = AssetPak::NormalizePath(path);
+        for (auto& entry : m_Entries)
+        {
+            if (entry.m_Path == normalizedPath)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool AssetPakWriter::Write(const std::string& filepath)
+    {
+        std::sort(m_Entries.begin(), m_Entries.end(), [](const PendingEntry& a, const PendingEntry& b)
+            { return AssetPak::HashPath(a.m_Path) < AssetPak::HashPath(b.m_Path); });
+
+        std::string strings;
+        std::vector<AssetPak::Entry> toc(m_Entries.size());
+        m_Size = 0;
+        m_StoredSize = 0;
+
+        // write to a temporary file first so that a crash never leaves a partial package behind
+        std::string tmpFilepath = filepath + ".tmp";
+        std::ofstream outputFile(tmpFilepath, std::ios::binary | std::ios::trunc);
+        if (!outputFile.is_open())
+        {
+            LOG_CORE_WARN("AssetPakWriter::Write: could not open {0}", tmpFilepath);
+            return false;
+        }
+
+        auto padToPage = [&outputFile](uint64 offset)
+        {
+            uint64 alignedOffset = (offset + AssetPak::PAGE_SIZE - 1) & ~(AssetPak::PAGE_SIZE - 1);
+            std::vector<char> padding(alignedOffset - offset, 0);
+            outputFile.write(padding.data(), padding.size());
+            return alignedOffset;
+        };
+
+        // the header is completed last, entries start on the first page boundary
+        AssetPak::Header header;
+        memset(&header, 0, sizeof(AssetPak::Header));
+        outputFile.write(reinterpret_cast<const char*>(&header), sizeof(AssetPak::Header));
+        uint64 offset = padToPage(sizeof(AssetPak::Header));
+
+        std::vector<uchar> compressed;
+        for (size_t index = 0; index < m_Entries.size(); index++)
+        {
+            auto& pending = m_Entries[index];
+            auto& entry = toc[index];
+            memset(&entry, 0, sizeof(AssetPak::Entry));
+
+            entry.m_PathHash    = AssetPak::HashPath(pending.m_Path);
+            entry.m_ContentHash = HashBuffer(pending.m_Data.data(), pending.m_Data.size());
+            entry.m_Size        = pending.m_Data.size();
+            entry.m_PathOffset  = static_cast<uint>(strings.size());
+            entry.m_PathLength  = static_cast<uint>(pending.m_Path.size());
+            strings += pending.m_Path;
+
+            const uchar* storedData = pending.m_Data.data();
+            entry.m_StoredSize = pending.m_Data.size();
+            if (pending.m_Compress && !pending.m_Data.empty())
+            {
+                compressed.resize(LZ4::CompressBound(pending.m_Data.size()));
+                size_t compressedSize = LZ4::Compress(pending.m_Data.data(), pending.m_Data.size(), compressed.data(), compressed.size());
+                if (compressedSize && (compressedSize <= pending.m_Data.size() - pending.m_Data.size() / 8))
+                {
+                    storedData = compressed.data();
+                    entry.m_StoredSize = compressedSize;
+                    entry.m_Flags |= AssetPak::LZ4_COMPRESSED;
+                }
+            }
+
+            entry.m_Offset = offset;
+            outputFile.write(reinterpret_cast<const char*>(storedData), entry.m_StoredSize);
+            offset = padToPage(offset + entry.m_StoredSize);
+
+            m_Size += entry.m_Size;
+            m_StoredSize += entry.m_StoredSize;
+        }
+
+        header.m_Magic         = AssetPak::MAGIC;
+        header.m_Version       = AssetPak::VERSION;
+        header.m_EntryCount    = static_cast<uint>(toc.size());
+        header.m_TocOffset     = offset;
+        header.m_StringsOffset = offset + toc.size() * sizeof(AssetPak::Entry);
+        header.m_StringsSize   = strings.size();
+
+        outputFile.write(reinterpret_cast<const char*>(toc.data()), toc.size() * sizeof(AssetPak::Entry));
+        outputFile.write(strings.data(), strings.size());
+        outputFile.seekp(0);
+        outputFile.write(reinterpret_cast<const char*>(&header), sizeof(AssetPak::Header));
+        outputFile.close();
+        if (!outputFile.good())
+        {
+            LOG_CORE_WARN("AssetPakWriter::Write: could not write {0}", tmpFilepath);
+            return false;
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(tmpFilepath, filepath, errorCode);
+        if (errorCode)
+        {
+            LOG_CORE_WARN("AssetPakWriter::Write: could not rename {0} ({1})", tmpFilepath, errorCode.message());
+            std::filesystem::remove(tmpFilepath, errorCode);
+            return false;
+        }
+        return true;
+    }
+}
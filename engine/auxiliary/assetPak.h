@@ -0,0 +1,138 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "engine.h"
+#include "auxiliary/mappedFile.h"
+
+namespace GfxRenderEngine
+{
+
+    // read-only asset package: a table of contents sorted by path hash and
+    // page-aligned entries, stored raw or LZ4-compressed; the whole package is
+    // memory-mapped, raw entries are used in place (see AssetSystem::Load())
+    class AssetPak
+    {
+
+    public:
+
+        static constexpr uint MAGIC = 0x314b4150; // "PAK1"
+        static constexpr uint VERSION = 1;
+        static constexpr uint64 PAGE_SIZE = 4096;
+
+        enum EntryFlags : uint
+        {
+            NONE = 0,
+            LZ4_COMPRESSED = 1
+        };
+
+        struct Header
+        {
+            uint m_Magic;
+            uint m_Version;
+            uint m_EntryCount;
+            uint m_Reserved;
+            uint64 m_TocOffset;
+            uint64 m_StringsOffset;
+            uint64 m_StringsSize;
+        };
+
+        struct Entry
+        {
+            uint64 m_PathHash;
+            uint64 m_ContentHash; // HashBuffer() of the uncompressed data
+            uint64 m_Offset;
+            uint64 m_StoredSize;
+            uint64 m_Size;
+            uint m_PathOffset;
+            uint m_PathLength;
+            uint m_Flags;
+            uint m_Reserved;
+        };
+
+    public:
+
+        AssetPak() {}
+        ~AssetPak() {}
+
+        AssetPak(const AssetPak&) = delete;
+        AssetPak& operator=(const AssetPak&) = delete;
+
+        bool Open(const std::string& filepath);
+        bool IsValid() const { return m_File.IsValid() && m_Valid; }
+        const std::string& GetFilepath() const { return m_Filepath; }
+        size_t Entries() const { return m_Entries.size(); }
+
+        bool Contains(const std::string& path) const { return Find(path) != nullptr; }
+        const Entry* Find(const std::string& path) const;
+
+        // raw entries are returned in place, nullptr for compressed or missing entries
+        const uchar* GetMappedData(const std::string& path, size_t& size) const;
+        bool Read(const std::string& path, std::vector<uchar>& data) const;
+
+        static uint64 HashPath(const std::string& path);
+        // forward slashes, no "." or ".." components
+        static std::string NormalizePath(const std::string& path);
+
+    private:
+
+        std::string m_Filepath;
+        MappedFile m_File;
+        bool m_Valid{false};
+        std::vector<Entry> m_Entries;
+        const char* m_Strings{nullptr};
+
+    };
+
+    class AssetPakWriter
+    {
+
+    public:
+
+        // compression is kept only if it saves at least 1/8 of the size
+        void Add(const std::string& path, std::vector<uchar>&& data, bool compress = true);
+        bool Contains(const std::string& path) const;
+        bool Write(const std::string& filepath);
+
+        size_t Entries() const { return m_Entries.size(); }
+        uint64 GetSize() const { return m_Size; }
+        uint64 GetStoredSize() const { return m_StoredSize; }
+
+    private:
+
+        struct PendingEntry
+        {
+            std::string m_Path;
+            std::vector<uchar> m_Data;
+            bool m_Compress;
+        };
+
+        std::vector<PendingEntry> m_Entries;
+        uint64 m_Size{0};
+        uint64 m_StoredSize{0};
+
+    };
+}
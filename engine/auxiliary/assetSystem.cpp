@@ -0,0 +1,167 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+#include "auxiliary/assetSystem.h"
+#include "auxiliary/mappedFile.h"
+#include "auxiliary/hash.h"
+#include "auxiliary/file.h"
+
+namespace GfxRenderEngine
+{
+
+    std::vector<std::unique_ptr<AssetPak>> AssetSystem::m_Paks;
+
+    bool AssetSystem::Mount(const std::string& filepath)
+    {
+        auto pak = std::make_unique<AssetPak>();
+        if (!pak->Open(filepath))
+        {
+            return false;
+        }
+        LOG_CORE_INFO("AssetSystem: mounted {0} ({1} entries)", filepath, pak->Entries());
+        m_Paks.push_back(std::move(pak));
+        return true;
+    }
+
+    void AssetSystem::MountAll(const std::string& directory)
+    {
+        if (!EngineCore::IsDirectory(directory))
+        {
+            return;
+        }
+
+        std::vector<std::string> filepaths;
+        for (const auto& entry : std::filesystem::directory_iterator(directory))
+        {
+            if (entry.is_regular_file() && (entry.path().extension() == ".pak"))
+            {
+                filepaths.push_back(entry.path().string());
+            }
+        }
+
+        // deterministic lookup order
+        std::sort(filepaths.begin(), filepaths.end());
+        for (auto& filepath : filepaths)
+        {
+            Mount(filepath);
+        }
+    }
+
+    void AssetSystem::UnmountAll()
+    {
+        m_Paks.clear();
+    }
+
+    const AssetPak* AssetSystem::FindPak(const std::string& filepath)
+    {
+        for (auto& pak : m_Paks)
+        {
+            if (pak->Contains(filepath))
+            {
+                return pak.get();
+            }
+        }
+        return nullptr;
+    }
+
+    bool AssetSystem::Exists(const std::string& filepath)
+    {
+        return FindPak(filepath) || EngineCore::FileExists(filepath);
+    }
+
+    bool AssetSystem::Read(const std::string& filepath, std::vector<uchar>& data)
+    {
+        if (auto pak = FindPak(filepath))
+        {
+            return pak->Read(filepath, data);
+        }
+
+        std::ifstream inputFile(filepath, std::ios::binary | std::ios::ate);
+        if (!inputFile.is_open())
+        {
+            return false;
+        }
+        data.resize(static_cast<size_t>(inputFile.tellg()));
+        inputFile.seekg(0);
+        inputFile.read(reinterpret_cast<char*>(data.data()), data.size());
+        return inputFile.good();
+    }
+
+    bool AssetSystem::Load(const std::string& filepath, AssetData& data)
+    {
+        if (auto pak = FindPak(filepath))
+        {
+            if (auto mappedData = pak->GetMappedData(filepath, data.m_Size))
+            {
+                data.m_Data = mappedData;
+                return true;
+            }
+        }
+        else if (data.m_File.Open(filepath))
+        {
+            data.m_Data = data.m_File.Data();
+            data.m_Size = data.m_File.Size();
+            return true;
+        }
+
+        // compressed entries and files that cannot be mapped (e.g. empty files)
+        if (!Read(filepath, data.m_Storage))
+        {
+            return false;
+        }
+        data.m_Data = data.m_Storage.data();
+        data.m_Size = data.m_Storage.size();
+        return true;
+    }
+
+    AssetStream::Buffer::Buffer(const AssetData& data)
+    {
+        // read-only, the get area is never written through
+        char* begin = reinterpret_cast<char*>(const_cast<uchar*>(data.Data()));
+        setg(begin, begin, begin + data.Size());
+    }
+
+    AssetStream::AssetStream(const AssetData& data)
+        : std::istream(nullptr), m_Buffer(data)
+    {
+        rdbuf(&m_Buffer);
+    }
+
+    uint64 AssetSystem::Hash(const std::string& filepath)
+    {
+        if (auto pak = FindPak(filepath))
+        {
+            return pak->Find(filepath)->m_ContentHash;
+        }
+
+        MappedFile file(filepath);
+        if (!file.IsValid())
+        {
+            return 0;
+        }
+        return HashBuffer(file.Data(), file.Size());
+    }
+}
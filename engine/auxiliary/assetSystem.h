@@ -0,0 +1,125 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <istream>
+#include <streambuf>
+
+#include "engine.h"
+#include "auxiliary/assetPak.h"
+#include "auxiliary/mappedFile.h"
+
+namespace GfxRenderEngine
+{
+
+    // contents of an asset without a copy where possible: raw package entries point into the
+    // mapped package, loose files are memory-mapped, compressed entries are decompressed into
+    // the object; valid as long as the object lives and the packages stay mounted
+    class AssetData
+    {
+
+    public:
+
+        AssetData() {}
+
+        AssetData(const AssetData&) = delete;
+        AssetData& operator=(const AssetData&) = delete;
+
+        const uchar* Data() const { return m_Data; }
+        size_t Size() const { return m_Size; }
+
+    private:
+
+        const uchar* m_Data{nullptr};
+        size_t m_Size{0};
+        MappedFile m_File;
+        std::vector<uchar> m_Storage;
+
+        friend class AssetSystem;
+
+    };
+
+    // std::istream over AssetData, for parsers that read streams (YAML, OBJ, MTL)
+    class AssetStream : public std::istream
+    {
+
+    public:
+
+        AssetStream(const AssetData& data);
+
+    private:
+
+        class Buffer : public std::streambuf
+        {
+
+        public:
+
+            Buffer(const AssetData& data);
+
+        };
+
+    private:
+
+        Buffer m_Buffer;
+
+    };
+
+    // file access for assets: mounted packages first, loose files as fallback;
+    // packages are mounted at startup, before any asset is loaded, so that
+    // lookups from worker threads need no locking
+    class AssetSystem
+    {
+
+    public:
+
+        static constexpr const char* PAK_DIRECTORY = "bin/paks/";
+
+    public:
+
+        static bool Mount(const std::string& filepath);
+        // mounts every *.pak file of a directory
+        static void MountAll(const std::string& directory = PAK_DIRECTORY);
+        static void UnmountAll();
+
+        static bool Exists(const std::string& filepath);
+        // preferred, see AssetData
+        static bool Load(const std::string& filepath, AssetData& data);
+        // copies, for consumers that need to own the data
+        static bool Read(const std::string& filepath, std::vector<uchar>& data);
+
+        // content hash as computed by HashBuffer(), 0 if the file does not exist
+        static uint64 Hash(const std::string& filepath);
+
+    private:
+
+        static const AssetPak* FindPak(const std::string& filepath);
+
+    private:
+
+        static std::vector<std::unique_ptr<AssetPak>> m_Paks;
+
+    };
+}
@@ -20,6 +20,10 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include <atomic>
+#include <thread>
+#include <sstream>
+
 #include "auxiliary/file.h"
 
 namespace GfxRenderEngine
@@ -156,5 +160,14 @@ namespace GfxRenderEngine
 
             return filename;
         }
+
+        std::string GetTemporaryFilepath(const std::string& filepath)
+        {
+            // the thread id separates threads, the counter separates calls of the same thread
+            static std::atomic<unsigned long long> counter{0};
+            std::ostringstream temporaryFilepath;
+            temporaryFilepath << filepath << "." << std::this_thread::get_id() << "." << counter.fetch_add(1) << ".tmp";
+            return temporaryFilepath.str();
+        }
     }
 }
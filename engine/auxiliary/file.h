@@ -46,6 +46,10 @@ namespace GfxRenderEngine
         bool CopyFile(const std::string& src, const std::string& dest);
         std::ifstream::pos_type FileSize(const std::string& filename);
         std::string& AddSlash(std::string& filename);
+
+        // unique name next to filepath for writing a file that is then renamed into place,
+        // safe for concurrent writers of the same file
+        std::string GetTemporaryFilepath(const std::string& filepath);
     }
 }
 
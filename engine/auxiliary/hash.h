@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <functional>
 
 #include "engine.h"
@@ -34,4 +35,29 @@ namespace GfxRenderEngine
         seed ^= std::hash<Type>{}(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
         (HashCombine(seed, rest), ...);
     };
+
+    // 64-bit content hash for cache keys (FNV-1a over 8-byte words, splitmix finalizer)
+    inline uint64 HashBuffer(const void* data, size_t size, uint64 seed = 0xcbf29ce484222325ULL)
+    {
+        constexpr uint64 prime = 0x100000001b3ULL;
+        const uchar* bytes = static_cast<const uchar*>(data);
+        uint64 hash = seed ^ size;
+
+        size_t words = size / sizeof(uint64);
+        for (size_t i = 0; i < words; ++i)
+        {
+            uint64 word;
+            memcpy(&word, bytes + i * sizeof(uint64), sizeof(uint64));
+            hash = (hash ^ word) * prime;
+        }
+        for (size_t i = words * sizeof(uint64); i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * prime;
+        }
+
+        hash ^= hash >> 30; hash *= 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 27; hash *= 0x94d049bb133111ebULL;
+        hash ^= hash >> 31;
+        return hash;
+    }
 }
@@ -22,7 +22,8 @@
 
 #if defined(PROFILING)
 
-    #include <sstream>
+    #include <cstring>
+    #include <iomanip>
 
     #include "core.h"
     #include "engine.h"
@@ -33,23 +34,40 @@
     {
         namespace Instrumentation
         {
+            thread_local SessionManager::ThreadBufferOwner SessionManager::m_ThreadBuffer;
+
             Timer::Timer(const char* name)
                 : m_Name(name)
             {
-                m_Start = std::chrono::high_resolution_clock::now();
+                m_Start = Clock::now();
             }
 
             Timer::~Timer()
             {
-                m_End = std::chrono::high_resolution_clock::now();
+                SessionManager::Get().Scope(m_Name, m_Start, Clock::now());
+            }
+
+            ThreadBuffer::ThreadBuffer(uint threadIndex)
+                : m_Head{0}, m_Tail{0}, m_DroppedEvents{0}, m_ThreadIndex{threadIndex}
+            {}
 
-                auto start = std::chrono::duration<double, std::micro>{ m_Start.time_since_epoch() };
-                auto elapsedMicroSeconds = std::chrono::time_point_cast<std::chrono::microseconds>(m_End).time_since_epoch() - std::chrono::time_point_cast<std::chrono::microseconds>(m_Start).time_since_epoch();
-                SessionManager::Get().CreateEntry({ m_Name, start, elapsedMicroSeconds, std::this_thread::get_id() });
+            bool ThreadBuffer::Push(const Event& event)
+            {
+                uint head = m_Head.load(std::memory_order_relaxed);
+                if (head - m_Tail.load(std::memory_order_acquire) == CAPACITY)
+                {
+                    // never block the recording thread
+                    m_DroppedEvents.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                m_Events[head & (CAPACITY - 1)] = event;
+                m_Head.store(head + 1, std::memory_order_release);
+                return true;
             }
 
             SessionManager::SessionManager()
-                : m_CurrentSession(nullptr)
+                : m_SessionOpen(false), m_Format(Format::Json), m_Recording(false),
+                  m_StartTime(0), m_FrameNumber(0), m_StopWriter(false)
             {}
 
             SessionManager::~SessionManager()
@@ -60,11 +78,10 @@
             void SessionManager::Begin(const std::string& name, const std::string& filename)
             {
                 std::lock_guard lock(m_Mutex);
-                if (m_CurrentSession)
+                if (m_SessionOpen)
                 {
                     EndInternal();
                 }
-                m_StartTime =  std::chrono::steady_clock::now();
 
                 //this function must be called
                 //after the constructor of engine 
@@ -84,12 +101,25 @@
                 {
                     filepath = filename;
                 }
-                m_OutputStream.open(filepath);
+
+                bool binary = (filepath.size() >= 4) && (filepath.compare(filepath.size() - 4, 4, ".bin") == 0);
+                m_Format = binary ? Format::Binary : Format::Json;
+                m_OutputStream.open(filepath, binary ? std::ios::out | std::ios::binary : std::ios::out);
 
                 if (m_OutputStream.is_open())
                 {
-                    m_CurrentSession = new Session({name});
-                    StartJsonFile();
+                    // events left over from a previous session
+                    DrainBuffers(true);
+
+                    m_SessionOpen = true;
+                    m_NameTable.clear();
+                    m_FrameNumber = 0;
+                    StartFile();
+
+                    m_StartTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+                    m_StopWriter = false;
+                    m_Writer = std::thread(&SessionManager::WriterThread, this);
+                    m_Recording = true;
                 }
                 else
                 {
@@ -104,53 +134,288 @@
                 EndInternal();
             }
 
-            void SessionManager::CreateEntry(const Result& result)
+            void SessionManager::Scope(const char* name, Clock::time_point start, Clock::time_point end)
             {
-                if ((std::chrono::steady_clock::now() - m_StartTime) > 5min)
+                if (!m_Recording.load(std::memory_order_relaxed))
                 {
                     return;
                 }
-                std::stringstream outputFile;
+                int64 startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+                int64 duration  = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                Record({name, startTime - m_StartTime.load(std::memory_order_relaxed), duration, EventType::Scope});
+            }
 
-                outputFile << std::setprecision(3) << std::fixed;
-                outputFile << ",\n    {";
-                outputFile << "\"cat\":\"function\",";
-                outputFile << "\"dur\":" << result.m_ElapsedTime.count() << ',';
-                outputFile << "\"name\":\"" << result.m_Name << "\",";
-                outputFile << "\"ph\":\"X\",";
-                outputFile << "\"pid\":0,";
-                outputFile << "\"tid\":" << result.m_ThreadID << ",";
-                outputFile << "\"ts\":" << result.m_Start.count();
-                outputFile << "}";
+            void SessionManager::Counter(const char* name, int64 value)
+            {
+                if (!m_Recording.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+                int64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+                Record({name, now - m_StartTime.load(std::memory_order_relaxed), value, EventType::Counter});
+            }
 
-                std::lock_guard lock(m_Mutex);
-                if (m_CurrentSession)
+            void SessionManager::FrameMarker()
+            {
+                if (!m_Recording.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+                int64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+                int64 frame = m_FrameNumber.fetch_add(1, std::memory_order_relaxed);
+                Record({"frame", now - m_StartTime.load(std::memory_order_relaxed), frame, EventType::FrameMarker});
+            }
+
+            void SessionManager::GpuScope(const char* name, Clock::time_point start, int64 duration)
+            {
+                if (!m_Recording.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+                int64 startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+                Record({name, startTime - m_StartTime.load(std::memory_order_relaxed), duration, EventType::GpuScope});
+            }
+
+            void SessionManager::Record(const Event& event)
+            {
+                GetThreadBuffer()->Push(event);
+            }
+
+            ThreadBuffer* SessionManager::GetThreadBuffer()
+            {
+                if (!m_ThreadBuffer.m_Buffer)
+                {
+                    // once per thread
+                    std::lock_guard lock(m_BuffersMutex);
+                    if (!m_FreeThreadBuffers.empty())
+                    {
+                        m_ThreadBuffer.m_Buffer = m_FreeThreadBuffers.back();
+                        m_FreeThreadBuffers.pop_back();
+                    }
+                    else
+                    {
+                        uint threadIndex = static_cast<uint>(m_ThreadBuffers.size());
+                        m_ThreadBuffers.push_back(std::make_unique<ThreadBuffer>(threadIndex));
+                        m_ThreadBuffer.m_Buffer = m_ThreadBuffers.back().get();
+                    }
+                }
+                return m_ThreadBuffer.m_Buffer;
+            }
+
+            // Events the exiting thread left in the buffer stay queued in front of those of the next
+            // owner and are written by the writer thread as usual, so recycling loses nothing.
+            // The buffer keeps its thread index, threads that did not overlap share a track.
+            void SessionManager::ReleaseThreadBuffer(ThreadBuffer* threadBuffer)
+            {
+                std::lock_guard lock(m_BuffersMutex);
+                m_FreeThreadBuffers.push_back(threadBuffer);
+            }
+
+            // thread storage is destroyed before static storage, the session manager is still alive
+            SessionManager::ThreadBufferOwner::~ThreadBufferOwner()
+            {
+                if (m_Buffer)
+                {
+                    SessionManager::Get().ReleaseThreadBuffer(m_Buffer);
+                }
+            }
+
+            void SessionManager::WriterThread()
+            {
+                std::unique_lock lock(m_WriterMutex);
+                while (!m_StopWriter)
+                {
+                    m_WriterCondition.wait_for(lock, WRITE_INTERVAL, [this]() { return m_StopWriter; });
+                    lock.unlock();
+                    DrainBuffers();
+                    lock.lock();
+                }
+            }
+
+            // only one thread drains at a time: the writer thread while a session is open, Begin()/End() otherwise
+            void SessionManager::DrainBuffers(bool discard)
+            {
+                std::vector<ThreadBuffer*> threadBuffers;
+                {
+                    std::lock_guard lock(m_BuffersMutex);
+                    for (auto& threadBuffer : m_ThreadBuffers)
+                    {
+                        threadBuffers.push_back(threadBuffer.get());
+                    }
+                }
+
+                for (auto threadBuffer : threadBuffers)
+                {
+                    uint threadIndex = threadBuffer->GetThreadIndex();
+                    threadBuffer->Drain([&](const Event& event)
+                    {
+                        if (!discard)
+                        {
+                            WriteEvent(threadIndex, event);
+                        }
+                    });
+                }
+
+                if (!discard)
                 {
-                    m_OutputStream << outputFile.str();
                     m_OutputStream.flush();
                 }
             }
 
-            void SessionManager::StartJsonFile()
+            void SessionManager::WriteEvent(uint threadIndex, const Event& event)
+            {
+                if (m_Format == Format::Json)
+                {
+                    WriteJsonEvent(threadIndex, event);
+                }
+                else
+                {
+                    WriteBinaryEvent(threadIndex, event);
+                }
+            }
+
+            void SessionManager::WriteJsonEvent(uint threadIndex, const Event& event)
+            {
+                // chrome tracing expects microseconds
+                double timestamp = static_cast<double>(event.m_Timestamp) / 1000.0;
+
+                m_OutputStream << ",\n    {";
+                m_OutputStream << "\"name\":\"" << event.m_Name << "\",";
+                switch (event.m_Type)
+                {
+                    case EventType::Scope:
+                    {
+                        m_OutputStream << "\"cat\":\"function\",";
+                        m_OutputStream << "\"ph\":\"X\",";
+                        m_OutputStream << "\"dur\":" << static_cast<double>(event.m_Value) / 1000.0 << ',';
+                        break;
+                    }
+                    case EventType::Counter:
+                    {
+                        m_OutputStream << "\"ph\":\"C\",";
+                        m_OutputStream << "\"args\":{\"value\":" << event.m_Value << "},";
+                        break;
+                    }
+                    case EventType::FrameMarker:
+                    {
+                        m_OutputStream << "\"ph\":\"i\",\"s\":\"g\",";
+                        m_OutputStream << "\"args\":{\"frame\":" << event.m_Value << "},";
+                        break;
+                    }
+                    case EventType::GpuScope:
+                    {
+                        m_OutputStream << "\"cat\":\"gpu\",";
+                        m_OutputStream << "\"ph\":\"X\",";
+                        m_OutputStream << "\"dur\":" << static_cast<double>(event.m_Value) / 1000.0 << ',';
+                        break;
+                    }
+                }
+                if (event.m_Type == EventType::GpuScope)
+                {
+                    m_OutputStream << "\"pid\":1,\"tid\":0,";
+                }
+                else
+                {
+                    m_OutputStream << "\"pid\":0,";
+                    m_OutputStream << "\"tid\":" << threadIndex << ",";
+                }
+                m_OutputStream << "\"ts\":" << timestamp;
+                m_OutputStream << "}";
+            }
+
+            // binary format (little endian, packed):
+            //     header: "GFXTRACE", uint version
+            //     name:   uchar 0xff, uint name id, uint length, chars
+            //     event:  uchar type, uint thread index, uint name id, int64 timestamp (ns), int64 value
+            void SessionManager::WriteBinaryEvent(uint threadIndex, const Event& event)
+            {
+                auto write = [this](const auto& value)
+                {
+                    m_OutputStream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+                };
+
+                uint nameID;
+                auto iterator = m_NameTable.find(event.m_Name);
+                if (iterator == m_NameTable.end())
+                {
+                    nameID = static_cast<uint>(m_NameTable.size());
+                    m_NameTable[event.m_Name] = nameID;
+
+                    uint length = static_cast<uint>(strlen(event.m_Name));
+                    write(static_cast<uchar>(0xff));
+                    write(nameID);
+                    write(length);
+                    m_OutputStream.write(event.m_Name, length);
+                }
+                else
+                {
+                    nameID = iterator->second;
+                }
+
+                write(static_cast<uchar>(event.m_Type));
+                write(threadIndex);
+                write(nameID);
+                write(event.m_Timestamp);
+                write(event.m_Value);
+            }
+
+            void SessionManager::StartFile()
             {
-                m_OutputStream << "{\"otherData\": {},\"traceEvents\":[{}";
+                if (m_Format == Format::Json)
+                {
+                    m_OutputStream << std::setprecision(3) << std::fixed;
+                    m_OutputStream << "{\"otherData\": {},\"traceEvents\":[{}";
+                    m_OutputStream << ",\n    {\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"CPU\"}}";
+                    m_OutputStream << ",\n    {\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"GPU\"}}";
+                }
+                else
+                {
+                    uint version = 1;
+                    m_OutputStream.write("GFXTRACE", 8);
+                    m_OutputStream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+                }
                 m_OutputStream.flush();
             }
 
-            void SessionManager::EndJsonFile()
+            void SessionManager::EndFile()
             {
-                m_OutputStream << "]}";
+                if (m_Format == Format::Json)
+                {
+                    m_OutputStream << "]}";
+                }
                 m_OutputStream.flush();
             }
 
             void SessionManager::EndInternal()
             {
-                if (m_CurrentSession)
+                if (m_SessionOpen)
                 {
-                    EndJsonFile();
+                    m_Recording = false;
+                    {
+                        std::lock_guard lock(m_WriterMutex);
+                        m_StopWriter = true;
+                    }
+                    m_WriterCondition.notify_one();
+                    m_Writer.join();
+                    DrainBuffers();
+
+                    uint64 droppedEvents = 0;
+                    {
+                        std::lock_guard lock(m_BuffersMutex);
+                        for (auto& threadBuffer : m_ThreadBuffers)
+                        {
+                            droppedEvents += threadBuffer->GetDroppedEvents();
+                        }
+                    }
+                    if (droppedEvents)
+                    {
+                        // plain cout because logger might be gone already
+                        std::cout << "SessionManager: " << droppedEvents << " profiling events were dropped" << std::endl;
+                    }
+
+                    EndFile();
                     m_OutputStream.close();
-                    delete m_CurrentSession;
-                    m_CurrentSession = nullptr;
+                    m_SessionOpen = false;
                 }
             }
         }
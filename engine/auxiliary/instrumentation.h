@@ -27,11 +27,19 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "engine.h"
 
 namespace GfxRenderEngine
 {
@@ -44,30 +52,81 @@ namespace GfxRenderEngine
             #define FUNC_SIGNATURE __PRETTY_FUNCTION__
         #endif
 
+        // a filename ending with ".bin" selects the binary trace format, otherwise chrome tracing json is written
         #define PROFILE_BEGIN_SESSION(name, filepath) ::GfxRenderEngine::Instrumentation::SessionManager::Get().Begin(name, filepath)
         #define PROFILE_END_SESSION() ::GfxRenderEngine::Instrumentation::SessionManager::Get().End()
 
+        // names are stored as pointers and must stay valid until the session ends (string literals)
         #define PROFILE_SCOPE_LINE2(name, line) ::GfxRenderEngine::Instrumentation::Timer timer##line(name)
         #define PROFILE_SCOPE_LINE(name, line) PROFILE_SCOPE_LINE2(name, line)
         #define PROFILE_SCOPE(name) PROFILE_SCOPE_LINE(name, __LINE__)
         #define PROFILE_FUNCTION() PROFILE_SCOPE(FUNC_SIGNATURE)
+        #define PROFILE_COUNTER(name, value) ::GfxRenderEngine::Instrumentation::SessionManager::Get().Counter(name, value)
+        #define PROFILE_FRAME_MARKER() ::GfxRenderEngine::Instrumentation::SessionManager::Get().FrameMarker()
+        // GPU work measured elsewhere, shown on a separate "GPU" track (start on the CPU clock, duration in nanoseconds)
+        #define PROFILE_GPU_SCOPE(name, start, duration) ::GfxRenderEngine::Instrumentation::SessionManager::Get().GpuScope(name, start, duration)
 
         namespace Instrumentation
         {
 
-            struct Result
+            using Clock = std::chrono::steady_clock;
+
+            enum class EventType : uchar
             {
-                std::string m_Name;
-                std::chrono::duration<double, std::micro> m_Start;
-                std::chrono::microseconds m_ElapsedTime;
-                std::thread::id m_ThreadID;
+                Scope,
+                Counter,
+                FrameMarker,
+                GpuScope
             };
 
-            struct Session
+            struct Event
             {
-                std::string m_Name;
+                const char* m_Name;
+                int64 m_Timestamp; // nanoseconds since session start
+                int64 m_Value;     // duration in nanoseconds, counter value, or frame number
+                EventType m_Type;
             };
 
+            // lock-free ring buffer: the owning thread pushes, the writer thread drains
+            class ThreadBuffer
+            {
+
+            public:
+
+                static constexpr uint CAPACITY = 8192; // power of two
+
+            public:
+
+                ThreadBuffer(uint threadIndex);
+
+                bool Push(const Event& event);
+                template<typename T> void Drain(T&& consume);
+
+                uint GetThreadIndex() const { return m_ThreadIndex; }
+                uint64 GetDroppedEvents() const { return m_DroppedEvents.load(std::memory_order_relaxed); }
+
+            private:
+
+                std::array<Event, CAPACITY> m_Events;
+                alignas(64) std::atomic<uint> m_Head; // written by the owning thread
+                alignas(64) std::atomic<uint> m_Tail; // written by the writer thread
+                std::atomic<uint64> m_DroppedEvents;
+                uint m_ThreadIndex;
+
+            };
+
+            template<typename T> void ThreadBuffer::Drain(T&& consume)
+            {
+                uint tail = m_Tail.load(std::memory_order_relaxed);
+                uint head = m_Head.load(std::memory_order_acquire);
+                while (tail != head)
+                {
+                    consume(m_Events[tail & (CAPACITY - 1)]);
+                    tail++;
+                }
+                m_Tail.store(tail, std::memory_order_release);
+            }
+
             class SessionManager
             {
             public:
@@ -77,27 +136,72 @@ namespace GfxRenderEngine
                 void Begin(const std::string& name, const std::string& filename = "results.json");
                 void End();
 
-                void CreateEntry(const Result& result);
+                void Scope(const char* name, Clock::time_point start, Clock::time_point end);
+                void Counter(const char* name, int64 value);
+                void FrameMarker();
+                void GpuScope(const char* name, Clock::time_point start, int64 duration);
 
                 static SessionManager& Get()
                 {
                     static SessionManager instance;
                     return instance;
                 }
+            private:
+
+                enum class Format
+                {
+                    Json,
+                    Binary
+                };
+
+                // interval in which the writer thread drains the thread buffers
+                static constexpr std::chrono::milliseconds WRITE_INTERVAL = 10ms;
+
             private:
                 SessionManager();
                 ~SessionManager();
 
-                void StartJsonFile();
-                void EndJsonFile();
+                void Record(const Event& event);
+                ThreadBuffer* GetThreadBuffer();
+                void ReleaseThreadBuffer(ThreadBuffer* threadBuffer);
+                void WriterThread();
+                void DrainBuffers(bool discard = false);
+                void WriteEvent(uint threadIndex, const Event& event);
+                void WriteJsonEvent(uint threadIndex, const Event& event);
+                void WriteBinaryEvent(uint threadIndex, const Event& event);
+                void StartFile();
+                void EndFile();
                 void EndInternal();
 
             private:
 
-                std::mutex m_Mutex;
-                Session* m_CurrentSession;
+                std::mutex m_Mutex; // Begin() and End()
+                bool m_SessionOpen;
+                Format m_Format;
                 std::ofstream m_OutputStream;
-                std::chrono::time_point<std::chrono::steady_clock> m_StartTime;
+                std::atomic<bool> m_Recording;
+                std::atomic<int64> m_StartTime; // nanoseconds
+                std::atomic<int64> m_FrameNumber;
+
+                // hands the buffer of an exiting thread back to the free list
+                struct ThreadBufferOwner
+                {
+                    ThreadBuffer* m_Buffer = nullptr;
+                    ~ThreadBufferOwner();
+                };
+
+                // one buffer per thread that is recording events, buffers of finished threads are recycled
+                std::mutex m_BuffersMutex;
+                std::vector<std::unique_ptr<ThreadBuffer>> m_ThreadBuffers;
+                std::vector<ThreadBuffer*> m_FreeThreadBuffers;
+                static thread_local ThreadBufferOwner m_ThreadBuffer;
+
+                // writer thread state
+                std::thread m_Writer;
+                std::mutex m_WriterMutex;
+                std::condition_variable m_WriterCondition;
+                bool m_StopWriter;
+                std::unordered_map<const char*, uint> m_NameTable; // binary format: names written so far
             };
 
             class Timer
@@ -111,7 +215,7 @@ namespace GfxRenderEngine
             private:
 
                 const char* m_Name;
-                std::chrono::time_point<std::chrono::high_resolution_clock> m_Start, m_End;
+                Clock::time_point m_Start;
 
             };
         }
@@ -121,5 +225,8 @@ namespace GfxRenderEngine
         #define PROFILE_END_SESSION()
         #define PROFILE_SCOPE(name)
         #define PROFILE_FUNCTION()
+        #define PROFILE_COUNTER(name, value)
+        #define PROFILE_FRAME_MARKER()
+        #define PROFILE_GPU_SCOPE(name, start, duration)
     #endif
 }
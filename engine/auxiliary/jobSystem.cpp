@@ -0,0 +1,244 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <algorithm>
+
+#include "auxiliary/jobSystem.h"
+#include "auxiliary/instrumentation.h"
+
+namespace GfxRenderEngine
+{
+    thread_local uint JobSystem::m_QueueIndex = 0;
+    std::thread::id JobSystem::m_MainThreadID;
+
+    JobSystem::JobSystem(uint numberOfWorkers)
+        : m_Running{true}, m_QueuedJobs{0}
+    {
+        m_MainThreadID = std::this_thread::get_id();
+
+        if (!numberOfWorkers)
+        {
+            uint hardwareThreads = std::thread::hardware_concurrency();
+            numberOfWorkers = std::max(hardwareThreads, 2u) - 1;
+        }
+
+        // queue 0 is shared by all non-worker threads
+        for (uint index = 0; index <= numberOfWorkers; index++)
+        {
+            m_Queues.push_back(std::make_unique<Queue>());
+        }
+
+        for (uint index = 1; index <= numberOfWorkers; index++)
+        {
+            m_Workers.emplace_back([this, index]() { WorkerLoop(index); });
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+            m_Running = false;
+        }
+        m_WakeCondition.notify_all();
+        for (auto& worker : m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    void JobSystem::Run(const char* name, Function function, JobCounter* counter)
+    {
+        if (counter)
+        {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        Push({name, std::move(function), counter});
+    }
+
+    void JobSystem::RunAfter(JobCounter& dependency, const char* name, Function function, JobCounter* counter)
+    {
+        if (counter)
+        {
+            counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+            if (!dependency.IsDone())
+            {
+                dependency.m_Continuations.push_back({name, std::move(function), counter});
+                return;
+            }
+        }
+        Push({name, std::move(function), counter});
+    }
+
+    uint JobSystem::GetThreadIndex()
+    {
+        // other non-worker threads would share index 0 with the main thread
+        ASSERT(m_QueueIndex || (std::this_thread::get_id() == m_MainThreadID));
+        return m_QueueIndex;
+    }
+
+    // Only jobs of the awaited counter are helped with: an unrelated job could be long-running,
+    // wait for something itself, or need per-thread state the waiting thread is still holding.
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            if (!RunPendingJob(&counter))
+            {
+                std::this_thread::yield();
+            }
+        }
+        // wait until the last job has released the counter
+        std::lock_guard<std::mutex> lock(counter.m_Mutex);
+    }
+
+    void JobSystem::ParallelFor(const char* name, uint count, uint batchSize, const RangeFunction& function)
+    {
+        batchSize = std::max(batchSize, 1u);
+        if (count <= batchSize)
+        {
+            PROFILE_SCOPE(name);
+            function(0, count);
+            return;
+        }
+
+        JobCounter counter;
+        for (uint begin = batchSize; begin < count; begin += batchSize)
+        {
+            uint end = std::min(begin + batchSize, count);
+            Run(name, [&function, begin, end]() { function(begin, end); }, &counter);
+        }
+
+        // the calling thread takes the first batch
+        {
+            PROFILE_SCOPE(name);
+            function(0, batchSize);
+        }
+        Wait(counter);
+    }
+
+    void JobSystem::Push(Job&& job)
+    {
+        Queue& queue = *m_Queues[m_QueueIndex];
+        {
+            std::lock_guard<std::mutex> lock(queue.m_Mutex);
+            queue.m_Jobs.push_back(std::move(job));
+        }
+        m_QueuedJobs.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+        }
+        m_WakeCondition.notify_one();
+    }
+
+    bool JobSystem::Pop(uint queueIndex, Job& job, JobCounter* counter)
+    {
+        Queue& queue = *m_Queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.m_Mutex);
+        for (auto iterator = queue.m_Jobs.rbegin(); iterator != queue.m_Jobs.rend(); ++iterator)
+        {
+            if (!counter || (iterator->m_Counter == counter))
+            {
+                job = std::move(*iterator);
+                queue.m_Jobs.erase(std::next(iterator).base());
+                m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool JobSystem::Steal(uint queueIndex, Job& job, JobCounter* counter)
+    {
+        uint numberOfQueues = static_cast<uint>(m_Queues.size());
+        for (uint offset = 1; offset < numberOfQueues; offset++)
+        {
+            Queue& queue = *m_Queues[(queueIndex + offset) % numberOfQueues];
+            std::lock_guard<std::mutex> lock(queue.m_Mutex);
+            for (auto iterator = queue.m_Jobs.begin(); iterator != queue.m_Jobs.end(); ++iterator)
+            {
+                if (!counter || (iterator->m_Counter == counter))
+                {
+                    job = std::move(*iterator);
+                    queue.m_Jobs.erase(iterator);
+                    m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool JobSystem::RunPendingJob(JobCounter* counter)
+    {
+        Job job;
+        if (Pop(m_QueueIndex, job, counter) || Steal(m_QueueIndex, job, counter))
+        {
+            Execute(job);
+            return true;
+        }
+        return false;
+    }
+
+    void JobSystem::Execute(Job& job)
+    {
+        {
+            PROFILE_SCOPE(job.m_Name);
+            job.m_Function();
+        }
+
+        JobCounter* counter = job.m_Counter;
+        if (counter)
+        {
+            // decrement under the lock: Wait() takes the same lock before
+            // it returns, so the counter outlives this block
+            std::vector<JobCounter::Continuation> continuations;
+            {
+                std::lock_guard<std::mutex> lock(counter->m_Mutex);
+                if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    continuations.swap(counter->m_Continuations);
+                }
+            }
+            for (auto& continuation : continuations)
+            {
+                Push({continuation.m_Name, std::move(continuation.m_Function), continuation.m_Counter});
+            }
+        }
+    }
+
+    void JobSystem::WorkerLoop(uint queueIndex)
+    {
+        m_QueueIndex = queueIndex;
+        while (m_Running)
+        {
+            if (!RunPendingJob())
+            {
+                std::unique_lock<std::mutex> lock(m_WakeMutex);
+                m_WakeCondition.wait(lock, [this]() { return !m_Running || (m_QueuedJobs.load(std::memory_order_acquire) > 0); });
+            }
+        }
+    }
+}
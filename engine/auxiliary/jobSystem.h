@@ -0,0 +1,149 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    class JobSystem;
+
+    // counts unfinished jobs; jobs scheduled with RunAfter() start when it reaches zero
+    class JobCounter
+    {
+
+    public:
+
+        JobCounter() : m_Pending{0} {}
+
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+
+        struct Continuation
+        {
+            const char* m_Name;
+            std::function<void()> m_Function;
+            JobCounter* m_Counter;
+        };
+
+    private:
+
+        std::atomic<uint> m_Pending;
+        std::mutex m_Mutex;
+        std::vector<Continuation> m_Continuations;
+
+        friend class JobSystem;
+
+    };
+
+    // work-stealing scheduler: every worker owns a deque, takes its
+    // own jobs from the back and steals from the front of the others;
+    // threads that are not workers (e.g. the main thread) share queue 0
+    class JobSystem
+    {
+
+    public:
+
+        using Function = std::function<void()>;
+        using RangeFunction = std::function<void(uint begin, uint end)>;
+
+    public:
+
+        JobSystem(uint numberOfWorkers = 0 /* 0: one per hardware thread, minus the main thread */);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // names must be string literals: they show up per thread in the profiling trace
+        void Run(const char* name, Function function, JobCounter* counter = nullptr);
+        void RunAfter(JobCounter& dependency, const char* name, Function function, JobCounter* counter = nullptr);
+
+        // executes pending jobs of the same counter while waiting, other jobs are left to the workers
+        void Wait(JobCounter& counter);
+
+        // calls function(begin, end) for batches of at most batchSize elements and waits for all of them
+        void ParallelFor(const char* name, uint count, uint batchSize, const RangeFunction& function);
+
+        uint GetNumberOfWorkers() const { return static_cast<uint>(m_Workers.size()); }
+
+        // threads are numbered from 0 (the main thread) to GetNumberOfWorkers(),
+        // per-thread resources indexed by it must only be used by these threads
+        uint GetNumberOfThreads() const { return static_cast<uint>(m_Queues.size()); }
+        static uint GetThreadIndex();
+
+    private:
+
+        struct Job
+        {
+            const char* m_Name;
+            Function m_Function;
+            JobCounter* m_Counter;
+        };
+
+        struct Queue
+        {
+            std::mutex m_Mutex;
+            std::deque<Job> m_Jobs;
+        };
+
+    private:
+
+        void Push(Job&& job);
+        // counter == nullptr: any job
+        bool Pop(uint queueIndex, Job& job, JobCounter* counter);
+        bool Steal(uint queueIndex, Job& job, JobCounter* counter);
+        bool RunPendingJob(JobCounter* counter = nullptr);
+        void Execute(Job& job);
+        void WorkerLoop(uint queueIndex);
+
+    private:
+
+        std::vector<std::unique_ptr<Queue>> m_Queues;
+        std::vector<std::thread> m_Workers;
+
+        std::atomic<bool> m_Running;
+        std::atomic<uint> m_QueuedJobs;
+        std::mutex m_WakeMutex;
+        std::condition_variable m_WakeCondition;
+
+        // 0 for non-worker threads
+        static thread_local uint m_QueueIndex;
+        // the thread that created the job system owns index 0
+        static std::thread::id m_MainThreadID;
+
+    };
+}
@@ -0,0 +1,263 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "auxiliary/lz4.h"
+
+namespace GfxRenderEngine
+{
+    namespace LZ4
+    {
+        namespace
+        {
+            constexpr size_t MIN_MATCH = 4;
+            constexpr size_t LAST_LITERALS = 5;     // the last 5 bytes are always literals
+            constexpr size_t MF_LIMIT = 12;         // the last match starts at least 12 bytes before the end
+            constexpr size_t MAX_DISTANCE = 65535;
+            constexpr uint HASH_LOG = 16;
+            constexpr uint NO_POSITION = 0xffffffff;
+
+            inline uint Read32(const uchar* source)
+            {
+                uint value;
+                memcpy(&value, source, sizeof(uint));
+                return value;
+            }
+
+            inline uint Hash(uint sequence)
+            {
+                return (sequence * 2654435761U) >> (32 - HASH_LOG);
+            }
+
+            // length field continuation bytes: 255, 255, ..., remainder
+            inline bool WriteLength(size_t length, uchar*& output, const uchar* outputEnd)
+            {
+                while (length >= 255)
+                {
+                    if (output >= outputEnd)
+                    {
+                        return false;
+                    }
+                    *output++ = 255;
+                    length -= 255;
+                }
+                if (output >= outputEnd)
+                {
+                    return false;
+                }
+                *output++ = static_cast<uchar>(length);
+                return true;
+            }
+
+            inline bool ReadLength(size_t& length, const uchar*& input, const uchar* inputEnd)
+            {
+                uchar value;
+                do
+                {
+                    if (input >= inputEnd)
+                    {
+                        return false;
+                    }
+                    value = *input++;
+                    length += value;
+                } while (value == 255);
+                return true;
+            }
+
+            bool WriteSequence(const uchar* literals, size_t literalLength, size_t offset, size_t matchLength,
+                               uchar*& output, const uchar* outputEnd)
+            {
+                if (output >= outputEnd)
+                {
+                    return false;
+                }
+                uchar* token = output++;
+                *token = static_cast<uchar>(std::min<size_t>(literalLength, 15) << 4);
+                if ((literalLength >= 15) && !WriteLength(literalLength - 15, output, outputEnd))
+                {
+                    return false;
+                }
+                if (static_cast<size_t>(outputEnd - output) < literalLength)
+                {
+                    return false;
+                }
+                // empty input has no literals and may come with null buffers
+                if (literalLength)
+                {
+                    memcpy(output, literals, literalLength);
+                }
+                output += literalLength;
+
+                // the last sequence has no match
+                if (!matchLength)
+                {
+                    return true;
+                }
+
+                if (outputEnd - output < 2)
+                {
+                    return false;
+                }
+                *output++ = static_cast<uchar>(offset & 0xff);
+                *output++ = static_cast<uchar>(offset >> 8);
+
+                size_t length = matchLength - MIN_MATCH;
+                *token |= static_cast<uchar>(std::min<size_t>(length, 15));
+                if ((length >= 15) && !WriteLength(length - 15, output, outputEnd))
+                {
+                    return false;
+                }
+                return true;
+            }
+        }
+
+        size_t CompressBound(size_t size)
+        {
+            return size + size / 255 + 16;
+        }
+
+        size_t Compress(const uchar* source, size_t sourceSize, uchar* destination, size_t destinationCapacity)
+        {
+            uchar* output = destination;
+            const uchar* outputEnd = destination + destinationCapacity;
+            size_t anchor = 0;
+
+            if (sourceSize > MF_LIMIT)
+            {
+                std::vector<uint> hashTable(1 << HASH_LOG, NO_POSITION);
+                const size_t matchLimit = sourceSize - LAST_LITERALS;
+                const size_t lastMatchStart = sourceSize - MF_LIMIT;
+
+                size_t position = 0;
+                while (position < lastMatchStart)
+                {
+                    uint sequence = Read32(source + position);
+                    uint hash = Hash(sequence);
+                    uint candidate = hashTable[hash];
+                    hashTable[hash] = static_cast<uint>(position);
+
+                    if ((candidate == NO_POSITION) || (position - candidate > MAX_DISTANCE) ||
+                        (Read32(source + candidate) != sequence))
+                    {
+                        position++;
+                        continue;
+                    }
+
+                    size_t matchLength = MIN_MATCH;
+                    while ((position + matchLength < matchLimit) && (source[candidate + matchLength] == source[position + matchLength]))
+                    {
+                        matchLength++;
+                    }
+
+                    if (!WriteSequence(source + anchor, position - anchor, position - candidate, matchLength, output, outputEnd))
+                    {
+                        return 0;
+                    }
+                    position += matchLength;
+                    anchor = position;
+                }
+            }
+
+            if (!WriteSequence(source + anchor, sourceSize - anchor, 0, 0, output, outputEnd))
+            {
+                return 0;
+            }
+            return static_cast<size_t>(output - destination);
+        }
+
+        bool Decompress(const uchar* source, size_t sourceSize, uchar* destination, size_t destinationSize)
+        {
+            const uchar* input = source;
+            const uchar* inputEnd = source + sourceSize;
+            uchar* output = destination;
+            uchar* outputEnd = destination + destinationSize;
+
+            while (input < inputEnd)
+            {
+                uchar token = *input++;
+
+                size_t literalLength = token >> 4;
+                if ((literalLength == 15) && !ReadLength(literalLength, input, inputEnd))
+                {
+                    return false;
+                }
+                if ((static_cast<size_t>(inputEnd - input) < literalLength) || (static_cast<size_t>(outputEnd - output) < literalLength))
+                {
+                    return false;
+                }
+                if (literalLength)
+                {
+                    memcpy(output, input, literalLength);
+                }
+                input += literalLength;
+                output += literalLength;
+
+                // the last sequence ends after its literals
+                if (input == inputEnd)
+                {
+                    break;
+                }
+
+                if (inputEnd - input < 2)
+                {
+                    return false;
+                }
+                size_t offset = input[0] | (static_cast<size_t>(input[1]) << 8);
+                input += 2;
+                if (!offset || (offset > static_cast<size_t>(output - destination)))
+                {
+                    return false;
+                }
+
+                size_t matchLength = token & 15;
+                if ((matchLength == 15) && !ReadLength(matchLength, input, inputEnd))
+                {
+                    return false;
+                }
+                matchLength += MIN_MATCH;
+                if (static_cast<size_t>(outputEnd - output) < matchLength)
+                {
+                    return false;
+                }
+
+                const uchar* match = output - offset;
+                if (offset >= matchLength)
+                {
+                    memcpy(output, match, matchLength);
+                    output += matchLength;
+                }
+                else
+                {
+                    // overlapping copy repeats the last offset bytes
+                    for (size_t index = 0; index < matchLength; index++)
+                    {
+                        *output++ = match[index];
+                    }
+                }
+            }
+            return output == outputEnd;
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    // LZ4 block format (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md),
+    // greedy single-probe compressor, bounds-checked decompressor
+    namespace LZ4
+    {
+        // worst case size of the compressed data
+        size_t CompressBound(size_t size);
+
+        // returns the compressed size, 0 if the destination is too small
+        size_t Compress(const uchar* source, size_t sourceSize, uchar* destination, size_t destinationCapacity);
+
+        // false for corrupt input or if the output does not have exactly destinationSize bytes
+        bool Decompress(const uchar* source, size_t sourceSize, uchar* destination, size_t destinationSize);
+    }
+}
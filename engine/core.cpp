@@ -27,6 +27,7 @@
 #include "core.h"
 #include "engine.h"
 #include "auxiliary/file.h"
+#include "auxiliary/assetSystem.h"
 #include "auxiliary/instrumentation.h"
 #include "events/applicationEvent.h"
 #include "events/mouseEvent.h"
@@ -60,6 +61,7 @@ namespace GfxRenderEngine
         EngineCore::AddSlash(m_HomeDir);
 
         m_Engine = this;
+        m_JobSystem = std::make_unique<JobSystem>();
 
         m_DisableMousePointerTimer.SetEventCallback([](uint interval, void* parameters)
             {
@@ -83,6 +85,7 @@ namespace GfxRenderEngine
             std::cout << "Could not initialize logger" << std::endl;
         }
         InitSettings();
+        AssetSystem::MountAll();
 
         //signal handling
         signal(SIGINT, SignalHandler);
@@ -126,9 +129,39 @@ namespace GfxRenderEngine
         return true;
     }
 
+    bool Engine::StartHeadless(uint width, uint height)
+    {
+        // init logger
+        if (!Log::Init())
+        {
+            std::cout << "Could not initialize logger" << std::endl;
+        }
+        InitSettings();
+        AssetSystem::MountAll();
+
+        //signal handling
+        signal(SIGINT, SignalHandler);
+
+        m_TextureSlotManager = TextureSlotManager::Create();
+        m_GraphicsContext = GraphicsContext::CreateHeadless(width, height);
+        if (!m_GraphicsContext)
+        {
+            LOG_CORE_CRITICAL("Could not create headless graphics context");
+            return false;
+        }
+
+        m_Running = true;
+
+        return true;
+    }
+
     void Engine::Shutdown(bool switchOffComputer)
     {
-        m_Window->Shutdown();
+        // headless engines have no window
+        if (m_Window)
+        {
+            m_Window->Shutdown();
+        }
         m_Running = false;
     }
 
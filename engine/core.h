@@ -32,6 +32,7 @@
 #include "settings/settings.h"
 #include "coreSettings.h"
 #include "auxiliary/timestep.h"
+#include "auxiliary/jobSystem.h"
 #include "platform/SDL/controller.h"
 #include "platform/SDL/timer.h"
 #include "platform/window.h"
@@ -56,6 +57,8 @@ namespace GfxRenderEngine
         ~Engine();
 
         bool Start();
+        // no window, audio or input; renders offscreen, e.g. for benchmarks
+        bool StartHeadless(uint width, uint height);
         void OnUpdate();
         void OnRender();
         void OnEvent(Event& event);
@@ -83,6 +86,8 @@ namespace GfxRenderEngine
         float GetWindowWidth() const { return m_Window->GetWidth(); }
         float GetWindowHeight() const { return m_Window->GetHeight(); }
         std::shared_ptr<Model> LoadModel(const Builder& builder) { return m_GraphicsContext->LoadModel(builder); }
+        void BeginUploadBatch() { m_GraphicsContext->BeginUploadBatch(); }
+        void EndUploadBatch() { m_GraphicsContext->EndUploadBatch(); }
         bool IsFullscreen() const { return m_Window->IsFullscreen(); }
 
         void EnableMousePointer() { m_Window->EnableMousePointer(); }
@@ -104,6 +109,7 @@ namespace GfxRenderEngine
         void ToggleDebugWindow(const GenericCallback& callback = nullptr) { m_GraphicsContext->ToggleDebugWindow(callback); }
 
         Timestep GetTimestep() const { return m_Timestep; }
+        JobSystem& GetJobSystem() { return *m_JobSystem; }
 
     public:
 
@@ -122,6 +128,8 @@ namespace GfxRenderEngine
 
         std::string m_HomeDir;
         std::string m_ConfigFilePath;
+        // declared before the graphics context so that its workers outlive the renderer
+        std::unique_ptr<JobSystem> m_JobSystem;
         std::shared_ptr<Window> m_Window;
         std::shared_ptr<GraphicsContext> m_GraphicsContext;
         std::shared_ptr<Audio> m_Audio;
@@ -70,6 +70,7 @@ int engine(int argc, char* argv[])
                     engine->RunScripts(application);
                 }
                 engine->OnRender();
+                PROFILE_FRAME_MARKER();
             }
             else
             {
@@ -30,6 +30,7 @@
 #include "SDL.h"
 #include "platform/SDL/SDLaudio.h"
 #include "resources/resources.h"
+#include "auxiliary/assetSystem.h"
 
 namespace GfxRenderEngine
 {
@@ -71,10 +72,17 @@ namespace GfxRenderEngine
     {
         memset(m_DataBuffer, 0, sizeof(Mix_Chunk*) * SOUND_CHANNELS);
 
-        // load sound file from disk
+        // load sound file from a package or from disk
+        AssetData fileData;
+        if (!AssetSystem::Load(filename, fileData))
+        {
+            LOG_CORE_WARN("SDLAudio::PlaySound: Unable to read sound file: {0}", filename);
+            return;
+        }
         for (int i = 0; i < SOUND_CHANNELS; i++)
         {
-            m_DataBuffer[i] = Mix_LoadWAV(filename.c_str());
+            SDL_RWops* sdlRWOps = SDL_RWFromConstMem(fileData.Data(), static_cast<int>(fileData.Size()));
+            m_DataBuffer[i] = Mix_LoadWAV_RW(sdlRWOps, 1);
             if (m_DataBuffer[i] == nullptr)
             {
                 LOG_CORE_WARN("SDLAudio::PlaySound: Unable to load sound file: {0}, Mix_GetError(): {1}", filename, Mix_GetError());
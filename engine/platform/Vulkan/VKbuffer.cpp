@@ -55,19 +55,21 @@ namespace GfxRenderEngine
     {
         m_AlignmentSize = GetAlignment(m_InstanceSize, minOffsetAlignment);
         m_BufferSize = m_AlignmentSize * m_InstanceCount;
-        device.CreateBuffer(m_BufferSize, m_UsageFlags, m_MemoryPropertyFlags, m_Buffer, m_Memory);
+        device.CreateBuffer(m_BufferSize, m_UsageFlags, m_MemoryPropertyFlags, m_Buffer, m_Allocation);
     }
 
     VK_Buffer::~VK_Buffer()
     {
         Unmap();
-        vkDestroyBuffer(m_Device.Device(), m_Buffer, nullptr);
-        vkFreeMemory(m_Device.Device(), m_Memory, nullptr);
+        m_Device.DestroyBuffer(m_Buffer, m_Allocation);
     }
 
     /**
      * Map a memory range of this buffer. If successful, mapped points to the specified buffer range.
      *
+     * @note Host-visible memory blocks are persistently mapped by the memory allocator,
+     * this only returns a pointer into the block.
+     *
      * @param size (Optional) Size of the memory range to map. Pass VK_WHOLE_SIZE to map the complete
      * buffer range.
      * @param offset (Optional) Byte offset from beginning
@@ -76,22 +78,23 @@ namespace GfxRenderEngine
      */
     VkResult VK_Buffer::Map(VkDeviceSize size, VkDeviceSize offset)
     {
-        ASSERT(m_Buffer && m_Memory); //Called map on buffer before create
-        return vkMapMemory(m_Device.Device(), m_Memory, offset, size, 0, &m_Mapped);
+        ASSERT(m_Buffer && m_Allocation.m_Memory); //Called map on buffer before create
+        if (!m_Allocation.m_Mapped)
+        {
+            return VK_ERROR_MEMORY_MAP_FAILED;
+        }
+        m_Mapped = static_cast<char*>(m_Allocation.m_Mapped) + offset;
+        return VK_SUCCESS;
     }
 
     /**
      * Unmap a mapped memory range
      *
-     * @note Does not return a result as vkUnmapMemory can't fail
+     * @note The memory block stays mapped until the allocator releases it
      */
     void VK_Buffer::Unmap()
     {
-        if (m_Mapped)
-        {
-            vkUnmapMemory(m_Device.Device(), m_Memory);
-            m_Mapped = nullptr;
-        }
+        m_Mapped = nullptr;
     }
 
     /**
@@ -132,12 +135,7 @@ namespace GfxRenderEngine
      */
     VkResult VK_Buffer::Flush(VkDeviceSize size, VkDeviceSize offset)
     {
-        VkMappedMemoryRange mappedRange = {};
-        mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mappedRange.memory = m_Memory;
-        mappedRange.offset = offset;
-        mappedRange.size = size;
-        return vkFlushMappedMemoryRanges(m_Device.Device(), 1, &mappedRange);
+        return m_Device.GetAllocator().Flush(m_Allocation, size, offset);
     }
 
     /**
@@ -153,12 +151,7 @@ namespace GfxRenderEngine
      */
     VkResult VK_Buffer::Invalidate(VkDeviceSize size, VkDeviceSize offset)
     {
-        VkMappedMemoryRange mappedRange = {};
-        mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mappedRange.memory = m_Memory;
-        mappedRange.offset = offset;
-        mappedRange.size = size;
-        return vkInvalidateMappedMemoryRanges(m_Device.Device(), 1, &mappedRange);
+        return m_Device.GetAllocator().Invalidate(m_Allocation, size, offset);
     }
 
     /**
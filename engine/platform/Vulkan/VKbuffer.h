@@ -74,7 +74,7 @@ namespace GfxRenderEngine
         VK_Device& m_Device;
         void* m_Mapped = nullptr;
         VkBuffer m_Buffer = VK_NULL_HANDLE;
-        VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+        VK_Allocation m_Allocation;
 
         VkDeviceSize m_BufferSize;
         uint m_InstanceCount;
@@ -22,6 +22,7 @@
 
 #include "core.h"
 #include "stb_image.h"
+#include "auxiliary/assetSystem.h"
 
 #include "VKcursor.h"
 
@@ -76,7 +77,14 @@ namespace GfxRenderEngine
         m_HotX = xHot;
         m_HotY = yHot;
 
-        m_Pixels = stbi_load(fileName.c_str(), &m_Width, &m_Height, &m_BitsPerPixel, 4);
+        // GLFW expects the top row first
+        stbi_set_flip_vertically_on_load_thread(false);
+        AssetData fileData;
+        m_Pixels = nullptr;
+        if (AssetSystem::Load(fileName, fileData))
+        {
+            m_Pixels = stbi_load_from_memory(fileData.Data(), static_cast<int>(fileData.Size()), &m_Width, &m_Height, &m_BitsPerPixel, 4);
+        }
 
         return SetCursor();
     }
@@ -87,6 +95,7 @@ namespace GfxRenderEngine
         m_HotX = xHot;
         m_HotY = yHot;
 
+        stbi_set_flip_vertically_on_load_thread(false);
         m_Pixels = stbi_load_from_memory(data, length, &m_Width, &m_Height, &m_BitsPerPixel, 4);
 
         return SetCursor();
@@ -127,31 +127,42 @@ namespace GfxRenderEngine
         VkDescriptorPoolCreateFlags poolFlags,
         const std::vector<VkDescriptorPoolSize>& poolSizes
     )
+        : m_MaxSets{maxSets}, m_PoolFlags{poolFlags}, m_PoolSizes{poolSizes}
+    {
+        m_DescriptorPools.push_back(CreatePool());
+    }
+
+    VK_DescriptorPool::~VK_DescriptorPool()
+    {
+        vkDeviceWaitIdle(VK_Core::m_Device->Device());
+        for (auto descriptorPool : m_DescriptorPools)
+        {
+            vkDestroyDescriptorPool(VK_Core::m_Device->Device(), descriptorPool, nullptr);
+        }
+    }
+
+    VkDescriptorPool VK_DescriptorPool::CreatePool() const
     {
         VkDescriptorPoolCreateInfo descriptorPoolInfo{};
         descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        descriptorPoolInfo.poolSizeCount = static_cast<uint>(poolSizes.size());
-        descriptorPoolInfo.pPoolSizes = poolSizes.data();
-        descriptorPoolInfo.maxSets = maxSets;
-        descriptorPoolInfo.flags = poolFlags;
+        descriptorPoolInfo.poolSizeCount = static_cast<uint>(m_PoolSizes.size());
+        descriptorPoolInfo.pPoolSizes = m_PoolSizes.data();
+        descriptorPoolInfo.maxSets = m_MaxSets;
+        descriptorPoolInfo.flags = m_PoolFlags;
 
+        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
         auto result = vkCreateDescriptorPool
                       (
                         VK_Core::m_Device->Device(),
                         &descriptorPoolInfo,
                         nullptr,
-                        &m_DescriptorPool
+                        &descriptorPool
                       );
         if (result != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("failed to create descriptor pool!");
         }
-    }
-
-    VK_DescriptorPool::~VK_DescriptorPool()
-    {
-        vkDeviceWaitIdle(VK_Core::m_Device->Device());
-        vkDestroyDescriptorPool(VK_Core::m_Device->Device(), m_DescriptorPool, nullptr);
+        return descriptorPool;
     }
 
     bool VK_DescriptorPool::AllocateDescriptorSet
@@ -160,34 +171,65 @@ namespace GfxRenderEngine
             VkDescriptorSet& descriptor
         ) const
     {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
         VkDescriptorSetAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = m_DescriptorPool;
+        allocInfo.descriptorPool = m_DescriptorPools.back();
         allocInfo.pSetLayouts = &descriptorSetLayout;
         allocInfo.descriptorSetCount = 1;
 
         auto result = vkAllocateDescriptorSets(VK_Core::m_Device->Device(), &allocInfo, &descriptor);
+        if ((result == VK_ERROR_OUT_OF_POOL_MEMORY) || (result == VK_ERROR_FRAGMENTED_POOL))
+        {
+            // the current pool is full, continue in a new one
+            m_DescriptorPools.push_back(CreatePool());
+            LOG_CORE_INFO("descriptor pool full, adding pool number {0}", m_DescriptorPools.size());
+            allocInfo.descriptorPool = m_DescriptorPools.back();
+            result = vkAllocateDescriptorSets(VK_Core::m_Device->Device(), &allocInfo, &descriptor);
+        }
         if (result != VK_SUCCESS)
         {
             return false;
         }
+        if (m_PoolFlags & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)
+        {
+            m_Owners[descriptor] = allocInfo.descriptorPool;
+        }
         return true;
     }
 
     void VK_DescriptorPool::FreeDescriptors(std::vector<VkDescriptorSet>& descriptors) const
     {
-        vkFreeDescriptorSets
-        (
-            VK_Core::m_Device->Device(),
-            m_DescriptorPool,
-            static_cast<uint>(descriptors.size()),
-            descriptors.data()
-        );
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ASSERT(m_PoolFlags & VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
+
+        for (auto descriptor : descriptors)
+        {
+            auto owner = m_Owners.find(descriptor);
+            if (owner == m_Owners.end())
+            {
+                continue;
+            }
+            vkFreeDescriptorSets(VK_Core::m_Device->Device(), owner->second, 1, &descriptor);
+            m_Owners.erase(owner);
+        }
     }
 
     void VK_DescriptorPool::ResetPool()
     {
-        vkResetDescriptorPool(VK_Core::m_Device->Device(), m_DescriptorPool, 0);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto descriptorPool : m_DescriptorPools)
+        {
+            vkResetDescriptorPool(VK_Core::m_Device->Device(), descriptorPool, 0);
+        }
+        m_Owners.clear();
+    }
+
+    uint VK_DescriptorPool::GetNumberOfPools() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return static_cast<uint>(m_DescriptorPools.size());
     }
 
     // *************** Descriptor Writer *********************
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.h>
@@ -92,6 +93,7 @@ namespace GfxRenderEngine
         friend class VK_DescriptorWriter;
     };
 
+    // grows by adding pools of the same size when a pool runs out of descriptors
     class VK_DescriptorPool
     {
 
@@ -130,9 +132,22 @@ namespace GfxRenderEngine
         void FreeDescriptors(std::vector<VkDescriptorSet>& descriptors) const;
         void ResetPool();
 
+        uint GetNumberOfPools() const;
+
     private:
 
-        VkDescriptorPool m_DescriptorPool;
+        VkDescriptorPool CreatePool() const;
+
+    private:
+
+        uint m_MaxSets;
+        VkDescriptorPoolCreateFlags m_PoolFlags;
+        std::vector<VkDescriptorPoolSize> m_PoolSizes;
+
+        mutable std::mutex m_Mutex;
+        mutable std::vector<VkDescriptorPool> m_DescriptorPools;
+        // owning pool of each set, only tracked if sets can be freed individually
+        mutable std::unordered_map<VkDescriptorSet, VkDescriptorPool> m_Owners;
 
         friend class VK_DescriptorWriter;
     };
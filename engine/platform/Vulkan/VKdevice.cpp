@@ -29,7 +29,9 @@
 #include "coreSettings.h"
 
 #include "VKdevice.h"
+#include "VKbuffer.h"
 #include "VKwindow.h"
+#include "VKtextureSlotManager.h"
 
 namespace GfxRenderEngine
 {
@@ -79,18 +81,28 @@ namespace GfxRenderEngine
         }
     }
 
-    VK_Device::VK_Device(VK_Window* window) : m_Window{window}
+    VK_Device::VK_Device(VK_Window* window) : m_Window{window}, m_Surface{VK_NULL_HANDLE}
     {
+        if (IsHeadless())
+        {
+            deviceExtensions.clear();
+        }
         CreateInstance();
         SetupDebugMessenger();
         CreateSurface();
         PickPhysicalDevice();
         CreateLogicalDevice();
         CreateCommandPool();
+        m_Allocator = std::make_unique<VK_MemoryAllocator>(*this);
+        m_UploadContext = std::make_unique<VK_UploadContext>(*this);
+        m_PipelineCache = std::make_unique<VK_PipelineCache>(*this);
     }
 
     VK_Device::~VK_Device()
     {
+        m_PipelineCache.reset();
+        m_UploadContext.reset();
+        m_Allocator.reset();
         vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
         vkDestroyDevice(m_Device, nullptr);
 
@@ -99,13 +111,17 @@ namespace GfxRenderEngine
             DestroyDebugUtilsMessengerEXT(m_Instance, m_DebugMessenger, nullptr);
         }
 
-        vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
+        if (m_Surface != VK_NULL_HANDLE)
+        {
+            vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
+        }
         vkDestroyInstance(m_Instance, nullptr);
     }
     
     void VK_Device::Shutdown()
     {
         vkQueueWaitIdle(m_GraphicsQueue);
+        m_PipelineCache->Save();
     }
 
     void VK_Device::CreateInstance()
@@ -121,7 +137,7 @@ namespace GfxRenderEngine
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         appInfo.pEngineName = "gfxRenderEngine";
         appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-        appInfo.apiVersion = VK_API_VERSION_1_0;
+        appInfo.apiVersion = VK_MAKE_VERSION(1, 2, 0);
 
         VkInstanceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -201,7 +217,7 @@ namespace GfxRenderEngine
         QueueFamilyIndices indices = FindQueueFamilies(m_PhysicalDevice);
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-        std::set<uint> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+        std::set<uint> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily, indices.transferFamily};
 
         float queuePriority = 1.0f;
         for (uint queueFamily : uniqueQueueFamilies)
@@ -214,11 +230,30 @@ namespace GfxRenderEngine
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(m_PhysicalDevice, &supportedFeatures);
+        m_SupportsBCTextures = supportedFeatures.textureCompressionBC;
+
         VkPhysicalDeviceFeatures deviceFeatures = {};
         deviceFeatures.samplerAnisotropy = VK_TRUE;
+        deviceFeatures.textureCompressionBC = m_SupportsBCTextures ? VK_TRUE : VK_FALSE;
+        LOG_CORE_INFO("BC texture compression {0}", m_SupportsBCTextures ? "supported" : "not supported, using uncompressed textures");
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+        descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        m_SupportsBindlessTextures = CheckBindlessTextureSupport();
+        if (m_SupportsBindlessTextures)
+        {
+            descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing    = VK_TRUE;
+            descriptorIndexingFeatures.descriptorBindingPartiallyBound              = VK_TRUE;
+            descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending    = VK_TRUE;
+        }
+        LOG_CORE_INFO("bindless textures {0}", m_SupportsBindlessTextures ? "supported" : "not supported, using per-material descriptor sets");
 
         VkDeviceCreateInfo createInfo = {};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = m_SupportsBindlessTextures ? &descriptorIndexingFeatures : nullptr;
 
         createInfo.queueCreateInfoCount = static_cast<uint>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
@@ -246,6 +281,40 @@ namespace GfxRenderEngine
 
         vkGetDeviceQueue(m_Device, indices.graphicsFamily, 0, &m_GraphicsQueue);
         vkGetDeviceQueue(m_Device, indices.presentFamily, 0, &m_PresentQueue);
+        vkGetDeviceQueue(m_Device, indices.transferFamily, 0, &m_TransferQueue);
+        LOG_CORE_INFO("transfer queue: {0}", HasDedicatedTransferQueue() ? "dedicated queue family" : "graphics queue");
+    }
+
+    // descriptor indexing is core in Vulkan 1.2; the texture table needs
+    // non-uniform indexing, partially bound descriptors and update-after-bind
+    bool VK_Device::CheckBindlessTextureSupport()
+    {
+        if (properties.apiVersion < VK_MAKE_VERSION(1, 2, 0))
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures = {};
+        descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        VkPhysicalDeviceFeatures2 features = {};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &descriptorIndexingFeatures;
+        vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &features);
+
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptorIndexingProperties = {};
+        descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 properties2 = {};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &descriptorIndexingProperties;
+        vkGetPhysicalDeviceProperties2(m_PhysicalDevice, &properties2);
+
+        return descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing &&
+               descriptorIndexingFeatures.descriptorBindingPartiallyBound &&
+               descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+               descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending &&
+               (descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers >= VKTextureSlotManager::MAX_TEXTURE_SLOTS) &&
+               (descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages >= VKTextureSlotManager::MAX_TEXTURE_SLOTS) &&
+               (descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSamplers >= VKTextureSlotManager::MAX_TEXTURE_SLOTS);
     }
 
     void VK_Device::CreateCommandPool()
@@ -266,6 +335,10 @@ namespace GfxRenderEngine
 
     void VK_Device::CreateSurface()
     {
+        if (IsHeadless())
+        {
+            return;
+        }
         m_Window->CreateWindowSurface(m_Instance, &m_Surface);
     }
 
@@ -304,8 +377,8 @@ namespace GfxRenderEngine
 
         bool extensionsSupported = CheckDeviceExtensionSupport(device);
 
-        bool swapChainAdequate = false;
-        if (extensionsSupported)
+        bool swapChainAdequate = IsHeadless();
+        if (extensionsSupported && !IsHeadless())
         {
             SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(device);
             swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
@@ -376,11 +449,14 @@ namespace GfxRenderEngine
 
     std::vector<const char *> VK_Device::GetRequiredExtensions()
     {
-        uint glfwExtensionCount = 0;
-        const char **glfwExtensions;
-        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-        std::vector<const char *> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        std::vector<const char *> extensions;
+        if (!IsHeadless())
+        {
+            uint glfwExtensionCount = 0;
+            const char **glfwExtensions;
+            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        }
 
         if (enableValidationLayers)
         {
@@ -457,7 +533,15 @@ namespace GfxRenderEngine
                 indices.graphicsFamilyHasValue = true;
             }
             VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_Surface, &presentSupport);
+            if (IsHeadless())
+            {
+                // nothing is presented, the graphics queue stands in
+                presentSupport = indices.graphicsFamilyHasValue && (indices.graphicsFamily == i);
+            }
+            else
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_Surface, &presentSupport);
+            }
             if (queueFamily.queueCount > 0 && presentSupport)
             {
                 indices.presentFamily = i;
@@ -471,6 +555,20 @@ namespace GfxRenderEngine
             i++;
         }
 
+        // uploads run on a transfer-only family (DMA engine) if there is one
+        indices.transferFamily = indices.graphicsFamily;
+        for (uint family = 0; family < queueFamilyCount; family++)
+        {
+            auto& queueFamily = queueFamilies[family];
+            bool transferOnly = (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                               !(queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+            if (queueFamily.queueCount > 0 && transferOnly)
+            {
+                indices.transferFamily = family;
+                break;
+            }
+        }
+
         return indices;
     }
 
@@ -546,7 +644,7 @@ namespace GfxRenderEngine
         VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkBuffer &buffer,
-        VkDeviceMemory &bufferMemory)
+        VK_Allocation &allocation)
     {
         VkBufferCreateInfo bufferInfo{};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -562,21 +660,27 @@ namespace GfxRenderEngine
         VkMemoryRequirements memRequirements;
         vkGetBufferMemoryRequirements(m_Device, buffer, &memRequirements);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-        if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
+        if (!m_Allocator->Allocate(memRequirements, properties, true /*linear*/, allocation))
         {
             LOG_CORE_CRITICAL("failed to allocate vertex buffer memory!");
         }
 
-        vkBindBufferMemory(m_Device, buffer, bufferMemory, 0);
+        vkBindBufferMemory(m_Device, buffer, allocation.m_Memory, allocation.m_Offset);
+    }
+
+    void VK_Device::DestroyBuffer(VkBuffer buffer, VK_Allocation &allocation)
+    {
+        vkDestroyBuffer(m_Device, buffer, nullptr);
+        m_Allocator->Free(allocation);
     }
 
     VkCommandBuffer VK_Device::BeginSingleTimeCommands()
     {
+        if (m_UploadContext->IsRecording())
+        {
+            return m_UploadContext->GetCommandBuffer();
+        }
+
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -597,6 +701,12 @@ namespace GfxRenderEngine
 
     void VK_Device::EndSingleTimeCommands(VkCommandBuffer commandBuffer)
     {
+        if (m_UploadContext->IsRecording())
+        {
+            // submitted together with the rest of the batch
+            return;
+        }
+
         vkEndCommandBuffer(commandBuffer);
 
         VkSubmitInfo submitInfo{};
@@ -623,6 +733,30 @@ namespace GfxRenderEngine
         EndSingleTimeCommands(commandBuffer);
     }
 
+    void VK_Device::BeginUploadBatch()
+    {
+        m_UploadContext->Begin();
+    }
+
+    void VK_Device::EndUploadBatch()
+    {
+        m_UploadContext->End();
+        if (!m_UploadContext->IsRecording())
+        {
+            m_Allocator->LogStatistics();
+        }
+    }
+
+    void VK_Device::CollectUploads()
+    {
+        m_UploadContext->Collect();
+    }
+
+    void VK_Device::ReleaseAfterUpload(std::unique_ptr<VK_Buffer> stagingBuffer)
+    {
+        m_UploadContext->ReleaseAfterUpload(std::move(stagingBuffer));
+    }
+
     void VK_Device::CopyBufferToImage(
         VkBuffer buffer, VkImage image, uint width, uint height, uint layerCount)
     {
@@ -680,4 +814,36 @@ namespace GfxRenderEngine
             LOG_CORE_CRITICAL("failed to bind image memory!");
         }
     }
+
+    void VK_Device::CreateImage(
+        const VkImageCreateInfo &imageInfo,
+        VkMemoryPropertyFlags properties,
+        VkImage &image,
+        VK_Allocation &allocation)
+    {
+        if (vkCreateImage(m_Device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to create image!");
+        }
+
+        VkMemoryRequirements memRequirements;
+        vkGetImageMemoryRequirements(m_Device, image, &memRequirements);
+
+        bool linear = (imageInfo.tiling == VK_IMAGE_TILING_LINEAR);
+        if (!m_Allocator->Allocate(memRequirements, properties, linear, allocation))
+        {
+            LOG_CORE_CRITICAL("failed to allocate image memory!");
+        }
+
+        if (vkBindImageMemory(m_Device, image, allocation.m_Memory, allocation.m_Offset) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to bind image memory!");
+        }
+    }
+
+    void VK_Device::DestroyImage(VkImage image, VK_Allocation &allocation)
+    {
+        vkDestroyImage(m_Device, image, nullptr);
+        m_Allocator->Free(allocation);
+    }
 }
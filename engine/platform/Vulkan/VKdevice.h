@@ -24,8 +24,13 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <vulkan/vulkan.h>
 
+#include "VKuploadContext.h"
+#include "VKmemoryAllocator.h"
+#include "VKpipelineCache.h"
+
 namespace GfxRenderEngine
 {
     struct SwapChainSupportDetails
@@ -39,6 +44,7 @@ namespace GfxRenderEngine
     {
         uint graphicsFamily;
         uint presentFamily;
+        uint transferFamily; // graphics family if there is no dedicated transfer family
         bool graphicsFamilyHasValue = false;
         bool presentFamilyHasValue = false;
         bool isComplete() { return graphicsFamilyHasValue && presentFamilyHasValue; }
@@ -57,6 +63,7 @@ namespace GfxRenderEngine
         const bool enableValidationLayers = true;
         #endif
 
+        // a device without window (nullptr) renders offscreen and needs no surface or swap chain extension
         VK_Device(VK_Window* window);
         ~VK_Device();
 
@@ -72,8 +79,16 @@ namespace GfxRenderEngine
         VkCommandPool GetCommandPool() { return m_CommandPool; }
         VkPhysicalDevice PhysicalDevice() { return m_PhysicalDevice; }
         VkSurfaceKHR Surface() { return m_Surface; }
+        bool IsHeadless() const { return m_Window == nullptr; }
+        // descriptor indexing for the global texture table, see VK_TextureTable
+        bool SupportsBindlessTextures() const { return m_SupportsBindlessTextures; }
+        // block-compressed texture formats, see TextureCompressor
+        bool SupportsBCTextures() const { return m_SupportsBCTextures; }
         VkQueue GraphicsQueue() { return m_GraphicsQueue; }
         VkQueue PresentQueue() { return m_PresentQueue; }
+        // queue of a transfer-only family if available, otherwise the graphics queue
+        VkQueue TransferQueue() { return m_TransferQueue; }
+        bool HasDedicatedTransferQueue() const { return m_TransferQueue != m_GraphicsQueue; }
 
         SwapChainSupportDetails GetSwapChainSupport() { return QuerySwapChainSupport(m_PhysicalDevice); }
         uint FindMemoryType(uint typeFilter, VkMemoryPropertyFlags properties);
@@ -88,12 +103,19 @@ namespace GfxRenderEngine
             VkBufferUsageFlags usage,
             VkMemoryPropertyFlags properties,
             VkBuffer &buffer,
-            VkDeviceMemory &bufferMemory
+            VK_Allocation &allocation
         );
+        void DestroyBuffer(VkBuffer buffer, VK_Allocation &allocation);
 
         VkCommandBuffer BeginSingleTimeCommands();
         void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
         void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+
+        // upload batches: single-time commands are recorded into one submission between Begin/End
+        void BeginUploadBatch();
+        void EndUploadBatch();
+        void CollectUploads();
+        void ReleaseAfterUpload(std::unique_ptr<VK_Buffer> stagingBuffer);
         void CopyBufferToImage
         (
             VkBuffer buffer,
@@ -111,10 +133,24 @@ namespace GfxRenderEngine
             VkDeviceMemory &imageMemory
         );
 
+        // sub-allocated images, e.g. textures
+        void CreateImage
+        (
+            const VkImageCreateInfo &imageInfo,
+            VkMemoryPropertyFlags properties,
+            VkImage &image,
+            VK_Allocation &allocation
+        );
+        void DestroyImage(VkImage image, VK_Allocation &allocation);
+
+        VK_MemoryAllocator& GetAllocator() { return *m_Allocator; }
+        VkPipelineCache GetPipelineCache() const { return m_PipelineCache->GetPipelineCache(); }
+
         VkPhysicalDeviceProperties properties;
         
         VkInstance GetInstance() const { return m_Instance; }
         uint32_t GetGraphicsQueueFamily() { return FindPhysicalQueueFamilies().graphicsFamily; }
+        uint32_t GetTransferQueueFamily() { return FindPhysicalQueueFamilies().transferFamily; }
 
     private:
 
@@ -134,21 +170,28 @@ namespace GfxRenderEngine
         void PopulateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo);
         void HasGflwRequiredInstanceExtensions();
         bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
+        bool CheckBindlessTextureSupport();
         SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device);
 
         VkInstance m_Instance;
         VkDebugUtilsMessengerEXT m_DebugMessenger;
         VkPhysicalDevice m_PhysicalDevice = VK_NULL_HANDLE;
         VK_Window* m_Window;
+        bool m_SupportsBindlessTextures = false;
+        bool m_SupportsBCTextures = false;
         VkCommandPool m_CommandPool;
+        std::unique_ptr<VK_UploadContext> m_UploadContext;
+        std::unique_ptr<VK_MemoryAllocator> m_Allocator;
+        std::unique_ptr<VK_PipelineCache> m_PipelineCache;
 
         VkDevice m_Device;
         VkSurfaceKHR m_Surface;
         VkQueue m_GraphicsQueue;
         VkQueue m_PresentQueue;
+        VkQueue m_TransferQueue;
 
         const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
-        const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+        std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
     };
 }
@@ -25,10 +25,12 @@
 #include <vulkan/vulkan.h>
 
 #include "renderer/camera.h"
+#include "renderer/frustum.h"
 #include "scene/components.h"
 
 namespace GfxRenderEngine
 {
+    class VK_InstanceBuffer;
 
     struct PointLight
     {
@@ -56,6 +58,9 @@ namespace GfxRenderEngine
         VkCommandBuffer m_CommandBuffer;
         Camera* m_Camera;
         VkDescriptorSet m_GlobalDescriptorSet;
+        VK_InstanceBuffer* m_InstanceBuffer;
+        Frustum m_Frustum;
+        VkDescriptorSet m_TextureTableDescriptorSet; // VK_NULL_HANDLE without bindless textures
     };
 
 }
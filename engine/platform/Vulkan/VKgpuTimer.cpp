@@ -0,0 +1,238 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "imgui/imgui.h"
+
+#include "auxiliary/instrumentation.h"
+
+#include "VKgpuTimer.h"
+
+namespace GfxRenderEngine
+{
+    VK_GpuTimer::VK_GpuTimer(VK_Device& device, uint numberOfFrames)
+        : m_Device{device}, m_Supported{false}, m_TimestampPeriod{1.0f}, m_TimestampMask{0},
+          m_Frames(numberOfFrames), m_CurrentFrame{0}, m_HistoryIndex{0}, m_HistorySize{0}, m_LastFrameTime{0.0f}, m_LastStageTime{0.0f}
+    {
+        uint queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(m_Device.PhysicalDevice(), &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(m_Device.PhysicalDevice(), &queueFamilyCount, queueFamilies.data());
+
+        uint validBits = queueFamilies[m_Device.GetGraphicsQueueFamily()].timestampValidBits;
+        if (!validBits || (m_Device.properties.limits.timestampPeriod == 0.0f))
+        {
+            LOG_CORE_WARN("VK_GpuTimer: timestamp queries are not supported on the graphics queue");
+            return;
+        }
+        m_TimestampPeriod = m_Device.properties.limits.timestampPeriod;
+        m_TimestampMask = (validBits == 64) ? ~0ULL : ((1ULL << validBits) - 1);
+
+        for (auto& frame : m_Frames)
+        {
+            VkQueryPoolCreateInfo queryPoolInfo{};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = QUERIES_PER_FRAME;
+
+            if (vkCreateQueryPool(m_Device.Device(), &queryPoolInfo, nullptr, &frame.m_QueryPool) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to create timestamp query pool!");
+                return;
+            }
+        }
+        m_Supported = true;
+    }
+
+    VK_GpuTimer::~VK_GpuTimer()
+    {
+        for (auto& frame : m_Frames)
+        {
+            if (frame.m_QueryPool != VK_NULL_HANDLE)
+            {
+                vkDestroyQueryPool(m_Device.Device(), frame.m_QueryPool, nullptr);
+            }
+        }
+    }
+
+    void VK_GpuTimer::BeginFrame(VkCommandBuffer commandBuffer, uint frameIndex)
+    {
+        if (!m_Supported)
+        {
+            return;
+        }
+
+        m_CurrentFrame = frameIndex;
+        auto& frame = m_Frames[frameIndex];
+        if (frame.m_Recorded)
+        {
+            Collect(frame);
+        }
+
+        vkCmdResetQueryPool(commandBuffer, frame.m_QueryPool, 0, QUERIES_PER_FRAME);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.m_QueryPool, FRAME_BEGIN);
+        frame.m_ScopeCount = 0;
+        frame.m_Recorded = true;
+    }
+
+    void VK_GpuTimer::EndFrame(VkCommandBuffer commandBuffer)
+    {
+        if (!m_Supported)
+        {
+            return;
+        }
+
+        auto& frame = m_Frames[m_CurrentFrame];
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.m_QueryPool, FRAME_END);
+        frame.m_SubmitTime = std::chrono::steady_clock::now();
+    }
+
+    uint VK_GpuTimer::BeginScope(VkCommandBuffer commandBuffer, Stage stage)
+    {
+        if (!m_Supported)
+        {
+            return INVALID_SCOPE;
+        }
+
+        auto& frame = m_Frames[m_CurrentFrame];
+        uint scope = frame.m_ScopeCount.fetch_add(1);
+        if (scope >= MAX_SCOPES_PER_FRAME)
+        {
+            return INVALID_SCOPE;
+        }
+
+        frame.m_Stages[scope] = stage;
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.m_QueryPool, GetScopeQuery(scope));
+        return scope;
+    }
+
+    void VK_GpuTimer::EndScope(VkCommandBuffer commandBuffer, uint scope)
+    {
+        if (scope == INVALID_SCOPE)
+        {
+            return;
+        }
+
+        auto& frame = m_Frames[m_CurrentFrame];
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.m_QueryPool, GetScopeQuery(scope) + 1);
+    }
+
+    void VK_GpuTimer::Collect(Frame& frame)
+    {
+        uint scopeCount = std::min(frame.m_ScopeCount.load(), MAX_SCOPES_PER_FRAME);
+        uint queryCount = GetScopeQuery(scopeCount);
+
+        std::array<uint64, QUERIES_PER_FRAME> timestamps;
+        VkResult result = vkGetQueryPoolResults
+        (
+            m_Device.Device(),
+            frame.m_QueryPool,
+            0,
+            queryCount,
+            queryCount * sizeof(uint64),
+            timestamps.data(),
+            sizeof(uint64),
+            VK_QUERY_RESULT_64_BIT
+        );
+        if (result != VK_SUCCESS)
+        {
+            return;
+        }
+
+        std::array<float, NUMBER_OF_STAGES> stageTimes{};
+        uint64 frameStart = timestamps[FRAME_BEGIN] & m_TimestampMask;
+        uint64 frameEnd   = timestamps[FRAME_END] & m_TimestampMask;
+        for (uint scope = 0; scope < scopeCount; scope++)
+        {
+            uint64 begin = timestamps[GetScopeQuery(scope)] & m_TimestampMask;
+            uint64 end   = timestamps[GetScopeQuery(scope) + 1] & m_TimestampMask;
+            float durationNanoSeconds = static_cast<float>((end - begin) & m_TimestampMask) * m_TimestampPeriod;
+            stageTimes[frame.m_Stages[scope]] += durationNanoSeconds / 1000000.0f;
+
+            #if defined(PROFILING)
+                // the start of the frame on the GPU is approximated by the submit time on the CPU
+                auto offset = std::chrono::nanoseconds(static_cast<int64>(static_cast<float>((begin - frameStart) & m_TimestampMask) * m_TimestampPeriod));
+                PROFILE_GPU_SCOPE(GetStageName(frame.m_Stages[scope]), frame.m_SubmitTime + offset, static_cast<int64>(durationNanoSeconds));
+            #endif
+        }
+
+        // stages may overlap or leave gaps, the frame time is measured separately
+        m_LastFrameTime = static_cast<float>((frameEnd - frameStart) & m_TimestampMask) * m_TimestampPeriod / 1000000.0f;
+        m_LastStageTime = 0.0f;
+        for (uint stage = 0; stage < NUMBER_OF_STAGES; stage++)
+        {
+            m_History[stage][m_HistoryIndex] = stageTimes[stage];
+            m_LastStageTime += stageTimes[stage];
+        }
+        m_HistoryIndex = (m_HistoryIndex + 1) % NUMBER_OF_AVERAGED_FRAMES;
+        m_HistorySize = std::min(m_HistorySize + 1, NUMBER_OF_AVERAGED_FRAMES);
+    }
+
+    float VK_GpuTimer::GetAverage(Stage stage) const
+    {
+        if (!m_HistorySize)
+        {
+            return 0.0f;
+        }
+
+        float sum = 0.0f;
+        for (uint index = 0; index < m_HistorySize; index++)
+        {
+            sum += m_History[stage][index];
+        }
+        return sum / m_HistorySize;
+    }
+
+    const char* VK_GpuTimer::GetStageName(Stage stage)
+    {
+        static const char* stageNames[NUMBER_OF_STAGES] =
+        {
+            "default diffuse map",
+            "pbr no map",
+            "pbr diffuse",
+            "pbr diffuse normal",
+            "pbr diffuse normal roughness metallic",
+            "point lights",
+            "particles",
+            "gui",
+            "imgui"
+        };
+        return stageNames[stage];
+    }
+
+    void VK_GpuTimer::ShowStatistics() const
+    {
+        if (!m_Supported)
+        {
+            ImGui::Text("GPU timestamps not supported");
+            return;
+        }
+
+        float total = 0.0f;
+        for (uint stage = 0; stage < NUMBER_OF_STAGES; stage++)
+        {
+            float average = GetAverage(static_cast<Stage>(stage));
+            total += average;
+            ImGui::Text("GPU %-38s %.3f ms", GetStageName(static_cast<Stage>(stage)), average);
+        }
+        ImGui::Text("GPU total (%u frames average) %.3f ms", m_HistorySize, total);
+    }
+}
@@ -0,0 +1,126 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKdevice.h"
+
+namespace GfxRenderEngine
+{
+    // measures the GPU time of render stages with timestamp queries;
+    // results are read back when a frame slot is reused, i.e. MAX_FRAMES_IN_FLIGHT frames later
+    class VK_GpuTimer
+    {
+
+    public:
+
+        enum Stage
+        {
+            DEFAULT_DIFFUSE_MAP,
+            PBR_NO_MAP,
+            PBR_DIFFUSE,
+            PBR_DIFFUSE_NORMAL,
+            PBR_DIFFUSE_NORMAL_ROUGHNESS_METALLIC,
+            POINT_LIGHTS,
+            PARTICLES,
+            GUI,
+            IMGUI,
+            NUMBER_OF_STAGES
+        };
+
+        static constexpr uint MAX_SCOPES_PER_FRAME = 32;
+        static constexpr uint NUMBER_OF_AVERAGED_FRAMES = 60;
+        static constexpr uint INVALID_SCOPE = 0xffffffff;
+
+    public:
+
+        VK_GpuTimer(VK_Device& device, uint numberOfFrames);
+        ~VK_GpuTimer();
+
+        VK_GpuTimer(const VK_GpuTimer&) = delete;
+        VK_GpuTimer& operator=(const VK_GpuTimer&) = delete;
+
+        // primary command buffer, outside of a render pass; the frame must not be in flight anymore
+        void BeginFrame(VkCommandBuffer commandBuffer, uint frameIndex);
+        // primary command buffer, outside of a render pass, right before it is ended and submitted
+        void EndFrame(VkCommandBuffer commandBuffer);
+
+        // thread-safe, any command buffer of the current frame
+        uint BeginScope(VkCommandBuffer commandBuffer, Stage stage);
+        void EndScope(VkCommandBuffer commandBuffer, uint scope);
+
+        bool IsSupported() const { return m_Supported; }
+        float GetAverage(Stage stage) const; // milliseconds
+        float GetLastFrameTime() const { return m_LastFrameTime; } // milliseconds, frame begin to frame end of the last collected frame
+        float GetLastStageTime() const { return m_LastStageTime; } // milliseconds, sum of all scopes of the last collected frame
+        static const char* GetStageName(Stage stage);
+
+        // adds the rolling averages to the current ImGui window
+        void ShowStatistics() const;
+
+    private:
+
+        static constexpr uint QUERIES_PER_FRAME = 2 + 2 * MAX_SCOPES_PER_FRAME; // frame begin/end + begin/end per scope
+        static constexpr uint FRAME_BEGIN = 0;
+        static constexpr uint FRAME_END = 1;
+        static uint GetScopeQuery(uint scope) { return 2 + 2 * scope; }
+
+        struct Frame
+        {
+            VkQueryPool m_QueryPool = VK_NULL_HANDLE;
+            std::atomic<uint> m_ScopeCount{0};
+            std::array<Stage, MAX_SCOPES_PER_FRAME> m_Stages;
+            std::chrono::steady_clock::time_point m_SubmitTime;
+            bool m_Recorded = false;
+        };
+
+    private:
+
+        void Collect(Frame& frame);
+
+    private:
+
+        VK_Device& m_Device;
+        bool m_Supported;
+        float m_TimestampPeriod; // nanoseconds per tick
+        uint64 m_TimestampMask;
+
+        std::vector<Frame> m_Frames;
+        uint m_CurrentFrame;
+
+        // rolling history in milliseconds
+        std::array<std::array<float, NUMBER_OF_AVERAGED_FRAMES>, NUMBER_OF_STAGES> m_History{};
+        uint m_HistoryIndex;
+        uint m_HistorySize;
+        float m_LastFrameTime;
+        float m_LastStageTime;
+
+    };
+}
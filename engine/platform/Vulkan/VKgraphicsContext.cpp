@@ -29,19 +29,29 @@
 
 #include "VKcore.h"
 #include "VKgraphicsContext.h"
+#include "VKrenderer.h"
 
 namespace GfxRenderEngine
 {
     VK_Context::VK_Context(VK_Window* window)
-        : m_Window{window}, m_FrameDuration{16.667ms},
+        : m_Window{window}, m_OffscreenExtent{0, 0}, m_FrameDuration{16.667ms},
           m_VSyncIsWorking{10}
     {
         Init();
     }
 
+    VK_Context::VK_Context(uint width, uint height)
+        : m_Window{nullptr}, m_OffscreenExtent{width, height}, m_FrameDuration{0ms},
+          m_VSyncIsWorking{0}
+    {
+        // without window, the device is created here
+        VK_Core::m_Device = std::make_shared<VK_Device>(nullptr);
+        Init();
+    }
+
     bool VK_Context::Init()
     {
-        m_Renderer = std::make_shared<VK_Renderer>(m_Window, VK_Core::m_Device);
+        m_Renderer = std::make_shared<VK_Renderer>(m_Window, VK_Core::m_Device, m_OffscreenExtent);
         m_Initialized = true;
         return m_Initialized;
     }
@@ -76,8 +86,27 @@ namespace GfxRenderEngine
     std::shared_ptr<Model> VK_Context::LoadModel(const Builder& builder)
     {
         ASSERT(VK_Core::m_Device != nullptr);
+        // large meshes are uploaded in the background, see VK_ResourceStreamer
+        auto& streamer = VK_Renderer::m_ResourceStreamer;
+        VkDeviceSize size = sizeof(Vertex) * builder.m_Vertices.size() + sizeof(uint) * builder.m_Indices.size();
+        if (streamer && (size >= VK_ResourceStreamer::MIN_STREAMED_MESH_SIZE))
+        {
+            auto model = std::make_shared<VK_Model>(VK_Core::m_Device, builder, true /*streamed*/);
+            streamer->Load(model, builder.m_Vertices, builder.m_Indices);
+            return model;
+        }
         auto model = std::make_shared<VK_Model>(VK_Core::m_Device, builder);
         return model;
     }
 
+    void VK_Context::BeginUploadBatch()
+    {
+        VK_Core::m_Device->BeginUploadBatch();
+    }
+
+    void VK_Context::EndUploadBatch()
+    {
+        VK_Core::m_Device->EndUploadBatch();
+    }
+
 }
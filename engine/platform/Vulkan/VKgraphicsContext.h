@@ -39,6 +39,8 @@ namespace GfxRenderEngine
     public:
 
         VK_Context(VK_Window* window);
+        // offscreen rendering without window and surface
+        VK_Context(uint width, uint height);
         ~VK_Context() override {}
 
         virtual bool Init() override;
@@ -48,6 +50,8 @@ namespace GfxRenderEngine
 
         virtual std::shared_ptr<Renderer> GetRenderer() const override { return m_Renderer; }
         virtual std::shared_ptr<Model> LoadModel(const Builder& builder) override;
+        virtual void BeginUploadBatch() override;
+        virtual void EndUploadBatch() override;
         virtual void ToggleDebugWindow(const GenericCallback& callback = nullptr) override { m_Renderer->ToggleDebugWindow(callback);}
 
         virtual uint GetContextWidth() const override { return m_Renderer->GetContextWidth(); }
@@ -58,6 +62,7 @@ namespace GfxRenderEngine
         bool m_Initialized;
 
         VK_Window* m_Window;
+        VkExtent2D m_OffscreenExtent;
         std::shared_ptr<VK_Renderer> m_Renderer;
 
         std::chrono::time_point<std::chrono::high_resolution_clock> m_StartTime;
@@ -0,0 +1,214 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <algorithm>
+
+#include "VKmodel.h"
+#include "VKframeInfo.h"
+#include "VKinstanceBuffer.h"
+
+namespace GfxRenderEngine
+{
+    VK_InstanceBuffer::VK_InstanceBuffer(VK_Device& device, const DescriptorSetFactory& createGlobalDescriptorSet)
+        : m_Device{device}, m_CreateGlobalDescriptorSet{createGlobalDescriptorSet},
+          m_CurrentBlock{0}, m_InstanceCount{0}, m_DrawCalls{0}
+    {
+        AddBlock();
+    }
+
+    void VK_InstanceBuffer::AddBlock()
+    {
+        auto block = std::make_unique<Block>();
+        block->m_Buffer = std::make_unique<VK_Buffer>
+        (
+            m_Device, sizeof(VK_InstanceData),
+            INSTANCES_PER_BLOCK,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        block->m_Buffer->Map();
+        VkDescriptorBufferInfo instanceBufferInfo = block->m_Buffer->DescriptorInfo();
+        block->m_GlobalDescriptorSet = m_CreateGlobalDescriptorSet(instanceBufferInfo);
+        block->m_Used = 0;
+        m_Blocks.push_back(std::move(block));
+        if (m_Blocks.size() > 1)
+        {
+            LOG_CORE_INFO("VK_InstanceBuffer: added block number {0} ({1} instances)", m_Blocks.size(), m_Blocks.size() * INSTANCES_PER_BLOCK);
+        }
+    }
+
+    // the blocks are kept for the following frames, the fence of this frame has been waited on
+    void VK_InstanceBuffer::Reset()
+    {
+        for (auto& block : m_Blocks)
+        {
+            block->m_Used = 0;
+        }
+        m_CurrentBlock = 0;
+        m_InstanceCount = 0;
+        m_DrawCalls = 0;
+    }
+
+    void VK_InstanceBuffer::Allocate(uint count, std::vector<Allocation>& allocations)
+    {
+        allocations.clear();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_InstanceCount.fetch_add(count, std::memory_order_relaxed);
+        while (count)
+        {
+            if (m_Blocks[m_CurrentBlock]->m_Used == INSTANCES_PER_BLOCK)
+            {
+                m_CurrentBlock++;
+                if (m_CurrentBlock == m_Blocks.size())
+                {
+                    AddBlock();
+                }
+            }
+            Block& block = *m_Blocks[m_CurrentBlock];
+            uint blockCount = std::min(count, INSTANCES_PER_BLOCK - block.m_Used);
+
+            Allocation allocation;
+            allocation.m_Data = static_cast<VK_InstanceData*>(block.m_Buffer->GetMappedMemory()) + block.m_Used;
+            allocation.m_FirstInstance = block.m_Used;
+            allocation.m_Count = blockCount;
+            allocation.m_GlobalDescriptorSet = block.m_GlobalDescriptorSet;
+            allocations.push_back(allocation);
+
+            block.m_Used += blockCount;
+            count -= blockCount;
+        }
+    }
+
+    void VK_InstanceBatch::Add(VK_Model* model, VkDescriptorSet materialDescriptorSet, const VK_InstanceData& instance)
+    {
+        m_Entries.push_back({model, materialDescriptorSet, static_cast<uint>(m_Instances.size())});
+        m_Instances.push_back(instance);
+    }
+
+    void VK_InstanceBatch::Draw(const VK_FrameInfo& frameInfo, VkPipelineLayout pipelineLayout)
+    {
+        uint count = static_cast<uint>(m_Entries.size());
+        if (count)
+        {
+            frameInfo.m_InstanceBuffer->Allocate(count, m_Allocations);
+
+            // material changes are more expensive than vertex buffer changes
+            std::sort(m_Entries.begin(), m_Entries.end(), [](const Entry& a, const Entry& b)
+            {
+                if (a.m_DescriptorSet != b.m_DescriptorSet) return a.m_DescriptorSet < b.m_DescriptorSet;
+                return a.m_Model < b.m_Model;
+            });
+
+            uint entry = 0;
+            for (auto& allocation : m_Allocations)
+            {
+                for (uint i = 0; i < allocation.m_Count; i++)
+                {
+                    allocation.m_Data[i] = m_Instances[m_Entries[entry++].m_Instance];
+                }
+            }
+
+            // a draw never crosses an allocation: each block has its own global descriptor set
+            VkDescriptorSet boundGlobalDescriptorSet = frameInfo.m_GlobalDescriptorSet;
+            VkDescriptorSet boundDescriptorSet = VK_NULL_HANDLE;
+            VK_Model* boundModel = nullptr;
+            uint allocationIndex = 0;
+            uint allocationBegin = 0;
+            uint begin = 0;
+            while (begin < count)
+            {
+                while (begin >= allocationBegin + m_Allocations[allocationIndex].m_Count)
+                {
+                    allocationBegin += m_Allocations[allocationIndex].m_Count;
+                    allocationIndex++;
+                }
+                const auto& allocation = m_Allocations[allocationIndex];
+                uint allocationEnd = allocationBegin + allocation.m_Count;
+
+                const Entry& entry = m_Entries[begin];
+                uint end = begin + 1;
+                while ((end < allocationEnd) && (m_Entries[end].m_Model == entry.m_Model) && (m_Entries[end].m_DescriptorSet == entry.m_DescriptorSet))
+                {
+                    end++;
+                }
+
+                if (allocation.m_GlobalDescriptorSet != boundGlobalDescriptorSet)
+                {
+                    vkCmdBindDescriptorSets
+                    (
+                        frameInfo.m_CommandBuffer,
+                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        pipelineLayout,
+                        0,
+                        1,
+                        &allocation.m_GlobalDescriptorSet,
+                        0,
+                        nullptr
+                    );
+                    boundGlobalDescriptorSet = allocation.m_GlobalDescriptorSet;
+                }
+                if ((entry.m_DescriptorSet != VK_NULL_HANDLE) && (entry.m_DescriptorSet != boundDescriptorSet))
+                {
+                    vkCmdBindDescriptorSets
+                    (
+                        frameInfo.m_CommandBuffer,
+                        VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        pipelineLayout,
+                        1,
+                        1,
+                        &entry.m_DescriptorSet,
+                        0,
+                        nullptr
+                    );
+                    boundDescriptorSet = entry.m_DescriptorSet;
+                }
+                if (entry.m_Model != boundModel)
+                {
+                    entry.m_Model->Bind(frameInfo.m_CommandBuffer);
+                    boundModel = entry.m_Model;
+                }
+                entry.m_Model->Draw(frameInfo.m_CommandBuffer, end - begin, allocation.m_FirstInstance + (begin - allocationBegin));
+                frameInfo.m_InstanceBuffer->AddDrawCalls(entry.m_Model->GetDrawCallCount());
+                begin = end;
+            }
+
+            // later draws of this render system expect the frame's global descriptor set
+            if (boundGlobalDescriptorSet != frameInfo.m_GlobalDescriptorSet)
+            {
+                vkCmdBindDescriptorSets
+                (
+                    frameInfo.m_CommandBuffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    pipelineLayout,
+                    0,
+                    1,
+                    &frameInfo.m_GlobalDescriptorSet,
+                    0,
+                    nullptr
+                );
+            }
+        }
+
+        m_Entries.clear();
+        m_Instances.clear();
+    }
+}
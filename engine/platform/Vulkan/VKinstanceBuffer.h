@@ -0,0 +1,144 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKdevice.h"
+#include "VKbuffer.h"
+
+namespace GfxRenderEngine
+{
+    class VK_Model;
+    struct VK_FrameInfo;
+
+    // per-instance data read by the PBR vertex shaders via gl_InstanceIndex
+    struct VK_InstanceData
+    {
+        glm::mat4 m_ModelMatrix{1.0f};
+        glm::mat4 m_NormalMatrix{1.0f}; // [3].x: roughness, [3].y: metallic, [3].z: normal map intensity
+                                        // [0..2].w: texture slots (bindless textures only)
+    };
+
+    // host-visible storage buffers for one frame in flight, bound to binding 3 of the global descriptor set;
+    // when a frame needs more instances than fit, another block with its own global descriptor set is added
+    class VK_InstanceBuffer
+    {
+
+    public:
+
+        static constexpr uint INSTANCES_PER_BLOCK = 32768;
+
+        // creates a global descriptor set that reads its instance data from the given buffer
+        using DescriptorSetFactory = std::function<VkDescriptorSet(VkDescriptorBufferInfo& instanceBufferInfo)>;
+
+        // a contiguous range of instances in one block
+        struct Allocation
+        {
+            VK_InstanceData* m_Data;
+            uint m_FirstInstance;
+            uint m_Count;
+            VkDescriptorSet m_GlobalDescriptorSet;
+        };
+
+    public:
+
+        VK_InstanceBuffer(VK_Device& device, const DescriptorSetFactory& createGlobalDescriptorSet);
+        ~VK_InstanceBuffer() {}
+
+        VK_InstanceBuffer(const VK_InstanceBuffer&) = delete;
+        VK_InstanceBuffer& operator=(const VK_InstanceBuffer&) = delete;
+
+        void Reset();
+        // thread-safe: render systems may record in parallel; count instances
+        // are split across blocks if necessary, allocations never fail
+        void Allocate(uint count, std::vector<Allocation>& allocations);
+        // the descriptor set of the first block, bound by the render systems
+        VkDescriptorSet GetGlobalDescriptorSet() const { return m_Blocks[0]->m_GlobalDescriptorSet; }
+        uint GetInstanceCount() const { return m_InstanceCount; }
+
+        // per-frame statistics
+        void AddDrawCalls(uint count) { m_DrawCalls.fetch_add(count, std::memory_order_relaxed); }
+        uint GetDrawCalls() const { return m_DrawCalls; }
+
+    private:
+
+        struct Block
+        {
+            std::unique_ptr<VK_Buffer> m_Buffer;
+            VkDescriptorSet m_GlobalDescriptorSet;
+            uint m_Used;
+        };
+
+    private:
+
+        void AddBlock();
+
+    private:
+
+        VK_Device& m_Device;
+        DescriptorSetFactory m_CreateGlobalDescriptorSet;
+
+        std::mutex m_Mutex;
+        std::vector<std::unique_ptr<Block>> m_Blocks;
+        uint m_CurrentBlock;
+        std::atomic<uint> m_InstanceCount;
+        std::atomic<uint> m_DrawCalls;
+
+    };
+
+    // collects the entities of one render system and draws them
+    // with one instanced draw call per (material, model) pair;
+    // entries without material descriptor set (bindless textures) are batched per model
+    class VK_InstanceBatch
+    {
+
+    public:
+
+        void Add(VK_Model* model, VkDescriptorSet materialDescriptorSet, const VK_InstanceData& instance);
+        void Draw(const VK_FrameInfo& frameInfo, VkPipelineLayout pipelineLayout);
+
+    private:
+
+        struct Entry
+        {
+            VK_Model* m_Model;
+            VkDescriptorSet m_DescriptorSet;
+            uint m_Instance;
+        };
+
+    private:
+
+        std::vector<Entry> m_Entries;
+        std::vector<VK_InstanceData> m_Instances;
+        std::vector<VK_InstanceBuffer::Allocation> m_Allocations;
+
+    };
+}
@@ -0,0 +1,94 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "auxiliary/hash.h"
+
+#include "VKmaterialCache.h"
+
+namespace GfxRenderEngine
+{
+    VK_MaterialCache::VK_MaterialCache(VK_DescriptorPool& descriptorPool)
+        : m_DescriptorPool{descriptorPool}, m_CacheHits{0}
+    {
+        for (uint layout = 0; layout < NUMBER_OF_LAYOUTS; layout++)
+        {
+            VK_DescriptorSetLayout::Builder builder{};
+            for (uint binding = 0; binding <= layout; binding++)
+            {
+                builder.AddBinding(binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS);
+            }
+            m_DescriptorSetLayouts[layout] = builder.Build();
+        }
+    }
+
+    size_t VK_MaterialCache::TextureSetHash::operator()(const std::vector<VK_Texture*>& textures) const
+    {
+        size_t seed = textures.size();
+        for (auto texture : textures)
+        {
+            HashCombine(seed, texture);
+        }
+        return seed;
+    }
+
+    VkDescriptorSet VK_MaterialCache::GetDescriptorSet(const std::vector<std::shared_ptr<VK_Texture>>& textures)
+    {
+        ASSERT(textures.size() && (textures.size() <= NUMBER_OF_LAYOUTS));
+
+        std::vector<VK_Texture*> key;
+        key.reserve(textures.size());
+        for (auto& texture : textures)
+        {
+            key.push_back(texture.get());
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto entry = m_DescriptorSets.find(key);
+        if (entry != m_DescriptorSets.end())
+        {
+            m_CacheHits++;
+            return entry->second.m_DescriptorSet;
+        }
+
+        auto& layout = *m_DescriptorSetLayouts[textures.size() - 1];
+        std::vector<VkDescriptorImageInfo> imageInfos(textures.size());
+        VK_DescriptorWriter writer(layout, m_DescriptorPool);
+        for (uint binding = 0; binding < textures.size(); binding++)
+        {
+            auto texture = textures[binding].get();
+            imageInfos[binding].sampler     = texture->m_Sampler;
+            imageInfos[binding].imageView   = texture->m_TextureView;
+            imageInfos[binding].imageLayout = texture->m_ImageLayout;
+            writer.WriteImage(binding, &imageInfos[binding]);
+        }
+
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        if (!writer.Build(descriptorSet))
+        {
+            LOG_CORE_CRITICAL("VK_MaterialCache: could not allocate material descriptor set");
+            return VK_NULL_HANDLE;
+        }
+        m_DescriptorSets[key] = {descriptorSet, textures};
+        return descriptorSet;
+    }
+}
@@ -0,0 +1,98 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKdescriptor.h"
+#include "VKtexture.h"
+
+namespace GfxRenderEngine
+{
+    // Material descriptor sets (set 1 of the PBR render systems), one per distinct texture set.
+    // Entities sharing the same textures share the descriptor set. The sets are never updated
+    // after creation, so one set serves all frames in flight.
+    // Material parameters (roughness, metallic, ...) are not part of the descriptor set,
+    // they travel per instance in m_NormalMatrix[3] of the instance buffer.
+    // Ownership: the cache owns its descriptor sets and keeps their textures alive until the
+    // renderer shuts down. Nothing is evicted, since scenes are not unloaded (GameState keeps
+    // all of them); unloading a scene would have to free its sets after its last frame in flight.
+    class VK_MaterialCache
+    {
+
+    public:
+
+        // number of texture maps, bound to bindings 0..n-1
+        enum Layout
+        {
+            ONE_MAP = 0,    // diffuse
+            TWO_MAPS,       // diffuse + normal or diffuse + roughness metallic
+            THREE_MAPS,     // diffuse + normal + roughness metallic
+            NUMBER_OF_LAYOUTS
+        };
+
+    public:
+
+        VK_MaterialCache(VK_DescriptorPool& descriptorPool);
+        ~VK_MaterialCache() {}
+
+        VK_MaterialCache(const VK_MaterialCache&) = delete;
+        VK_MaterialCache& operator=(const VK_MaterialCache&) = delete;
+
+        VK_DescriptorSetLayout& GetDescriptorSetLayout(Layout layout) { return *m_DescriptorSetLayouts[layout]; }
+        VkDescriptorSet GetDescriptorSet(const std::vector<std::shared_ptr<VK_Texture>>& textures);
+
+        size_t GetNumberOfDescriptorSets() const { return m_DescriptorSets.size(); }
+        uint64 GetCacheHits() const { return m_CacheHits; }
+
+    private:
+
+        struct TextureSetHash
+        {
+            size_t operator()(const std::vector<VK_Texture*>& textures) const;
+        };
+
+        struct Entry
+        {
+            VkDescriptorSet m_DescriptorSet;
+            // keeps the textures alive so that their addresses cannot be reused by other textures
+            std::vector<std::shared_ptr<VK_Texture>> m_Textures;
+        };
+
+    private:
+
+        VK_DescriptorPool& m_DescriptorPool;
+        std::unique_ptr<VK_DescriptorSetLayout> m_DescriptorSetLayouts[NUMBER_OF_LAYOUTS];
+
+        std::mutex m_Mutex;
+        std::unordered_map<std::vector<VK_Texture*>, Entry, TextureSetHash> m_DescriptorSets;
+        uint64 m_CacheHits;
+
+    };
+}
@@ -0,0 +1,353 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <algorithm>
+
+#include "VKmemoryAllocator.h"
+#include "VKdevice.h"
+
+namespace GfxRenderEngine
+{
+
+    static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    VK_MemoryAllocator::VK_MemoryAllocator(VK_Device& device)
+        : m_Device{device}
+    {
+        vkGetPhysicalDeviceMemoryProperties(m_Device.PhysicalDevice(), &m_MemoryProperties);
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_Device.PhysicalDevice(), &properties);
+        m_NonCoherentAtomSize = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+
+        m_Pools.resize(m_MemoryProperties.memoryTypeCount * 2);
+    }
+
+    VK_MemoryAllocator::~VK_MemoryAllocator()
+    {
+        LogStatistics();
+        for (auto& pool : m_Pools)
+        {
+            for (auto& block : pool)
+            {
+                if (block->m_AllocationCount)
+                {
+                    LOG_CORE_WARN("VK_MemoryAllocator: {0} allocation(s) still alive at shutdown", block->m_AllocationCount);
+                }
+                DestroyBlock(block.get());
+            }
+        }
+    }
+
+    VkDeviceSize VK_MemoryAllocator::GetBlockSize(uint memoryTypeIndex) const
+    {
+        // small heaps, e.g. 256 MB of host-visible device-local memory, get smaller blocks
+        uint heapIndex = m_MemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+        VkDeviceSize heapSize = m_MemoryProperties.memoryHeaps[heapIndex].size;
+        return std::min(DEFAULT_BLOCK_SIZE, heapSize / 8);
+    }
+
+    VK_MemoryAllocator::Block* VK_MemoryAllocator::CreateBlock(uint memoryTypeIndex, VkDeviceSize size, bool dedicated)
+    {
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+        auto block = std::make_unique<Block>();
+        if (vkAllocateMemory(m_Device.Device(), &allocInfo, nullptr, &block->m_Memory) != VK_SUCCESS)
+        {
+            return nullptr;
+        }
+
+        block->m_Size = size;
+        block->m_Dedicated = dedicated;
+        block->m_FreeRanges[0] = size;
+
+        if (m_MemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            // a VkDeviceMemory can only be mapped once, so host-visible blocks stay mapped
+            if (vkMapMemory(m_Device.Device(), block->m_Memory, 0, VK_WHOLE_SIZE, 0, &block->m_Mapped) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("VK_MemoryAllocator: failed to map memory block!");
+            }
+        }
+
+        return block.release();
+    }
+
+    void VK_MemoryAllocator::DestroyBlock(Block* block)
+    {
+        if (block->m_Mapped)
+        {
+            vkUnmapMemory(m_Device.Device(), block->m_Memory);
+        }
+        vkFreeMemory(m_Device.Device(), block->m_Memory, nullptr);
+        block->m_Memory = VK_NULL_HANDLE;
+    }
+
+    bool VK_MemoryAllocator::AllocateFromBlock(Block* block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+    {
+        // best fit: the smallest free range that can hold the aligned allocation
+        auto bestRange = block->m_FreeRanges.end();
+        for (auto range = block->m_FreeRanges.begin(); range != block->m_FreeRanges.end(); ++range)
+        {
+            VkDeviceSize alignedOffset = AlignUp(range->first, alignment);
+            if (alignedOffset + size > range->first + range->second)
+            {
+                continue;
+            }
+            if ((bestRange == block->m_FreeRanges.end()) || (range->second < bestRange->second))
+            {
+                bestRange = range;
+            }
+        }
+
+        if (bestRange == block->m_FreeRanges.end())
+        {
+            return false;
+        }
+
+        VkDeviceSize rangeOffset = bestRange->first;
+        VkDeviceSize rangeEnd = bestRange->first + bestRange->second;
+        offset = AlignUp(rangeOffset, alignment);
+        block->m_FreeRanges.erase(bestRange);
+
+        // keep the alignment padding and the tail as free ranges
+        if (offset > rangeOffset)
+        {
+            block->m_FreeRanges[rangeOffset] = offset - rangeOffset;
+        }
+        if (offset + size < rangeEnd)
+        {
+            block->m_FreeRanges[offset + size] = rangeEnd - (offset + size);
+        }
+
+        block->m_AllocationCount++;
+        block->m_BytesInUse += size;
+        return true;
+    }
+
+    void VK_MemoryAllocator::FreeInBlock(Block* block, VkDeviceSize offset, VkDeviceSize size)
+    {
+        auto inserted = block->m_FreeRanges.emplace(offset, size).first;
+
+        // merge with the next range
+        auto next = std::next(inserted);
+        if ((next != block->m_FreeRanges.end()) && (inserted->first + inserted->second == next->first))
+        {
+            inserted->second += next->second;
+            block->m_FreeRanges.erase(next);
+        }
+
+        // merge with the previous range
+        if (inserted != block->m_FreeRanges.begin())
+        {
+            auto previous = std::prev(inserted);
+            if (previous->first + previous->second == inserted->first)
+            {
+                previous->second += inserted->second;
+                block->m_FreeRanges.erase(inserted);
+            }
+        }
+
+        block->m_AllocationCount--;
+        block->m_BytesInUse -= size;
+    }
+
+    bool VK_MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear, VK_Allocation& allocation)
+    {
+        uint memoryTypeIndex = m_Device.FindMemoryType(requirements.memoryTypeBits, properties);
+        VkMemoryPropertyFlags memoryFlags = m_MemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+
+        VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+        VkDeviceSize size = requirements.size;
+        bool nonCoherent = (memoryFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(memoryFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        if (nonCoherent)
+        {
+            // flushed ranges must not touch neighboring allocations
+            alignment = std::max(alignment, m_NonCoherentAtomSize);
+            size = AlignUp(size, m_NonCoherentAtomSize);
+        }
+
+        uint poolIndex = memoryTypeIndex * 2 + (linear ? 0 : 1);
+        VkDeviceSize blockSize = GetBlockSize(memoryTypeIndex);
+
+        std::lock_guard lock(m_Mutex);
+        auto& pool = m_Pools[poolIndex];
+
+        Block* block = nullptr;
+        VkDeviceSize offset = 0;
+
+        if (size > blockSize / 2)
+        {
+            // large resources get their own memory
+            block = CreateBlock(memoryTypeIndex, size, true);
+            if (!block || !AllocateFromBlock(block, size, alignment, offset))
+            {
+                LOG_CORE_CRITICAL("VK_MemoryAllocator: failed to allocate {0} bytes of dedicated memory!", size);
+                return false;
+            }
+            pool.emplace_back(block);
+        }
+        else
+        {
+            for (auto& poolBlock : pool)
+            {
+                if (!poolBlock->m_Dedicated && AllocateFromBlock(poolBlock.get(), size, alignment, offset))
+                {
+                    block = poolBlock.get();
+                    break;
+                }
+            }
+            if (!block)
+            {
+                block = CreateBlock(memoryTypeIndex, blockSize, false);
+                if (!block || !AllocateFromBlock(block, size, alignment, offset))
+                {
+                    LOG_CORE_CRITICAL("VK_MemoryAllocator: failed to allocate a memory block of {0} bytes!", blockSize);
+                    return false;
+                }
+                pool.emplace_back(block);
+            }
+        }
+
+        allocation.m_Memory = block->m_Memory;
+        allocation.m_Offset = offset;
+        allocation.m_Size   = size;
+        allocation.m_Mapped = block->m_Mapped ? static_cast<char*>(block->m_Mapped) + offset : nullptr;
+        allocation.m_Block  = block;
+        allocation.m_Pool   = poolIndex;
+        return true;
+    }
+
+    void VK_MemoryAllocator::Free(VK_Allocation& allocation)
+    {
+        if (!allocation.m_Block)
+        {
+            return;
+        }
+
+        std::lock_guard lock(m_Mutex);
+        auto block = static_cast<Block*>(allocation.m_Block);
+        FreeInBlock(block, allocation.m_Offset, allocation.m_Size);
+
+        if (!block->m_AllocationCount)
+        {
+            // release dedicated memory right away, keep one empty block per pool for reuse
+            auto& pool = m_Pools[allocation.m_Pool];
+            uint emptyBlocks = std::count_if(pool.begin(), pool.end(), [](auto& poolBlock)
+                { return !poolBlock->m_Dedicated && !poolBlock->m_AllocationCount; });
+            if (block->m_Dedicated || (emptyBlocks > 1))
+            {
+                auto iterator = std::find_if(pool.begin(), pool.end(), [block](auto& poolBlock) { return poolBlock.get() == block; });
+                DestroyBlock(block);
+                pool.erase(iterator);
+            }
+        }
+
+        allocation = VK_Allocation{};
+    }
+
+    VkMappedMemoryRange VK_MemoryAllocator::GetMappedRange(const VK_Allocation& allocation, VkDeviceSize size, VkDeviceSize offset) const
+    {
+        auto block = static_cast<Block*>(allocation.m_Block);
+        if (size == VK_WHOLE_SIZE)
+        {
+            size = allocation.m_Size - offset;
+        }
+
+        VkDeviceSize begin = (allocation.m_Offset + offset) / m_NonCoherentAtomSize * m_NonCoherentAtomSize;
+        VkDeviceSize end = std::min(AlignUp(allocation.m_Offset + offset + size, m_NonCoherentAtomSize), block->m_Size);
+
+        VkMappedMemoryRange mappedRange = {};
+        mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        mappedRange.memory = allocation.m_Memory;
+        mappedRange.offset = begin;
+        mappedRange.size = end - begin;
+        return mappedRange;
+    }
+
+    VkResult VK_MemoryAllocator::Flush(const VK_Allocation& allocation, VkDeviceSize size, VkDeviceSize offset)
+    {
+        auto mappedRange = GetMappedRange(allocation, size, offset);
+        return vkFlushMappedMemoryRanges(m_Device.Device(), 1, &mappedRange);
+    }
+
+    VkResult VK_MemoryAllocator::Invalidate(const VK_Allocation& allocation, VkDeviceSize size, VkDeviceSize offset)
+    {
+        auto mappedRange = GetMappedRange(allocation, size, offset);
+        return vkInvalidateMappedMemoryRanges(m_Device.Device(), 1, &mappedRange);
+    }
+
+    VK_MemoryAllocator::Statistics VK_MemoryAllocator::GetStatistics()
+    {
+        Statistics statistics{};
+        VkDeviceSize freeBytes = 0;
+        VkDeviceSize largestFreeRangeSum = 0;
+
+        std::lock_guard lock(m_Mutex);
+        for (auto& pool : m_Pools)
+        {
+            for (auto& block : pool)
+            {
+                statistics.m_BlockCount++;
+                statistics.m_DedicatedBlockCount += block->m_Dedicated ? 1 : 0;
+                statistics.m_AllocationCount += block->m_AllocationCount;
+                statistics.m_BytesAllocated += block->m_Size;
+                statistics.m_BytesInUse += block->m_BytesInUse;
+                statistics.m_FreeRangeCount += block->m_FreeRanges.size();
+
+                VkDeviceSize largestInBlock = 0;
+                for (auto& range : block->m_FreeRanges)
+                {
+                    freeBytes += range.second;
+                    largestInBlock = std::max(largestInBlock, range.second);
+                }
+                largestFreeRangeSum += largestInBlock;
+                statistics.m_LargestFreeRange = std::max(statistics.m_LargestFreeRange, largestInBlock);
+            }
+        }
+
+        if (freeBytes)
+        {
+            statistics.m_Fragmentation = 1.0f - static_cast<float>(largestFreeRangeSum) / static_cast<float>(freeBytes);
+        }
+        return statistics;
+    }
+
+    void VK_MemoryAllocator::LogStatistics()
+    {
+        auto statistics = GetStatistics();
+        LOG_CORE_INFO("device memory: {0} allocations, {1} MB in use, {2} MB in {3} blocks ({4} dedicated), {5} free ranges, fragmentation {6:.1f}%",
+            statistics.m_AllocationCount,
+            statistics.m_BytesInUse / (1024 * 1024),
+            statistics.m_BytesAllocated / (1024 * 1024),
+            statistics.m_BlockCount,
+            statistics.m_DedicatedBlockCount,
+            statistics.m_FreeRangeCount,
+            statistics.m_Fragmentation * 100.0f);
+    }
+}
@@ -0,0 +1,120 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    class VK_Device;
+
+    struct VK_Allocation
+    {
+        VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+        VkDeviceSize m_Offset = 0;
+        VkDeviceSize m_Size = 0;
+        void* m_Mapped = nullptr; // persistently mapped, host-visible memory only
+        void* m_Block = nullptr;
+        uint m_Pool = 0;
+    };
+
+    // Sub-allocates buffers and images from large VkDeviceMemory blocks.
+    // There is one pool of blocks per memory type and resource kind: linear resources (buffers)
+    // and optimal-tiling images never share a block, which satisfies bufferImageGranularity.
+    // Inside a block, free ranges are kept sorted by offset and allocations are best-fit,
+    // freed ranges are merged with their neighbors.
+    class VK_MemoryAllocator
+    {
+
+    public:
+
+        static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+
+        struct Statistics
+        {
+            uint m_BlockCount = 0;
+            uint m_DedicatedBlockCount = 0;
+            uint m_AllocationCount = 0;
+            VkDeviceSize m_BytesAllocated = 0; // device memory owned by the allocator
+            VkDeviceSize m_BytesInUse = 0;     // device memory handed out to resources
+            uint m_FreeRangeCount = 0;
+            VkDeviceSize m_LargestFreeRange = 0;
+            // 0.0: all free memory is in one range per block, 1.0: free memory is scattered
+            float m_Fragmentation = 0.0f;
+        };
+
+    public:
+
+        VK_MemoryAllocator(VK_Device& device);
+        ~VK_MemoryAllocator();
+
+        VK_MemoryAllocator(const VK_MemoryAllocator&) = delete;
+        VK_MemoryAllocator& operator=(const VK_MemoryAllocator&) = delete;
+
+        bool Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear, VK_Allocation& allocation);
+        void Free(VK_Allocation& allocation);
+
+        VkResult Flush(const VK_Allocation& allocation, VkDeviceSize size, VkDeviceSize offset);
+        VkResult Invalidate(const VK_Allocation& allocation, VkDeviceSize size, VkDeviceSize offset);
+
+        Statistics GetStatistics();
+        void LogStatistics();
+
+    private:
+
+        struct Block
+        {
+            VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+            VkDeviceSize m_Size = 0;
+            void* m_Mapped = nullptr;
+            bool m_Dedicated = false;
+            uint m_AllocationCount = 0;
+            VkDeviceSize m_BytesInUse = 0;
+            std::map<VkDeviceSize, VkDeviceSize> m_FreeRanges; // offset -> size
+        };
+
+        Block* CreateBlock(uint memoryTypeIndex, VkDeviceSize size, bool dedicated);
+        void DestroyBlock(Block* block);
+        bool AllocateFromBlock(Block* block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+        void FreeInBlock(Block* block, VkDeviceSize offset, VkDeviceSize size);
+        VkMappedMemoryRange GetMappedRange(const VK_Allocation& allocation, VkDeviceSize size, VkDeviceSize offset) const;
+        VkDeviceSize GetBlockSize(uint memoryTypeIndex) const;
+
+    private:
+
+        VK_Device& m_Device;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties;
+        VkDeviceSize m_NonCoherentAtomSize;
+
+        // index: memoryTypeIndex * 2 + (linear ? 0 : 1)
+        std::vector<std::vector<std::unique_ptr<Block>>> m_Pools;
+        std::mutex m_Mutex;
+
+    };
+}
@@ -58,13 +58,94 @@ namespace GfxRenderEngine
     }
 
     // VK_Model
-    VK_Model::VK_Model(std::shared_ptr<VK_Device> device, const Builder& builder)
-        : m_Device(device), m_HasIndexBuffer{false}
+    VK_Model::VK_Model(std::shared_ptr<VK_Device> device, const Builder& builder, bool streamed)
+        : m_Device(device), m_HasIndexBuffer{false}, m_Resident{!streamed}
     {
         m_ImagesInternal = m_Images;
         m_Primitives = builder.m_Primitives; 
-        CreateVertexBuffers(builder.m_Vertices);
-        CreateIndexBuffers(builder.m_Indices);
+        m_AABB = builder.m_AABB;
+        m_BoundingSphere = builder.m_BoundingSphere;
+        if (!streamed)
+        {
+            CreateVertexBuffers(builder.m_Vertices);
+            CreateIndexBuffers(builder.m_Indices);
+            return;
+        }
+
+        m_VertexCount = static_cast<uint>(builder.m_Vertices.size());
+        ASSERT(m_VertexCount >= 3); // at least one triangle
+        m_VertexBuffer = CreateBuffer(sizeof(Vertex), m_VertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        m_IndexCount = static_cast<uint>(builder.m_Indices.size());
+        m_HasIndexBuffer = (m_IndexCount > 0);
+        if (m_HasIndexBuffer)
+        {
+            m_IndexBuffer = CreateBuffer(sizeof(uint), m_IndexCount, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+        }
+        CreatePlaceholder();
+    }
+
+    std::unique_ptr<VK_Buffer> VK_Model::CreateBuffer(uint elementSize, uint elementCount, VkBufferUsageFlags usage)
+    {
+        return std::make_unique<VK_Buffer>
+        (
+            *m_Device, elementSize, elementCount,
+            usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+    }
+
+    // the bounding box, drawn while the model is streamed; small enough for host-visible memory
+    void VK_Model::CreatePlaceholder()
+    {
+        static constexpr int FACES[6][4] =
+        {
+            {1, 5, 7, 3}, {4, 0, 2, 6}, // +x, -x
+            {2, 3, 7, 6}, {4, 5, 1, 0}, // +y, -y
+            {4, 6, 7, 5}, {0, 1, 3, 2}  // +z, -z
+        };
+        static const glm::vec3 NORMALS[6] =
+        {
+            { 1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
+            { 0.0f, 1.0f, 0.0f}, { 0.0f,-1.0f, 0.0f},
+            { 0.0f, 0.0f, 1.0f}, { 0.0f, 0.0f,-1.0f}
+        };
+
+        // corner i has x from bit 0, y from bit 1, z from bit 2
+        auto corner = [&](int i)
+        {
+            return glm::vec3
+            (
+                (i & 1) ? m_AABB.m_Max.x : m_AABB.m_Min.x,
+                (i & 2) ? m_AABB.m_Max.y : m_AABB.m_Min.y,
+                (i & 4) ? m_AABB.m_Max.z : m_AABB.m_Min.z
+            );
+        };
+
+        std::vector<Vertex> vertices;
+        vertices.reserve(PLACEHOLDER_VERTEX_COUNT);
+        for (uint face = 0; face < 6; face++)
+        {
+            for (int index : {0, 1, 2, 0, 2, 3})
+            {
+                Vertex vertex{};
+                vertex.m_Position = corner(FACES[face][index]);
+                vertex.m_Color = glm::vec3(0.5f);
+                vertex.m_Normal = NORMALS[face];
+                vertex.m_DiffuseMapTextureSlot = Vertex::NO_TEXTURE;
+                vertex.m_Amplification = 1.0f;
+                vertices.push_back(vertex);
+            }
+        }
+
+        m_PlaceholderBuffer = std::make_unique<VK_Buffer>
+        (
+            *m_Device, sizeof(Vertex), PLACEHOLDER_VERTEX_COUNT,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        m_PlaceholderBuffer->Map();
+        m_PlaceholderBuffer->WriteToBuffer((void*) vertices.data());
+        m_PlaceholderBuffer->Unmap();
     }
 
     void VK_Model::CreateVertexBuffers(const std::vector<Vertex>& vertices)
@@ -74,14 +155,14 @@ namespace GfxRenderEngine
         VkDeviceSize bufferSize = sizeof(Vertex) * m_VertexCount;
         uint vertexSize = sizeof(vertices[0]);
 
-        VK_Buffer stagingBuffer
-        {
+        auto stagingBuffer = std::make_unique<VK_Buffer>
+        (
             *m_Device, vertexSize, m_VertexCount,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        };
-        stagingBuffer.Map();
-        stagingBuffer.WriteToBuffer((void*) vertices.data());
+        );
+        stagingBuffer->Map();
+        stagingBuffer->WriteToBuffer((void*) vertices.data());
 
         m_VertexBuffer = std::make_unique<VK_Buffer>
         (
@@ -90,7 +171,8 @@ namespace GfxRenderEngine
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
         );
 
-        m_Device->CopyBuffer(stagingBuffer.GetBuffer(), m_VertexBuffer->GetBuffer(), bufferSize);
+        m_Device->CopyBuffer(stagingBuffer->GetBuffer(), m_VertexBuffer->GetBuffer(), bufferSize);
+        m_Device->ReleaseAfterUpload(std::move(stagingBuffer));
     }
 
     void VK_Model::CreateIndexBuffers(const std::vector<uint>& indices)
@@ -105,14 +187,14 @@ namespace GfxRenderEngine
             return;
         }
 
-        VK_Buffer stagingBuffer
-        {
+        auto stagingBuffer = std::make_unique<VK_Buffer>
+        (
             *m_Device, indexSize, m_IndexCount,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        };
-        stagingBuffer.Map();
-        stagingBuffer.WriteToBuffer((void*) indices.data());
+        );
+        stagingBuffer->Map();
+        stagingBuffer->WriteToBuffer((void*) indices.data());
 
         m_IndexBuffer = std::make_unique<VK_Buffer>
         (
@@ -120,12 +202,20 @@ namespace GfxRenderEngine
             VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
         );
-        m_Device->CopyBuffer(stagingBuffer.GetBuffer(), m_IndexBuffer->GetBuffer(), bufferSize);
-
+        m_Device->CopyBuffer(stagingBuffer->GetBuffer(), m_IndexBuffer->GetBuffer(), bufferSize);
+        m_Device->ReleaseAfterUpload(std::move(stagingBuffer));
     }
 
     void VK_Model::Bind(VkCommandBuffer commandBuffer)
     {
+        if (!m_Resident)
+        {
+            VkBuffer buffers[] = {m_PlaceholderBuffer->GetBuffer()};
+            VkDeviceSize offsets[] = {0};
+            vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+            return;
+        }
+
         VkBuffer buffers[] = {m_VertexBuffer->GetBuffer()};
         VkDeviceSize offsets[] = {0};
         vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
@@ -136,8 +226,14 @@ namespace GfxRenderEngine
         }
     }
 
-    void VK_Model::Draw(VkCommandBuffer commandBuffer)
+    void VK_Model::Draw(VkCommandBuffer commandBuffer, uint instanceCount, uint firstInstance)
     {
+        if (!m_Resident)
+        {
+            vkCmdDraw(commandBuffer, PLACEHOLDER_VERTEX_COUNT, instanceCount, 0, firstInstance);
+            return;
+        }
+
         if (m_Primitives.size())
         {
             uint vertexOffset = 0;
@@ -151,10 +247,10 @@ namespace GfxRenderEngine
                     (
                         commandBuffer,           // VkCommandBuffer commandBuffer
                         primitive.m_IndexCount,  // uint32_t        indexCount
-                        1,                       // uint32_t        instanceCount
+                        instanceCount,           // uint32_t        instanceCount
                         indexOffset,             // uint32_t        firstIndex
                         vertexOffset,            // int32_t         vertexOffset
-                        0                        // uint32_t        firstInstance
+                        firstInstance            // uint32_t        firstInstance
                     );
                 }
 
@@ -164,9 +260,9 @@ namespace GfxRenderEngine
                     (
                         commandBuffer,           // VkCommandBuffer commandBuffer
                         primitive.m_VertexCount,   // uint32_t        vertexCount
-                        1,                       // uint32_t        instanceCount
+                        instanceCount,           // uint32_t        instanceCount
                         0,                       // uint32_t        firstVertex
-                        0                        // uint32_t        firstInstance
+                        firstInstance            // uint32_t        firstInstance
                     );
                 }
 
@@ -183,10 +279,10 @@ namespace GfxRenderEngine
                 (
                     commandBuffer,      // VkCommandBuffer commandBuffer
                     m_IndexCount,       // uint32_t        indexCount
-                    1,                  // uint32_t        instanceCount
+                    instanceCount,      // uint32_t        instanceCount
                     0,                  // uint32_t        firstIndex
                     0,                  // int32_t         vertexOffset
-                    0                   // uint32_t        firstInstance
+                    firstInstance       // uint32_t        firstInstance
                 );
             }
             else
@@ -195,67 +291,42 @@ namespace GfxRenderEngine
                 (
                     commandBuffer,      // VkCommandBuffer commandBuffer
                     m_VertexCount,      // uint32_t        vertexCount
-                    1,                  // uint32_t        instanceCount
+                    instanceCount,      // uint32_t        instanceCount
                     0,                  // uint32_t        firstVertex
-                    0                   // uint32_t        firstInstance
+                    firstInstance       // uint32_t        firstInstance
                 );
             }
         }
     }
 
+    // per-material descriptor set, not needed if the textures are accessed through the texture table
+    static VkDescriptorSet GetMaterialDescriptorSet(const std::vector<std::shared_ptr<VK_Texture>>& textures)
+    {
+        return VK_Renderer::m_TextureTable ? VK_NULL_HANDLE : VK_Renderer::m_MaterialCache->GetDescriptorSet(textures);
+    }
+
     PbrDiffuseComponent VK_Model::CreateDescriptorSet(const std::shared_ptr<VK_Texture>& colorMap)
     {
         PbrDiffuseComponent pbrDiffuseComponent{};
-        std::unique_ptr<VK_DescriptorSetLayout> localDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
-                    .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                    .Build();
-
-        auto texture = colorMap.get();
-        VkDescriptorImageInfo imageInfo {};
-        imageInfo.sampler     = texture->m_Sampler;
-        imageInfo.imageView   = texture->m_TextureView;
-        imageInfo.imageLayout = texture->m_ImageLayout;
-
+        auto descriptorSet = GetMaterialDescriptorSet({colorMap});
         for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
         {
-            VK_DescriptorWriter(*localDescriptorSetLayout, *VK_Renderer::m_DescriptorPool)
-                .WriteImage(0, &imageInfo)
-                .Build(pbrDiffuseComponent.m_DescriptorSet[i]);
+            pbrDiffuseComponent.m_DescriptorSet[i] = descriptorSet;
         }
+        pbrDiffuseComponent.m_DiffuseMapSlot = colorMap->GetTextureSlot();
         return pbrDiffuseComponent;
     }
 
     PbrDiffuseNormalComponent VK_Model::CreateDescriptorSet(const std::shared_ptr<VK_Texture>& colorMap, const std::shared_ptr<VK_Texture>& normalMap)
     {
         PbrDiffuseNormalComponent pbrDiffuseNormalComponent{};
-        std::unique_ptr<VK_DescriptorSetLayout> localDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
-                    .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                    .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                    .Build();
-
-        VkDescriptorImageInfo imageInfo0 {};
-        {
-            auto texture = colorMap.get();
-            imageInfo0.sampler     = texture->m_Sampler;
-            imageInfo0.imageView   = texture->m_TextureView;
-            imageInfo0.imageLayout = texture->m_ImageLayout;
-        }
-
-        VkDescriptorImageInfo imageInfo1 {};
-        {
-            auto texture = normalMap.get();
-            imageInfo1.sampler     = texture->m_Sampler;
-            imageInfo1.imageView   = texture->m_TextureView;
-            imageInfo1.imageLayout = texture->m_ImageLayout;
-        }
-
+        auto descriptorSet = GetMaterialDescriptorSet({colorMap, normalMap});
         for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
         {
-            VK_DescriptorWriter(*localDescriptorSetLayout, *VK_Renderer::m_DescriptorPool)
-                .WriteImage(0, &imageInfo0)
-                .WriteImage(1, &imageInfo1)
-                .Build(pbrDiffuseNormalComponent.m_DescriptorSet[i]);
+            pbrDiffuseNormalComponent.m_DescriptorSet[i] = descriptorSet;
         }
+        pbrDiffuseNormalComponent.m_DiffuseMapSlot = colorMap->GetTextureSlot();
+        pbrDiffuseNormalComponent.m_NormalMapSlot  = normalMap->GetTextureSlot();
         return pbrDiffuseNormalComponent;
     }
 
@@ -266,81 +337,29 @@ namespace GfxRenderEngine
         const std::shared_ptr<VK_Texture>& roughnessMetallicMap)
     {
         PbrDiffuseNormalRoughnessMetallicComponent pbrDiffuseNormalRoughnessMetallicComponent{};
-        std::unique_ptr<VK_DescriptorSetLayout> localDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
-                    .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                    .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                    .AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                    .Build();
-
-        VkDescriptorImageInfo imageInfo0 {};
-        {
-            auto texture = colorMap.get();
-            imageInfo0.sampler     = texture->m_Sampler;
-            imageInfo0.imageView   = texture->m_TextureView;
-            imageInfo0.imageLayout = texture->m_ImageLayout;
-        }
-
-        VkDescriptorImageInfo imageInfo1 {};
-        {
-            auto texture = normalMap.get();
-            imageInfo1.sampler     = texture->m_Sampler;
-            imageInfo1.imageView   = texture->m_TextureView;
-            imageInfo1.imageLayout = texture->m_ImageLayout;
-        }
-
-        VkDescriptorImageInfo imageInfo2 {};
-        {
-            auto texture = roughnessMetallicMap.get();
-            imageInfo2.sampler     = texture->m_Sampler;
-            imageInfo2.imageView   = texture->m_TextureView;
-            imageInfo2.imageLayout = texture->m_ImageLayout;
-        }
-
+        auto descriptorSet = GetMaterialDescriptorSet({colorMap, normalMap, roughnessMetallicMap});
         for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
         {
-            VK_DescriptorWriter(*localDescriptorSetLayout, *VK_Renderer::m_DescriptorPool)
-                .WriteImage(0, &imageInfo0)
-                .WriteImage(1, &imageInfo1)
-                .WriteImage(2, &imageInfo2)
-                .Build(pbrDiffuseNormalRoughnessMetallicComponent.m_DescriptorSet[i]);
+            pbrDiffuseNormalRoughnessMetallicComponent.m_DescriptorSet[i] = descriptorSet;
         }
+        pbrDiffuseNormalRoughnessMetallicComponent.m_DiffuseMapSlot           = colorMap->GetTextureSlot();
+        pbrDiffuseNormalRoughnessMetallicComponent.m_NormalMapSlot            = normalMap->GetTextureSlot();
+        pbrDiffuseNormalRoughnessMetallicComponent.m_RoughnessMetallicMapSlot = roughnessMetallicMap->GetTextureSlot();
         return pbrDiffuseNormalRoughnessMetallicComponent;
     }
 
-
     void VK_Model::CreateDescriptorSet
     (
         const std::shared_ptr<VK_Texture>& colorMap,
         const std::shared_ptr<VK_Texture>& roughnessMetallicMap,
         PbrDiffuseRoughnessMetallicComponent& pbrDiffuseRoughnessMetallicComponent)
     {
-        std::unique_ptr<VK_DescriptorSetLayout> localDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
-                    .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                    .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS)
-                    .Build();
-
-        VkDescriptorImageInfo imageInfo0 {};
-        {
-            auto texture = colorMap.get();
-            imageInfo0.sampler     = texture->m_Sampler;
-            imageInfo0.imageView   = texture->m_TextureView;
-            imageInfo0.imageLayout = texture->m_ImageLayout;
-        }
-
-        VkDescriptorImageInfo imageInfo1 {};
-        {
-            auto texture = roughnessMetallicMap.get();
-            imageInfo1.sampler     = texture->m_Sampler;
-            imageInfo1.imageView   = texture->m_TextureView;
-            imageInfo1.imageLayout = texture->m_ImageLayout;
-        }
-
+        auto descriptorSet = GetMaterialDescriptorSet({colorMap, roughnessMetallicMap});
         for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
         {
-            VK_DescriptorWriter(*localDescriptorSetLayout, *VK_Renderer::m_DescriptorPool)
-                .WriteImage(0, &imageInfo0)
-                .WriteImage(1, &imageInfo1)
-                .Build(pbrDiffuseRoughnessMetallicComponent.m_DescriptorSet[i]);
+            pbrDiffuseRoughnessMetallicComponent.m_DescriptorSet[i] = descriptorSet;
         }
+        pbrDiffuseRoughnessMetallicComponent.m_DiffuseMapSlot           = colorMap->GetTextureSlot();
+        pbrDiffuseRoughnessMetallicComponent.m_RoughnessMetallicMapSlot = roughnessMetallicMap->GetTextureSlot();
     }
 }
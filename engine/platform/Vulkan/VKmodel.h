@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -51,7 +52,9 @@ namespace GfxRenderEngine
 
     public:
 
-        VK_Model(std::shared_ptr<VK_Device> device, const Builder& builder);
+        // a streamed model only allocates its buffers, VK_ResourceStreamer uploads them;
+        // until then the model draws its bounding box
+        VK_Model(std::shared_ptr<VK_Device> device, const Builder& builder, bool streamed = false);
         ~VK_Model() override {}
 
         VK_Model(const VK_Model&) = delete;
@@ -61,7 +64,9 @@ namespace GfxRenderEngine
         void CreateIndexBuffers(const std::vector<uint>& indices) override;
 
         void Bind(VkCommandBuffer commandBuffer);
-        void Draw(VkCommandBuffer commandBuffer);
+        void Draw(VkCommandBuffer commandBuffer, uint instanceCount = 1, uint firstInstance = 0);
+        uint GetDrawCallCount() const { return (m_Primitives.size() && m_Resident) ? static_cast<uint>(m_Primitives.size()) : 1; }
+        bool IsResident() const { return m_Resident; }
 
     public:
 
@@ -93,6 +98,16 @@ namespace GfxRenderEngine
 
     private:
 
+        static constexpr uint PLACEHOLDER_VERTEX_COUNT = 36; // 6 faces, 2 triangles each
+
+        std::unique_ptr<VK_Buffer> CreateBuffer(uint elementSize, uint elementCount, VkBufferUsageFlags usage);
+        void CreatePlaceholder();
+
+    private:
+
+        // uploads streamed models and sets m_Resident
+        friend class VK_ResourceStreamer;
+
         std::vector<std::shared_ptr<VK_Texture>> m_ImagesInternal;
         std::shared_ptr<VK_Device> m_Device;
 
@@ -105,5 +120,9 @@ namespace GfxRenderEngine
 
         std::vector<Primitive> m_Primitives{};
 
+        // kept for the lifetime of the model, frames in flight may still draw it
+        std::unique_ptr<VK_Buffer> m_PlaceholderBuffer;
+        std::atomic<bool> m_Resident;
+
     };
 }
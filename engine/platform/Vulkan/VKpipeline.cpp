@@ -135,7 +135,7 @@ namespace GfxRenderEngine
 
         if (vkCreateGraphicsPipelines(
             m_Device->Device(),
-            VK_NULL_HANDLE,
+            m_Device->GetPipelineCache(),
             1,
             &pipelineInfo,
             nullptr,
@@ -0,0 +1,154 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <vector>
+#include <cstring>
+#include <fstream>
+
+#include "engine.h"
+#include "auxiliary/file.h"
+#include "auxiliary/hash.h"
+#include "auxiliary/mappedFile.h"
+
+#include "VKdevice.h"
+#include "VKpipelineCache.h"
+
+namespace GfxRenderEngine
+{
+    VK_PipelineCache::VK_PipelineCache(VK_Device& device)
+        : m_Device{device}, m_PipelineCache{VK_NULL_HANDLE}
+    {
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+        // initial data from the previous run, if it was written by this device and driver
+        MappedFile file(CACHE_FILEPATH);
+        if (file.IsValid() && (file.Size() >= sizeof(Header)))
+        {
+            Header expected{};
+            FillHeader(expected);
+
+            Header header;
+            memcpy(&header, file.Data(), sizeof(Header));
+            const uchar* data = file.Data() + sizeof(Header);
+
+            bool valid = (header.m_Magic         == expected.m_Magic)         &&
+                         (header.m_Version       == expected.m_Version)       &&
+                         (header.m_VendorID      == expected.m_VendorID)      &&
+                         (header.m_DeviceID      == expected.m_DeviceID)      &&
+                         (header.m_DriverVersion == expected.m_DriverVersion) &&
+                         (memcmp(header.m_PipelineCacheUUID, expected.m_PipelineCacheUUID, VK_UUID_SIZE) == 0) &&
+                         (header.m_DataSize == file.Size() - sizeof(Header))  &&
+                         (header.m_DataHash == HashBuffer(data, header.m_DataSize));
+            if (valid)
+            {
+                createInfo.initialDataSize = header.m_DataSize;
+                createInfo.pInitialData = data;
+            }
+            else
+            {
+                LOG_CORE_INFO("pipeline cache {0} does not match this device or driver, discarding it", CACHE_FILEPATH);
+            }
+        }
+
+        if (vkCreatePipelineCache(m_Device.Device(), &createInfo, nullptr, &m_PipelineCache) != VK_SUCCESS)
+        {
+            // the driver may reject the data nevertheless, retry with an empty cache
+            createInfo.initialDataSize = 0;
+            createInfo.pInitialData = nullptr;
+            if (vkCreatePipelineCache(m_Device.Device(), &createInfo, nullptr, &m_PipelineCache) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to create pipeline cache!");
+                m_PipelineCache = VK_NULL_HANDLE;
+            }
+        }
+    }
+
+    VK_PipelineCache::~VK_PipelineCache()
+    {
+        if (m_PipelineCache != VK_NULL_HANDLE)
+        {
+            Save();
+            vkDestroyPipelineCache(m_Device.Device(), m_PipelineCache, nullptr);
+        }
+    }
+
+    void VK_PipelineCache::FillHeader(Header& header) const
+    {
+        memset(&header, 0, sizeof(Header));
+        header.m_Magic         = MAGIC;
+        header.m_Version       = VERSION;
+        header.m_VendorID      = m_Device.properties.vendorID;
+        header.m_DeviceID      = m_Device.properties.deviceID;
+        header.m_DriverVersion = m_Device.properties.driverVersion;
+        memcpy(header.m_PipelineCacheUUID, m_Device.properties.pipelineCacheUUID, VK_UUID_SIZE);
+    }
+
+    void VK_PipelineCache::Save()
+    {
+        if (m_PipelineCache == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        size_t size = 0;
+        if ((vkGetPipelineCacheData(m_Device.Device(), m_PipelineCache, &size, nullptr) != VK_SUCCESS) || !size)
+        {
+            return;
+        }
+        std::vector<uchar> data(size);
+        if (vkGetPipelineCacheData(m_Device.Device(), m_PipelineCache, &size, data.data()) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        Header header;
+        FillHeader(header);
+        header.m_DataSize = size;
+        header.m_DataHash = HashBuffer(data.data(), size);
+
+        std::string directory = EngineCore::GetPathWithoutFilename(CACHE_FILEPATH);
+        if (!EngineCore::FileExists(directory))
+        {
+            EngineCore::CreateDirectory(directory);
+        }
+
+        // write to a temporary file first so that an interrupted save cannot leave a truncated cache
+        std::string temporaryFilepath = std::string(CACHE_FILEPATH) + ".tmp";
+        {
+            std::ofstream file(temporaryFilepath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                LOG_CORE_WARN("could not write pipeline cache {0}", temporaryFilepath);
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            file.write(reinterpret_cast<const char*>(data.data()), size);
+        }
+        std::error_code error;
+        std::filesystem::rename(temporaryFilepath, CACHE_FILEPATH, error);
+        if (error)
+        {
+            LOG_CORE_WARN("could not write pipeline cache {0}: {1}", CACHE_FILEPATH, error.message());
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    class VK_Device;
+
+    // VkPipelineCache shared by all pipelines of a device, persisted in bin/cache/pipeline.cache;
+    // the file is only used if vendor, device, driver version and pipeline cache UUID match
+    class VK_PipelineCache
+    {
+
+    public:
+
+        static constexpr const char* CACHE_FILEPATH = "bin/cache/pipeline.cache";
+
+    public:
+
+        VK_PipelineCache(VK_Device& device);
+        ~VK_PipelineCache();
+
+        VK_PipelineCache(const VK_PipelineCache&) = delete;
+        VK_PipelineCache& operator=(const VK_PipelineCache&) = delete;
+
+        VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+        void Save();
+
+    private:
+
+        struct Header
+        {
+            uint   m_Magic;
+            uint   m_Version;
+            uint   m_VendorID;
+            uint   m_DeviceID;
+            uint   m_DriverVersion;
+            uchar  m_PipelineCacheUUID[VK_UUID_SIZE];
+            uint64 m_DataSize;
+            uint64 m_DataHash;
+        };
+
+        static constexpr uint MAGIC   = 0x45505043; // "CPPE"
+        static constexpr uint VERSION = 1;
+
+        void FillHeader(Header& header) const;
+
+    private:
+
+        VK_Device& m_Device;
+        VkPipelineCache m_PipelineCache;
+
+    };
+}
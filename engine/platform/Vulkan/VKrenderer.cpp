@@ -24,6 +24,7 @@
 #include "core.h"
 #include "resources/resources.h"
 #include "auxiliary/file.h"
+#include "auxiliary/instrumentation.h"
 
 #include "VKrenderer.h"
 #include "VKwindow.h"
@@ -35,16 +36,29 @@ namespace GfxRenderEngine
     std::shared_ptr<Texture> gTextureFontAtlas;
 
     std::unique_ptr<VK_DescriptorPool> VK_Renderer::m_DescriptorPool;
+    std::unique_ptr<VK_MaterialCache> VK_Renderer::m_MaterialCache;
+    std::unique_ptr<VK_TextureTable> VK_Renderer::m_TextureTable;
+    std::unique_ptr<VK_ResourceStreamer> VK_Renderer::m_ResourceStreamer;
+    std::unique_ptr<VK_GpuTimer> VK_Renderer::m_GpuTimer;
 
-    VK_Renderer::VK_Renderer(VK_Window* window, std::shared_ptr<VK_Device> device)
-        : m_Window{window}, m_Device{device},
+    VK_Renderer::VK_Renderer(VK_Window* window, std::shared_ptr<VK_Device> device, VkExtent2D offscreenExtent)
+        : m_Window{window}, m_OffscreenExtent{offscreenExtent}, m_Device{device},
           m_CurrentImageIndex{0},
           m_CurrentFrameIndex{0},
-          m_FrameInProgress{false}
+          m_FrameInProgress{false},
+          m_DrawCalls{0},
+          m_InstanceCount{0}
     {
         CompileShaders();
         RecreateSwapChain();
         CreateCommandBuffers();
+        m_ThreadCommandPools = std::make_unique<VK_ThreadCommandPools>
+        (
+            *m_Device,
+            VK_SwapChain::MAX_FRAMES_IN_FLIGHT,
+            Engine::m_Engine->GetJobSystem().GetNumberOfThreads()
+        );
+        m_GpuTimer = std::make_unique<VK_GpuTimer>(*m_Device, VK_SwapChain::MAX_FRAMES_IN_FLIGHT);
 
         for (uint i = 0; i < m_UniformBuffers.size(); i++)
         {
@@ -65,51 +79,61 @@ namespace GfxRenderEngine
             VK_DescriptorPool::Builder()
             .SetMaxSets(VK_SwapChain::MAX_FRAMES_IN_FLIGHT * POOL_SIZE)
             .AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SwapChain::MAX_FRAMES_IN_FLIGHT * 10)
+            .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SwapChain::MAX_FRAMES_IN_FLIGHT * 10)
             .AddPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SwapChain::MAX_FRAMES_IN_FLIGHT * (POOL_SIZE - 10))
             .Build();
 
-        std::unique_ptr<VK_DescriptorSetLayout> globalDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
+        m_GlobalDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
                     .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
                     .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS) // spritesheet
                     .AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS) // font atlas
+                    .AddBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)          // instance data
                     .Build();
 
-        std::unique_ptr<VK_DescriptorSetLayout> diffuseDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
-                    .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS) // color map
-                    .Build();
-
-        std::unique_ptr<VK_DescriptorSetLayout> diffuseNormalDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
-                    .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS) // color map
-                    .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS) // normal map
-                    .Build();
+        // material layouts (set 1) are owned by the material cache and shared with VK_Model
+        m_MaterialCache = std::make_unique<VK_MaterialCache>(*m_DescriptorPool);
+        auto& diffuseDescriptorSetLayout                        = m_MaterialCache->GetDescriptorSetLayout(VK_MaterialCache::ONE_MAP);    // color map
+        auto& diffuseNormalDescriptorSetLayout                  = m_MaterialCache->GetDescriptorSetLayout(VK_MaterialCache::TWO_MAPS);   // color, normal map
+        auto& diffuseNormalRoughnessMetallicDescriptorSetLayout = m_MaterialCache->GetDescriptorSetLayout(VK_MaterialCache::THREE_MAPS); // color, normal, roughness metallic map
 
-        std::unique_ptr<VK_DescriptorSetLayout> diffuseNormalRoughnessMetallicDescriptorSetLayout = VK_DescriptorSetLayout::Builder()
-                    .AddBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS) // color map
-                    .AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS) // normal map
-                    .AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_ALL_GRAPHICS) // roughness metallic map
-                    .Build();
+        // with descriptor indexing, the textured PBR systems use the texture table as set 1
+        if (m_Device->SupportsBindlessTextures())
+        {
+            m_TextureTable = std::make_unique<VK_TextureTable>(*m_Device);
+        }
+        m_ResourceStreamer = std::make_unique<VK_ResourceStreamer>(*m_Device, m_TextureTable.get(), Engine::m_Engine->GetJobSystem());
+        auto materialLayout = [&](VK_DescriptorSetLayout& descriptorSetLayout)
+        {
+            return m_TextureTable ? m_TextureTable->GetDescriptorSetLayout() : descriptorSetLayout.GetDescriptorSetLayout();
+        };
 
         std::vector<VkDescriptorSetLayout> descriptorSetLayoutsDefaultDiffuse =
         {
-            globalDescriptorSetLayout->GetDescriptorSetLayout()
+            m_GlobalDescriptorSetLayout->GetDescriptorSetLayout()
         };
 
         std::vector<VkDescriptorSetLayout> descriptorSetLayoutsDiffuse =
         {
-            globalDescriptorSetLayout->GetDescriptorSetLayout(),
-            diffuseDescriptorSetLayout->GetDescriptorSetLayout()
+            m_GlobalDescriptorSetLayout->GetDescriptorSetLayout(),
+            diffuseDescriptorSetLayout.GetDescriptorSetLayout()
+        };
+
+        std::vector<VkDescriptorSetLayout> descriptorSetLayoutsPbrDiffuse =
+        {
+            m_GlobalDescriptorSetLayout->GetDescriptorSetLayout(),
+            materialLayout(diffuseDescriptorSetLayout)
         };
 
         std::vector<VkDescriptorSetLayout> descriptorSetLayoutsDiffuseNormal =
         {
-            globalDescriptorSetLayout->GetDescriptorSetLayout(),
-            diffuseNormalDescriptorSetLayout->GetDescriptorSetLayout()
+            m_GlobalDescriptorSetLayout->GetDescriptorSetLayout(),
+            materialLayout(diffuseNormalDescriptorSetLayout)
         };
 
         std::vector<VkDescriptorSetLayout> descriptorSetLayoutsDiffuseNormalRoughnessMetallic =
         {
-            globalDescriptorSetLayout->GetDescriptorSetLayout(),
-            diffuseNormalRoughnessMetallicDescriptorSetLayout->GetDescriptorSetLayout()
+            m_GlobalDescriptorSetLayout->GetDescriptorSetLayout(),
+            materialLayout(diffuseNormalRoughnessMetallicDescriptorSetLayout)
         };
 
         size_t fileSize;
@@ -135,23 +159,36 @@ namespace GfxRenderEngine
         imageInfo1.imageView   = textureFontAtlas->m_TextureView;
         imageInfo1.imageLayout = textureFontAtlas->m_ImageLayout;
 
+        // every block of an instance buffer has its own global descriptor set
         for (uint i = 0; i < VK_SwapChain::MAX_FRAMES_IN_FLIGHT; i++)
         {
-            VkDescriptorBufferInfo bufferInfo = m_UniformBuffers[i]->DescriptorInfo();
-            VK_DescriptorWriter(*globalDescriptorSetLayout, *m_DescriptorPool)
-                .WriteBuffer(0, &bufferInfo)
-                .WriteImage(1, &imageInfo0)
-                .WriteImage(2, &imageInfo1)
-                .Build(m_GlobalDescriptorSets[i]);
+            auto createGlobalDescriptorSet = [this, i, imageInfo0, imageInfo1](VkDescriptorBufferInfo& instanceBufferInfo) mutable
+            {
+                VkDescriptorSet descriptorSet;
+                VkDescriptorBufferInfo bufferInfo = m_UniformBuffers[i]->DescriptorInfo();
+                VK_DescriptorWriter(*m_GlobalDescriptorSetLayout, *m_DescriptorPool)
+                    .WriteBuffer(0, &bufferInfo)
+                    .WriteImage(1, &imageInfo0)
+                    .WriteImage(2, &imageInfo1)
+                    .WriteBuffer(3, &instanceBufferInfo)
+                    .Build(descriptorSet);
+                return descriptorSet;
+            };
+            m_InstanceBuffers[i] = std::make_unique<VK_InstanceBuffer>(*m_Device, createGlobalDescriptorSet);
+            m_GlobalDescriptorSets[i] = m_InstanceBuffers[i]->GetGlobalDescriptorSet();
         }
 
-        m_PointLightSystem                              = std::make_unique<VK_PointLightSystem>(m_Device, m_SwapChain->GetRenderPass(), *globalDescriptorSetLayout);
-        m_RenderSystemDefaultDiffuseMap                 = std::make_unique<VK_RenderSystemDefaultDiffuseMap>(m_SwapChain->GetRenderPass(), descriptorSetLayoutsDiffuse);
-
-        m_RenderSystemPbrNoMap                          = std::make_unique<VK_RenderSystemPbrNoMap>(m_SwapChain->GetRenderPass(), *globalDescriptorSetLayout);
-        m_RenderSystemPbrDiffuse                        = std::make_unique<VK_RenderSystemPbrDiffuse>(m_SwapChain->GetRenderPass(), descriptorSetLayoutsDiffuse);
-        m_RenderSystemPbrDiffuseNormal                  = std::make_unique<VK_RenderSystemPbrDiffuseNormal>(m_SwapChain->GetRenderPass(), descriptorSetLayoutsDiffuseNormal);
-        m_RenderSystemPbrDiffuseNormalRoughnessMetallic = std::make_unique<VK_RenderSystemPbrDiffuseNormalRoughnessMetallic>(m_SwapChain->GetRenderPass(), descriptorSetLayoutsDiffuseNormalRoughnessMetallic);
+        // the render systems are independent, their pipelines are created concurrently
+        auto& jobSystem = Engine::m_Engine->GetJobSystem();
+        JobCounter counter;
+        VkRenderPass renderPass = m_SwapChain->GetRenderPass();
+        jobSystem.Run("create pipeline", [&]() { m_PointLightSystem = std::make_unique<VK_PointLightSystem>(m_Device, renderPass, *m_GlobalDescriptorSetLayout); }, &counter);
+        jobSystem.Run("create pipeline", [&]() { m_RenderSystemDefaultDiffuseMap = std::make_unique<VK_RenderSystemDefaultDiffuseMap>(renderPass, descriptorSetLayoutsDiffuse); }, &counter);
+        jobSystem.Run("create pipeline", [&]() { m_RenderSystemPbrNoMap = std::make_unique<VK_RenderSystemPbrNoMap>(renderPass, *m_GlobalDescriptorSetLayout); }, &counter);
+        jobSystem.Run("create pipeline", [&]() { m_RenderSystemPbrDiffuse = std::make_unique<VK_RenderSystemPbrDiffuse>(renderPass, descriptorSetLayoutsPbrDiffuse); }, &counter);
+        jobSystem.Run("create pipeline", [&]() { m_RenderSystemPbrDiffuseNormal = std::make_unique<VK_RenderSystemPbrDiffuseNormal>(renderPass, descriptorSetLayoutsDiffuseNormal); }, &counter);
+        jobSystem.Run("create pipeline", [&]() { m_RenderSystemPbrDiffuseNormalRoughnessMetallic = std::make_unique<VK_RenderSystemPbrDiffuseNormalRoughnessMetallic>(renderPass, descriptorSetLayoutsDiffuseNormalRoughnessMetallic); }, &counter);
+        jobSystem.Wait(counter);
 
         m_Imgui = Imgui::Create(m_SwapChain->GetRenderPass(), static_cast<uint>(m_SwapChain->ImageCount()));
     }
@@ -159,10 +196,21 @@ namespace GfxRenderEngine
     VK_Renderer::~VK_Renderer()
     {
         FreeCommandBuffers();
+        m_GpuTimer.reset();
+        m_MaterialCache.reset();
+        m_ResourceStreamer.reset();
+        m_TextureTable.reset();
     }
 
     void VK_Renderer::RecreateSwapChain()
     {
+        if (!m_Window)
+        {
+            vkDeviceWaitIdle(m_Device->Device());
+            m_SwapChain = std::make_unique<VK_SwapChain>(m_Device, m_OffscreenExtent);
+            return;
+        }
+
         auto extent = m_Window->GetExtend();
         while (extent.width == 0 || extent.height == 0)
         {
@@ -250,6 +298,7 @@ namespace GfxRenderEngine
         {
             LOG_CORE_CRITICAL("failed to begin recording command buffer!");
         }
+        m_GpuTimer->BeginFrame(commandBuffer, m_CurrentFrameIndex);
 
         return commandBuffer;
 
@@ -261,14 +310,18 @@ namespace GfxRenderEngine
 
         auto commandBuffer = GetCurrentCommandBuffer();
 
+        m_GpuTimer->EndFrame(commandBuffer);
         if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("recording of command buffer failed");
         }
         auto result = m_SwapChain->SubmitCommandBuffers(&commandBuffer, &m_CurrentImageIndex);
-        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_Window->WasResized())
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || (m_Window && m_Window->WasResized()))
         {
-            m_Window->ResetWindowResizedFlag();
+            if (m_Window)
+            {
+                m_Window->ResetWindowResizedFlag();
+            }
             RecreateSwapChain();
         }
         else if (result != VK_SUCCESS)
@@ -298,8 +351,41 @@ namespace GfxRenderEngine
         renderPassInfo.clearValueCount = static_cast<uint>(clearValues.size());
         renderPassInfo.pClearValues = clearValues.data();
 
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        // the render pass contents are recorded into secondary command buffers
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    }
 
+    void VK_Renderer::EndSwapChainRenderPass(VkCommandBuffer commandBuffer)
+    {
+        ASSERT(m_FrameInProgress);
+        ASSERT(commandBuffer == GetCurrentCommandBuffer());
+
+        vkCmdEndRenderPass(commandBuffer);
+    }
+
+    // may be called from any job system thread
+    VkCommandBuffer VK_Renderer::BeginSecondaryCommandBuffer(VK_GpuTimer::Stage stage, uint& scope)
+    {
+        ASSERT(m_FrameInProgress);
+
+        auto commandBuffer = m_ThreadCommandPools->Allocate(m_CurrentFrameIndex);
+
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = m_SwapChain->GetRenderPass();
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = m_SwapChain->GetFrameBuffer(m_CurrentImageIndex);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("failed to begin recording secondary command buffer!");
+        }
+
+        // dynamic state is not inherited from the primary command buffer
         VkViewport viewport{};
         viewport.x = 0.0f;
         viewport.y = 0.0f;
@@ -311,22 +397,56 @@ namespace GfxRenderEngine
         vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
         vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
+        scope = m_GpuTimer->BeginScope(commandBuffer, stage);
+        return commandBuffer;
     }
 
-    void VK_Renderer::EndSwapChainRenderPass(VkCommandBuffer commandBuffer)
+    void VK_Renderer::EndSecondaryCommandBuffer(VkCommandBuffer commandBuffer, uint scope)
     {
-        ASSERT(m_FrameInProgress);
-        ASSERT(commandBuffer == GetCurrentCommandBuffer());
+        m_GpuTimer->EndScope(commandBuffer, scope);
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("recording of secondary command buffer failed");
+        }
+    }
 
-        vkCmdEndRenderPass(commandBuffer);
+    // render systems only read the registry while recording in parallel
+    void VK_Renderer::PrepareParallelRecording(entt::registry& registry)
+    {
+        // entt creates component pools on first access
+        registry.storage<MeshComponent>();
+        registry.storage<TransformComponent>();
+        registry.storage<PointLightComponent>();
+        registry.storage<DefaultDiffuseComponent>();
+        registry.storage<PbrNoMapComponent>();
+        registry.storage<PbrDiffuseComponent>();
+        registry.storage<PbrDiffuseNormalComponent>();
+        registry.storage<PbrDiffuseNormalRoughnessMetallicComponent>();
+
+        // transforms outside of the scene hierarchy update their matrices lazily
+        auto view = registry.view<TransformComponent>();
+        for (auto entity : view)
+        {
+            view.get<TransformComponent>(entity).GetMat4();
+        }
     }
 
     void VK_Renderer::BeginFrame(Camera* camera, entt::registry& registry)
     {
+        // free staging memory of completed upload batches
+        m_Device->CollectUploads();
+        m_ResourceStreamer->Update();
+
         m_Camera = camera;
         if (m_CurrentCommandBuffer = BeginFrame())
         {
-            m_FrameInfo = {m_CurrentFrameIndex, 0.0f, m_CurrentCommandBuffer, m_Camera, m_GlobalDescriptorSets[m_CurrentFrameIndex]};
+            m_InstanceBuffers[m_CurrentFrameIndex]->Reset();
+            // the fence of this frame has been waited on in AcquireNextImage()
+            m_ThreadCommandPools->Reset(m_CurrentFrameIndex);
+            m_SecondaryCommandBuffers.clear();
+            m_FrameInfo = {m_CurrentFrameIndex, 0.0f, m_CurrentCommandBuffer, m_Camera, m_GlobalDescriptorSets[m_CurrentFrameIndex], m_InstanceBuffers[m_CurrentFrameIndex].get(),
+                           Frustum{m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix()},
+                           m_TextureTable ? m_TextureTable->GetDescriptorSet() : VK_NULL_HANDLE};
 
             GlobalUniformBuffer ubo{};
             ubo.m_Projection = m_Camera->GetProjectionMatrix();
@@ -340,50 +460,56 @@ namespace GfxRenderEngine
         }
     }
 
-    void VK_Renderer::UpdateTransformCache(entt::registry& registry, TreeNode& node, const glm::mat4& parentMat4, bool parentDirtyFlag)
-    {
-        entt::entity gameObject = node.GetGameObject();
-        auto& transform = registry.get<TransformComponent>(gameObject);
-        bool dirtyFlag = transform.GetDirtyFlag() || parentDirtyFlag;
-
-        if (dirtyFlag)
-        {
-            transform.SetDirtyFlag();
-            auto& mat4 = transform.GetMat4();
-            glm::mat4 cleanMat4 = parentMat4*mat4;
-            transform.SetMat4(cleanMat4);
-            for (uint index = 0; index < node.Children(); index++)
-            {
-                UpdateTransformCache(registry, node.GetChild(index), cleanMat4, true);
-            }
-        }
-        else
-        {
-            auto& mat4 = transform.GetMat4();
-            for (uint index = 0; index < node.Children(); index++)
-            {
-                UpdateTransformCache(registry, node.GetChild(index), mat4, false);
-            }
-
-        }
-    }
-
     void VK_Renderer::Submit(entt::registry& registry, TreeNode& sceneHierarchy)
     {
         if (m_CurrentCommandBuffer)
         {
-            UpdateTransformCache(registry, sceneHierarchy, glm::mat4(1.0f), false);
-
-            // sprites
-            m_RenderSystemDefaultDiffuseMap->RenderEntities(m_FrameInfo, registry);
+            m_TransformHierarchy.Update(registry, sceneHierarchy);
+            PrepareParallelRecording(registry);
 
-            // 3D objects
-            m_RenderSystemPbrNoMap->RenderEntities(m_FrameInfo, registry);
-            m_RenderSystemPbrDiffuse->RenderEntities(m_FrameInfo, registry);
-            m_RenderSystemPbrDiffuseNormal->RenderEntities(m_FrameInfo, registry);
-            m_RenderSystemPbrDiffuseNormalRoughnessMetallic->RenderEntities(m_FrameInfo, registry);
+            // each render system records its own secondary command buffer on a job system thread
+            static constexpr std::array<VK_GpuTimer::Stage, 6> stages =
+            {
+                VK_GpuTimer::DEFAULT_DIFFUSE_MAP,
+                VK_GpuTimer::PBR_NO_MAP,
+                VK_GpuTimer::PBR_DIFFUSE,
+                VK_GpuTimer::PBR_DIFFUSE_NORMAL,
+                VK_GpuTimer::PBR_DIFFUSE_NORMAL_ROUGHNESS_METALLIC,
+                VK_GpuTimer::POINT_LIGHTS
+            };
+            std::array<std::function<void(VK_FrameInfo&)>, 6> renderSystems =
+            {
+                // sprites
+                [&](VK_FrameInfo& frameInfo) { m_RenderSystemDefaultDiffuseMap->RenderEntities(frameInfo, registry); },
+
+                // 3D objects
+                [&](VK_FrameInfo& frameInfo) { m_RenderSystemPbrNoMap->RenderEntities(frameInfo, registry); },
+                [&](VK_FrameInfo& frameInfo) { m_RenderSystemPbrDiffuse->RenderEntities(frameInfo, registry); },
+                [&](VK_FrameInfo& frameInfo) { m_RenderSystemPbrDiffuseNormal->RenderEntities(frameInfo, registry); },
+                [&](VK_FrameInfo& frameInfo) { m_RenderSystemPbrDiffuseNormalRoughnessMetallic->RenderEntities(frameInfo, registry); },
+
+                [&](VK_FrameInfo& frameInfo) { m_PointLightSystem->Render(frameInfo, registry); }
+            };
+            std::array<VkCommandBuffer, 6> commandBuffers;
+
+            auto& jobSystem = Engine::m_Engine->GetJobSystem();
+            JobCounter counter;
+            for (uint i = 0; i < renderSystems.size(); i++)
+            {
+                jobSystem.Run("VK_Renderer::RecordRenderSystem", [&, i]()
+                {
+                    uint scope;
+                    VK_FrameInfo frameInfo = m_FrameInfo;
+                    frameInfo.m_CommandBuffer = BeginSecondaryCommandBuffer(stages[i], scope);
+                    renderSystems[i](frameInfo);
+                    EndSecondaryCommandBuffer(frameInfo.m_CommandBuffer, scope);
+                    commandBuffers[i] = frameInfo.m_CommandBuffer;
+                }, &counter);
+            }
+            jobSystem.Wait(counter);
 
-            m_PointLightSystem->Render(m_FrameInfo, registry);
+            // keep the draw order independent of the job order
+            m_SecondaryCommandBuffers.insert(m_SecondaryCommandBuffers.end(), commandBuffers.begin(), commandBuffers.end());
         }
     }
 
@@ -391,7 +517,12 @@ namespace GfxRenderEngine
     {
         if (m_CurrentCommandBuffer)
         {
-            m_RenderSystemDefaultDiffuseMap->DrawParticles(m_FrameInfo, particleSystem);
+            uint scope;
+            VK_FrameInfo frameInfo = m_FrameInfo;
+            frameInfo.m_CommandBuffer = BeginSecondaryCommandBuffer(VK_GpuTimer::PARTICLES, scope);
+            m_RenderSystemDefaultDiffuseMap->DrawParticles(frameInfo, particleSystem);
+            EndSecondaryCommandBuffer(frameInfo.m_CommandBuffer, scope);
+            m_SecondaryCommandBuffers.push_back(frameInfo.m_CommandBuffer);
         }
     }
 
@@ -399,7 +530,12 @@ namespace GfxRenderEngine
     {
         if (m_CurrentCommandBuffer)
         {
-            m_RenderSystemDefaultDiffuseMap->RenderEntities(m_FrameInfo, registry);
+            uint scope;
+            VK_FrameInfo frameInfo = m_FrameInfo;
+            frameInfo.m_CommandBuffer = BeginSecondaryCommandBuffer(VK_GpuTimer::GUI, scope);
+            m_RenderSystemDefaultDiffuseMap->RenderEntities(frameInfo, registry);
+            EndSecondaryCommandBuffer(frameInfo.m_CommandBuffer, scope);
+            m_SecondaryCommandBuffers.push_back(frameInfo.m_CommandBuffer);
         }
     }
 
@@ -409,7 +545,22 @@ namespace GfxRenderEngine
         {
             m_Imgui->NewFrame();
             m_Imgui->Run();
-            m_Imgui->Render(m_CurrentCommandBuffer);
+            uint scope;
+            auto imguiCommandBuffer = BeginSecondaryCommandBuffer(VK_GpuTimer::IMGUI, scope);
+            m_Imgui->Render(imguiCommandBuffer);
+            EndSecondaryCommandBuffer(imguiCommandBuffer, scope);
+            m_SecondaryCommandBuffers.push_back(imguiCommandBuffer);
+
+            m_DrawCalls = m_InstanceBuffers[m_CurrentFrameIndex]->GetDrawCalls();
+            m_InstanceCount = m_InstanceBuffers[m_CurrentFrameIndex]->GetInstanceCount();
+            PROFILE_COUNTER("instances", m_InstanceCount);
+            PROFILE_COUNTER("draw calls", m_DrawCalls);
+            vkCmdExecuteCommands
+            (
+                m_CurrentCommandBuffer,
+                static_cast<uint>(m_SecondaryCommandBuffers.size()),
+                m_SecondaryCommandBuffers.data()
+            );
 
             EndSwapChainRenderPass(m_CurrentCommandBuffer);
             EndFrame();
@@ -429,31 +580,55 @@ namespace GfxRenderEngine
             LOG_CORE_WARN("creating bin directory for spirv files");
             EngineCore::CreateDirectory("bin");
         }
-        std::vector<std::string> shaderFilenames = 
-        {
-            "pointLight.vert",
-            "pointLight.frag",
-            "defaultDiffuseMap.vert",
-            "defaultDiffuseMap.frag",
-            "pbrNoMap.vert",
-            "pbrNoMap.frag",
-            "pbrDiffuse.vert",
-            "pbrDiffuse.frag",
-            "pbrDiffuseNormal.vert",
-            "pbrDiffuseNormal.frag",
-            "pbrDiffuseNormalRoughnessMetallic.vert",
-            "pbrDiffuseNormalRoughnessMetallic.frag"
+        if (!EngineCore::FileExists(VK_Shader::CACHE_DIRECTORY))
+        {
+            EngineCore::CreateDirectory(VK_Shader::CACHE_DIRECTORY);
+        }
+        struct ShaderSource
+        {
+            std::string m_Filename;      // in engine/platform/Vulkan/shaders/
+            std::string m_SpirvFilename; // in bin/
+            VK_Shader::Defines m_Defines;
         };
 
-        for (auto& filename : shaderFilenames)
+        // bindless variants of the textured PBR fragment shaders read from the texture table
+        VK_Shader::Defines bindless = {{"BINDLESS", "1"}, {"MAX_TEXTURES", std::to_string(VK_TextureTable::MAX_TEXTURES)}};
+        std::vector<ShaderSource> shaders = 
         {
-            std::string spirvFilename = std::string("bin/") + filename + std::string(".spv");
-            if (!EngineCore::FileExists(spirvFilename))
+            {"pointLight.vert",                        "pointLight.vert.spv"},
+            {"pointLight.frag",                        "pointLight.frag.spv"},
+            {"defaultDiffuseMap.vert",                 "defaultDiffuseMap.vert.spv"},
+            {"defaultDiffuseMap.frag",                 "defaultDiffuseMap.frag.spv"},
+            {"pbrNoMap.vert",                          "pbrNoMap.vert.spv"},
+            {"pbrNoMap.frag",                          "pbrNoMap.frag.spv"},
+            {"pbrDiffuse.vert",                        "pbrDiffuse.vert.spv"},
+            {"pbrDiffuse.frag",                        "pbrDiffuse.frag.spv"},
+            {"pbrDiffuse.frag",                        "pbrDiffuseBindless.frag.spv", bindless},
+            {"pbrDiffuseNormal.vert",                  "pbrDiffuseNormal.vert.spv"},
+            {"pbrDiffuseNormal.frag",                  "pbrDiffuseNormal.frag.spv"},
+            {"pbrDiffuseNormal.frag",                  "pbrDiffuseNormalBindless.frag.spv", bindless},
+            {"pbrDiffuseNormalRoughnessMetallic.vert", "pbrDiffuseNormalRoughnessMetallic.vert.spv"},
+            {"pbrDiffuseNormalRoughnessMetallic.frag", "pbrDiffuseNormalRoughnessMetallic.frag.spv"},
+            {"pbrDiffuseNormalRoughnessMetallic.frag", "pbrDiffuseNormalRoughnessMetallicBindless.frag.spv", bindless}
+        };
+
+        // each shader is hashed and, if not found in the cache, compiled on a worker thread
+        auto& jobSystem = Engine::m_Engine->GetJobSystem();
+        JobCounter counter;
+        for (auto& source : shaders)
+        {
+            jobSystem.Run("compile shader", [&source]()
             {
-                std::string name = std::string("engine/platform/Vulkan/shaders/") + filename;
-                VK_Shader shader{name, spirvFilename};
-            }
+                std::string name = std::string("engine/platform/Vulkan/shaders/") + source.m_Filename;
+                std::string spirvFilename = std::string("bin/") + source.m_SpirvFilename;
+                VK_Shader shader{name, spirvFilename, OPTIMIZE_SHADERS, source.m_Defines};
+                if (!shader.IsOk())
+                {
+                    LOG_CORE_CRITICAL("could not compile shader {0}", spirvFilename);
+                }
+            }, &counter);
         }
+        jobSystem.Wait(counter);
     }
 
 }
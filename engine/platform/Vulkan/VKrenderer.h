@@ -29,6 +29,7 @@
 #include "engine.h"
 #include "renderer/renderer.h"
 #include "platform/Vulkan/imguiEngine/imgui.h"
+#include "scene/transformHierarchy.h"
 
 #include "systems/VKdefaultDiffuseMapSys.h"
 #include "systems/VKpointLightSys.h"
@@ -41,8 +42,14 @@
 #include "VKdevice.h"
 #include "VKswapChain.h"
 #include "VKdescriptor.h"
+#include "VKmaterialCache.h"
+#include "VKtextureTable.h"
+#include "VKresourceStreamer.h"
 #include "VKtexture.h"
 #include "VKbuffer.h"
+#include "VKinstanceBuffer.h"
+#include "VKthreadCommandPools.h"
+#include "VKgpuTimer.h"
 
 namespace GfxRenderEngine
 {
@@ -52,7 +59,8 @@ namespace GfxRenderEngine
 
     public:
 
-        VK_Renderer(VK_Window* window, std::shared_ptr<VK_Device> device);
+        // without window, the renderer draws offscreen with the given extent
+        VK_Renderer(VK_Window* window, std::shared_ptr<VK_Device> device, VkExtent2D offscreenExtent = {0, 0});
         ~VK_Renderer() override;
 
         VK_Renderer(const VK_Renderer&) = delete;
@@ -80,9 +88,24 @@ namespace GfxRenderEngine
 
         void ToggleDebugWindow(const GenericCallback& callback = nullptr) { m_Imgui = Imgui::ToggleDebugWindow(callback); }
 
+        // statistics of the last submitted frame
+        uint GetDrawCalls() const { return m_DrawCalls; }
+        uint GetInstanceCount() const { return m_InstanceCount; }
+        // milliseconds the CPU waited for frame fences in the last frame
+        float GetFenceWaitTime() const { return m_SwapChain->GetFenceWaitTime(); }
+
     public:
 
         static std::unique_ptr<VK_DescriptorPool> m_DescriptorPool;
+        static std::unique_ptr<VK_MaterialCache> m_MaterialCache;
+        static std::unique_ptr<VK_TextureTable> m_TextureTable; // nullptr without descriptor indexing
+        static std::unique_ptr<VK_ResourceStreamer> m_ResourceStreamer; // streams textures only with the texture table
+        static std::unique_ptr<VK_GpuTimer> m_GpuTimer;
+
+    private:
+
+        // compile with shaderc_optimization_level_performance
+        static constexpr bool OPTIMIZE_SHADERS = true;
 
     private:
 
@@ -90,11 +113,15 @@ namespace GfxRenderEngine
         void FreeCommandBuffers();
         void RecreateSwapChain();
         void CompileShaders();
-        void UpdateTransformCache(entt::registry& registry, TreeNode& node, const glm::mat4& parentMat4, bool parentDirtyFlag);
+        // secondary command buffers are timed as one GPU timer scope
+        VkCommandBuffer BeginSecondaryCommandBuffer(VK_GpuTimer::Stage stage, uint& scope);
+        void EndSecondaryCommandBuffer(VkCommandBuffer commandBuffer, uint scope);
+        void PrepareParallelRecording(entt::registry& registry);
 
     private:
 
         VK_Window* m_Window;
+        VkExtent2D m_OffscreenExtent;
         std::shared_ptr<VK_Device> m_Device;
 
         std::unique_ptr<VK_RenderSystemPbrNoMap>                          m_RenderSystemPbrNoMap;
@@ -111,14 +138,24 @@ namespace GfxRenderEngine
         std::vector<VkCommandBuffer> m_CommandBuffers;
         VkCommandBuffer m_CurrentCommandBuffer;
 
+        // render systems record into secondary command buffers,
+        // which are executed by the primary command buffer in EndScene()
+        std::unique_ptr<VK_ThreadCommandPools> m_ThreadCommandPools;
+        std::vector<VkCommandBuffer> m_SecondaryCommandBuffers;
+
         uint m_CurrentImageIndex;
         int m_CurrentFrameIndex;
         bool m_FrameInProgress;
         VK_FrameInfo m_FrameInfo;
+        TransformHierarchy m_TransformHierarchy;
+        uint m_DrawCalls;
+        uint m_InstanceCount;
 
+        std::unique_ptr<VK_DescriptorSetLayout> m_GlobalDescriptorSetLayout;
         std::vector<VkDescriptorSet> m_GlobalDescriptorSets{VK_SwapChain::MAX_FRAMES_IN_FLIGHT};
         std::vector<VkDescriptorSet> m_LocalDescriptorSets{VK_SwapChain::MAX_FRAMES_IN_FLIGHT};
         std::vector<std::unique_ptr<VK_Buffer>> m_UniformBuffers{VK_SwapChain::MAX_FRAMES_IN_FLIGHT};
+        std::vector<std::unique_ptr<VK_InstanceBuffer>> m_InstanceBuffers{VK_SwapChain::MAX_FRAMES_IN_FLIGHT};
 
     };
 }
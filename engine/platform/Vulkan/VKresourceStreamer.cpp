@@ -0,0 +1,793 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "stb_image.h"
+#include "core.h"
+#include "auxiliary/instrumentation.h"
+#include "auxiliary/assetSystem.h"
+#include "renderer/imageConversion.h"
+
+#include "VKmodel.h"
+#include "VKresourceStreamer.h"
+
+namespace GfxRenderEngine
+{
+
+    VK_ResourceStreamer::VK_ResourceStreamer(VK_Device& device, VK_TextureTable* textureTable, JobSystem& jobSystem)
+        : m_Device{device}, m_TextureTable{textureTable}, m_JobSystem{jobSystem},
+          m_DedicatedTransferQueue{device.HasDedicatedTransferQueue()},
+          m_TransferQueueFamily{device.GetTransferQueueFamily()},
+          m_GraphicsQueueFamily{device.GetGraphicsQueueFamily()},
+          m_TransferCommandPool{VK_NULL_HANDLE}, m_GraphicsCommandPool{VK_NULL_HANDLE},
+          m_StagingMemory{nullptr}, m_StagingHead{0}, m_StagingUsed{0}, m_PendingUploads{0}
+    {
+        m_GraphicsCommandPool = CreateCommandPool(m_GraphicsQueueFamily);
+        if (m_DedicatedTransferQueue)
+        {
+            m_TransferCommandPool = CreateCommandPool(m_TransferQueueFamily);
+        }
+
+        // persistently mapped
+        m_StagingRing = std::make_unique<VK_Buffer>
+        (
+            m_Device, STAGING_RING_SIZE, 1,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        m_StagingRing->Map();
+        m_StagingMemory = static_cast<uchar*>(m_StagingRing->GetMappedMemory());
+
+        if (!m_TextureTable)
+        {
+            return;
+        }
+
+        // linear mid gray: neutral as a color map and a flat normal map
+        constexpr uint PLACEHOLDER_SIZE = 4;
+        std::vector<uchar> placeholder(PLACEHOLDER_SIZE * PLACEHOLDER_SIZE * 4, 0x80);
+        for (uint pixel = 0; pixel < PLACEHOLDER_SIZE * PLACEHOLDER_SIZE; pixel++)
+        {
+            placeholder[pixel * 4 + 3] = 0xff;
+        }
+        m_Placeholder = std::make_shared<VK_Texture>(Engine::m_TextureSlotManager);
+        m_Placeholder->Init(PLACEHOLDER_SIZE, PLACEHOLDER_SIZE, placeholder.data(), false /*sRGB*/);
+        m_TextureTable->SetPlaceholder(m_Placeholder->GetTextureSlot());
+    }
+
+    VK_ResourceStreamer::~VK_ResourceStreamer()
+    {
+        Flush();
+
+        auto device = m_Device.Device();
+        m_StagingRing->Unmap();
+        m_StagingRing.reset();
+        vkDestroyCommandPool(device, m_GraphicsCommandPool, nullptr);
+        if (m_TransferCommandPool != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(device, m_TransferCommandPool, nullptr);
+        }
+
+        if (m_TextureTable)
+        {
+            m_TextureTable->SetPlaceholder(VKTextureSlotManager::INVALID_SLOT);
+            m_Placeholder.reset();
+        }
+    }
+
+    VkCommandPool VK_ResourceStreamer::CreateCommandPool(uint queueFamily)
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = queueFamily;
+
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        if (vkCreateCommandPool(m_Device.Device(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_ResourceStreamer: failed to create command pool!");
+        }
+        return commandPool;
+    }
+
+    VkCommandBuffer VK_ResourceStreamer::BeginCommandBuffer(VkCommandPool commandPool)
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(m_Device.Device(), &allocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_ResourceStreamer: failed to allocate command buffer!");
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+        return commandBuffer;
+    }
+
+    std::shared_ptr<VK_Texture> VK_ResourceStreamer::Load(const std::string& filepath, bool flip)
+    {
+        ASSERT(m_TextureTable);
+        auto request = std::make_shared<Request>();
+        request->m_Texture = std::make_shared<VK_Texture>(Engine::m_TextureSlotManager);
+        request->m_Texture->m_FileName = filepath;
+        request->m_Filepath = filepath;
+        request->m_Flip = flip;
+
+        auto texture = request->m_Texture;
+        Submit(std::move(request));
+        return texture;
+    }
+
+    std::shared_ptr<VK_Texture> VK_ResourceStreamer::Load(uint width, uint height, uint channels, std::vector<uchar>&& pixels,
+                                                         bool compress, TextureCompressor::Format format, bool sRGB)
+    {
+        ASSERT(m_TextureTable);
+        auto request = std::make_shared<Request>();
+        request->m_Texture = std::make_shared<VK_Texture>(Engine::m_TextureSlotManager);
+        request->m_Texture->m_FileName = "raw memory";
+        request->m_Width = width;
+        request->m_Height = height;
+        request->m_Channels = channels;
+        request->m_Pixels = std::move(pixels);
+        request->m_Compress = compress && m_Device.SupportsBCTextures();
+        request->m_Format = format;
+        request->m_sRGB = sRGB;
+
+        auto texture = request->m_Texture;
+        Submit(std::move(request));
+        return texture;
+    }
+
+    void VK_ResourceStreamer::Load(const std::shared_ptr<VK_Model>& model, const std::vector<Vertex>& vertices, const std::vector<uint>& indices)
+    {
+        auto request = std::make_shared<Request>();
+        request->m_Model = model;
+        request->m_Vertices = vertices;
+        request->m_Indices = indices;
+
+        // the vertex data has been prepared by the builder, there is nothing to decode
+        m_PendingUploads++;
+        std::lock_guard<std::mutex> lock(m_DecodedMutex);
+        m_Decoded.push_back(std::move(request));
+    }
+
+    void VK_ResourceStreamer::Submit(std::shared_ptr<Request> request)
+    {
+        m_PendingUploads++;
+        m_JobSystem.Run("VK_ResourceStreamer::Decode", [this, request]()
+        {
+            Decode(*request);
+            std::lock_guard<std::mutex> lock(m_DecodedMutex);
+            m_Decoded.push_back(request);
+        }, &m_DecodeJobs);
+    }
+
+    // worker thread
+    void VK_ResourceStreamer::Decode(Request& request)
+    {
+        if (!request.m_Filepath.empty())
+        {
+            int width, height, channelsInFile;
+            stbi_set_flip_vertically_on_load_thread(request.m_Flip);
+            AssetData fileData;
+            uchar* pixels = nullptr;
+            if (AssetSystem::Load(request.m_Filepath, fileData))
+            {
+                pixels = stbi_load_from_memory(fileData.Data(), static_cast<int>(fileData.Size()), &width, &height, &channelsInFile, 4);
+            }
+            if (!pixels)
+            {
+                LOG_CORE_ERROR("VK_ResourceStreamer: couldn't load file {0}", request.m_Filepath);
+                request.m_Failed = true;
+                return;
+            }
+            request.m_Width = width;
+            request.m_Height = height;
+            request.m_Channels = 4;
+            request.m_Pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+            stbi_image_free(pixels);
+        }
+
+        size_t pixelCount = static_cast<size_t>(request.m_Width) * request.m_Height;
+        bool validChannels = (request.m_Channels == 3) || (request.m_Channels == 4);
+        if (!pixelCount || !validChannels || (request.m_Pixels.size() < pixelCount * request.m_Channels))
+        {
+            LOG_CORE_ERROR("VK_ResourceStreamer: unsupported image ({0}x{1}, {2} channels)", request.m_Width, request.m_Height, request.m_Channels);
+            request.m_Failed = true;
+            return;
+        }
+
+        // uncompressed RGB images are expanded to RGBA when they are written to the staging memory,
+        // the compressor reads RGBA
+        if (request.m_Compress)
+        {
+            bool opaque = (request.m_Channels == 3);
+            if (request.m_Channels == 3)
+            {
+                std::vector<uchar> rgba(pixelCount * 4);
+                ImageConversion::RGBToRGBA(request.m_Pixels.data(), rgba.data(), pixelCount);
+                request.m_Pixels.swap(rgba);
+                request.m_Channels = 4;
+            }
+
+            auto format = request.m_Format;
+            if ((format == TextureCompressor::Format::BC1) && !opaque && !TextureCompressor::IsOpaque(request.m_Pixels.data(), request.m_Width, request.m_Height))
+            {
+                format = TextureCompressor::Format::BC3;
+            }
+            request.m_Compressed = TextureCompressor::GetCompressedImage(request.m_Pixels.data(), request.m_Width, request.m_Height, format, request.m_sRGB, request.m_CompressedImage);
+            if (request.m_Compressed)
+            {
+                std::vector<uchar>().swap(request.m_Pixels);
+            }
+        }
+    }
+
+    void VK_ResourceStreamer::Update()
+    {
+        PROFILE_SCOPE("VK_ResourceStreamer::Update");
+        Publish(false);
+
+        {
+            std::lock_guard<std::mutex> lock(m_DecodedMutex);
+            for (auto& request : m_Decoded)
+            {
+                m_UploadQueue.push_back(std::move(request));
+            }
+            m_Decoded.clear();
+        }
+
+        UploadDecoded(MAX_UPLOAD_BYTES_PER_FRAME);
+    }
+
+    void VK_ResourceStreamer::Flush()
+    {
+        m_JobSystem.Wait(m_DecodeJobs);
+        while (m_PendingUploads.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_DecodedMutex);
+                for (auto& request : m_Decoded)
+                {
+                    m_UploadQueue.push_back(std::move(request));
+                }
+                m_Decoded.clear();
+            }
+            UploadDecoded(STAGING_RING_SIZE);
+            Publish(true);
+        }
+    }
+
+    void VK_ResourceStreamer::UploadDecoded(VkDeviceSize budget)
+    {
+        Batch batch;
+        VkDeviceSize uploadedBytes = 0;
+        while (!m_UploadQueue.empty() && (uploadedBytes < budget))
+        {
+            auto& request = *m_UploadQueue.front();
+            if (request.m_Failed)
+            {
+                // the texture keeps showing the placeholder
+                m_PendingUploads--;
+                m_UploadQueue.pop_front();
+                continue;
+            }
+
+            VkDeviceSize size = GetStagingSize(request);
+            if (!Record(request, batch))
+            {
+                // staging ring is full, continue once earlier uploads have completed
+                break;
+            }
+            uploadedBytes += size;
+            m_UploadQueue.pop_front();
+        }
+
+        if (batch.m_GraphicsCommandBuffer != VK_NULL_HANDLE)
+        {
+            SubmitBatch(batch);
+        }
+    }
+
+    bool VK_ResourceStreamer::AllocateStaging(VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize& allocatedBytes)
+    {
+        VkDeviceSize start = (m_StagingHead + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+        VkDeviceSize skipped = start - m_StagingHead;
+        if (start + size > STAGING_RING_SIZE)
+        {
+            // wrap around, the rest of the ring stays unused
+            skipped = STAGING_RING_SIZE - m_StagingHead;
+            start = 0;
+        }
+
+        // the used range grows from the head and is freed from the tail, in submission order
+        if (m_StagingUsed + skipped + size > STAGING_RING_SIZE)
+        {
+            return false;
+        }
+
+        m_StagingUsed += skipped + size;
+        m_StagingHead = start + size;
+        offset = start;
+        allocatedBytes = skipped + size;
+        return true;
+    }
+
+    // the index data follows the vertex data in the staging memory
+    VkDeviceSize VK_ResourceStreamer::GetIndexOffset(const Request& request)
+    {
+        VkDeviceSize vertexBytes = sizeof(Vertex) * request.m_Vertices.size();
+        return (vertexBytes + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+    }
+
+    VkDeviceSize VK_ResourceStreamer::GetStagingSize(const Request& request)
+    {
+        if (request.m_Model)
+        {
+            return GetIndexOffset(request) + sizeof(uint) * request.m_Indices.size();
+        }
+        if (request.m_Compressed)
+        {
+            return request.m_CompressedImage.m_Data.size();
+        }
+        return static_cast<VkDeviceSize>(request.m_Width) * request.m_Height * 4;
+    }
+
+    void VK_ResourceStreamer::WriteStaging(const Request& request, uchar* destination)
+    {
+        if (request.m_Model)
+        {
+            memcpy(destination, request.m_Vertices.data(), sizeof(Vertex) * request.m_Vertices.size());
+            if (!request.m_Indices.empty())
+            {
+                memcpy(destination + GetIndexOffset(request), request.m_Indices.data(), sizeof(uint) * request.m_Indices.size());
+            }
+        }
+        else if (request.m_Compressed)
+        {
+            memcpy(destination, request.m_CompressedImage.m_Data.data(), request.m_CompressedImage.m_Data.size());
+        }
+        else if (request.m_Channels == 3)
+        {
+            ImageConversion::RGBToRGBA(request.m_Pixels.data(), destination, static_cast<size_t>(request.m_Width) * request.m_Height);
+        }
+        else
+        {
+            memcpy(destination, request.m_Pixels.data(), GetStagingSize(request));
+        }
+    }
+
+    bool VK_ResourceStreamer::Record(Request& request, Batch& batch)
+    {
+        VkDeviceSize size = GetStagingSize(request);
+
+        VkBuffer stagingBuffer;
+        VkDeviceSize stagingOffset = 0;
+        if (size > STAGING_RING_SIZE)
+        {
+            auto buffer = std::make_unique<VK_Buffer>
+            (
+                m_Device, size, 1,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+            );
+            buffer->Map();
+            WriteStaging(request, static_cast<uchar*>(buffer->GetMappedMemory()));
+            buffer->Unmap();
+            stagingBuffer = buffer->GetBuffer();
+            batch.m_StagingBuffers.push_back(std::move(buffer));
+        }
+        else
+        {
+            VkDeviceSize allocatedBytes;
+            if (!AllocateStaging(size, stagingOffset, allocatedBytes))
+            {
+                return false;
+            }
+            batch.m_StagingRingBytes += allocatedBytes;
+            WriteStaging(request, m_StagingMemory + stagingOffset);
+            stagingBuffer = m_StagingRing->GetBuffer();
+        }
+
+        BeginBatch(batch);
+        if (request.m_Model)
+        {
+            RecordMesh(request, batch, stagingBuffer, stagingOffset);
+        }
+        else
+        {
+            RecordTexture(request, batch, stagingBuffer, stagingOffset);
+        }
+        return true;
+    }
+
+    void VK_ResourceStreamer::BeginBatch(Batch& batch)
+    {
+        if (batch.m_GraphicsCommandBuffer == VK_NULL_HANDLE)
+        {
+            batch.m_GraphicsCommandBuffer = BeginCommandBuffer(m_GraphicsCommandPool);
+            if (m_DedicatedTransferQueue)
+            {
+                batch.m_TransferCommandBuffer = BeginCommandBuffer(m_TransferCommandPool);
+            }
+        }
+    }
+
+    void VK_ResourceStreamer::RecordTexture(Request& request, Batch& batch, VkBuffer stagingBuffer, VkDeviceSize stagingOffset)
+    {
+        auto& texture = *request.m_Texture;
+        texture.m_Width = request.m_Width;
+        texture.m_Height = request.m_Height;
+        texture.m_BytesPerPixel = 4;
+
+        std::vector<VkBufferImageCopy> regions;
+        bool generateMipmaps = false;
+        if (request.m_Compressed)
+        {
+            auto& image = request.m_CompressedImage;
+            texture.m_Format = VK_Texture::GetCompressedFormat(image.m_Format, request.m_sRGB);
+            texture.m_MipLevels = static_cast<uint>(image.m_MipLevels.size());
+            for (uint level = 0; level < texture.m_MipLevels; level++)
+            {
+                VkBufferImageCopy region{};
+                region.bufferOffset = stagingOffset + image.m_MipLevels[level].m_Offset;
+                region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+                region.imageExtent = {image.m_MipLevels[level].m_Width, image.m_MipLevels[level].m_Height, 1};
+                regions.push_back(region);
+            }
+        }
+        else
+        {
+            texture.m_Format = request.m_sRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+            texture.m_MipLevels = 1;
+            if (texture.SupportsLinearBlit(texture.m_Format))
+            {
+                texture.m_MipLevels = static_cast<uint>(std::floor(std::log2(std::max(request.m_Width, request.m_Height)))) + 1;
+                generateMipmaps = texture.m_MipLevels > 1;
+            }
+            VkBufferImageCopy region{};
+            region.bufferOffset = stagingOffset;
+            region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+            region.imageExtent = {request.m_Width, request.m_Height, 1};
+            regions.push_back(region);
+        }
+
+        texture.CreateImage
+        (
+            texture.m_Width,
+            texture.m_Height,
+            texture.m_Format,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            texture.m_TextureImage,
+            texture.m_TextureImageAllocation
+        );
+
+        VkCommandBuffer transferCommandBuffer = m_DedicatedTransferQueue ? batch.m_TransferCommandBuffer : batch.m_GraphicsCommandBuffer;
+        VkCommandBuffer graphicsCommandBuffer = batch.m_GraphicsCommandBuffer;
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = texture.m_TextureImage;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, texture.m_MipLevels, 0, 1};
+
+        // all levels: undefined -> transfer destination
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier
+        (
+            transferCommandBuffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
+        );
+
+        vkCmdCopyBufferToImage
+        (
+            transferCommandBuffer,
+            stagingBuffer,
+            texture.m_TextureImage,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint>(regions.size()),
+            regions.data()
+        );
+
+        if (m_DedicatedTransferQueue)
+        {
+            RecordOwnershipTransfer(transferCommandBuffer, texture, true /*release*/);
+            RecordOwnershipTransfer(graphicsCommandBuffer, texture, false /*acquire*/);
+        }
+
+        // blits need a graphics queue
+        if (generateMipmaps)
+        {
+            texture.RecordMipmaps(graphicsCommandBuffer);
+        }
+        else
+        {
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier
+            (
+                graphicsCommandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier
+            );
+        }
+        texture.m_ImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        texture.CreateSamplerAndImageView();
+
+        batch.m_Textures.push_back(request.m_Texture);
+    }
+
+    void VK_ResourceStreamer::RecordMesh(Request& request, Batch& batch, VkBuffer stagingBuffer, VkDeviceSize stagingOffset)
+    {
+        auto& model = *request.m_Model;
+        VkCommandBuffer transferCommandBuffer = m_DedicatedTransferQueue ? batch.m_TransferCommandBuffer : batch.m_GraphicsCommandBuffer;
+        VkCommandBuffer graphicsCommandBuffer = batch.m_GraphicsCommandBuffer;
+
+        std::vector<VkBufferMemoryBarrier> barriers;
+        auto copy = [&](VK_Buffer& buffer, VkDeviceSize offset, VkDeviceSize size, VkAccessFlags access)
+        {
+            VkBufferCopy region{};
+            region.srcOffset = stagingOffset + offset;
+            region.dstOffset = 0;
+            region.size = size;
+            vkCmdCopyBuffer(transferCommandBuffer, stagingBuffer, buffer.GetBuffer(), 1, &region);
+
+            VkBufferMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = access;
+            barrier.srcQueueFamilyIndex = m_DedicatedTransferQueue ? m_TransferQueueFamily : VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = m_DedicatedTransferQueue ? m_GraphicsQueueFamily : VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = buffer.GetBuffer();
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+            barriers.push_back(barrier);
+        };
+
+        copy(*model.m_VertexBuffer, 0, sizeof(Vertex) * request.m_Vertices.size(), VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+        if (model.m_HasIndexBuffer)
+        {
+            copy(*model.m_IndexBuffer, GetIndexOffset(request), sizeof(uint) * request.m_Indices.size(), VK_ACCESS_INDEX_READ_BIT);
+        }
+
+        if (m_DedicatedTransferQueue)
+        {
+            // release on the transfer queue, the destination access is ignored
+            std::vector<VkBufferMemoryBarrier> releaseBarriers = barriers;
+            for (auto& barrier : releaseBarriers)
+            {
+                barrier.dstAccessMask = 0;
+            }
+            vkCmdPipelineBarrier
+            (
+                transferCommandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0,
+                0, nullptr,
+                static_cast<uint>(releaseBarriers.size()), releaseBarriers.data(),
+                0, nullptr
+            );
+
+            // acquire on the graphics queue, the source access is ignored
+            for (auto& barrier : barriers)
+            {
+                barrier.srcAccessMask = 0;
+            }
+            vkCmdPipelineBarrier
+            (
+                graphicsCommandBuffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                0,
+                0, nullptr,
+                static_cast<uint>(barriers.size()), barriers.data(),
+                0, nullptr
+            );
+        }
+        else
+        {
+            vkCmdPipelineBarrier
+            (
+                graphicsCommandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                0,
+                0, nullptr,
+                static_cast<uint>(barriers.size()), barriers.data(),
+                0, nullptr
+            );
+        }
+
+        // the vertex data lives in the staging memory now
+        std::vector<Vertex>().swap(request.m_Vertices);
+        std::vector<uint>().swap(request.m_Indices);
+        batch.m_Models.push_back(request.m_Model);
+    }
+
+    // release on the transfer queue and acquire on the graphics queue need matching barriers
+    void VK_ResourceStreamer::RecordOwnershipTransfer(VkCommandBuffer commandBuffer, VK_Texture& texture, bool release)
+    {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = m_TransferQueueFamily;
+        barrier.dstQueueFamilyIndex = m_GraphicsQueueFamily;
+        barrier.image = texture.m_TextureImage;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, texture.m_MipLevels, 0, 1};
+
+        VkPipelineStageFlags sourceStage;
+        VkPipelineStageFlags destinationStage;
+        if (release)
+        {
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            destinationStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        }
+        else
+        {
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+
+        vkCmdPipelineBarrier
+        (
+            commandBuffer,
+            sourceStage, destinationStage,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
+        );
+    }
+
+    void VK_ResourceStreamer::SubmitBatch(Batch& batch)
+    {
+        auto device = m_Device.Device();
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(device, &fenceInfo, nullptr, &batch.m_Fence) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_ResourceStreamer: failed to create fence!");
+        }
+
+        // texture acquire barriers run in the transfer stage, mesh acquire barriers in the vertex input stage
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+        VkSubmitInfo graphicsSubmitInfo{};
+        graphicsSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        graphicsSubmitInfo.commandBufferCount = 1;
+        graphicsSubmitInfo.pCommandBuffers = &batch.m_GraphicsCommandBuffer;
+
+        if (m_DedicatedTransferQueue)
+        {
+            VkSemaphoreCreateInfo semaphoreInfo{};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &batch.m_TransferComplete) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("VK_ResourceStreamer: failed to create semaphore!");
+            }
+
+            vkEndCommandBuffer(batch.m_TransferCommandBuffer);
+            VkSubmitInfo transferSubmitInfo{};
+            transferSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            transferSubmitInfo.commandBufferCount = 1;
+            transferSubmitInfo.pCommandBuffers = &batch.m_TransferCommandBuffer;
+            transferSubmitInfo.signalSemaphoreCount = 1;
+            transferSubmitInfo.pSignalSemaphores = &batch.m_TransferComplete;
+            if (vkQueueSubmit(m_Device.TransferQueue(), 1, &transferSubmitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("VK_ResourceStreamer: failed to submit to the transfer queue!");
+            }
+
+            // the acquire barriers wait for the copies
+            graphicsSubmitInfo.waitSemaphoreCount = 1;
+            graphicsSubmitInfo.pWaitSemaphores = &batch.m_TransferComplete;
+            graphicsSubmitInfo.pWaitDstStageMask = &waitStage;
+        }
+
+        vkEndCommandBuffer(batch.m_GraphicsCommandBuffer);
+        if (vkQueueSubmit(m_Device.GraphicsQueue(), 1, &graphicsSubmitInfo, batch.m_Fence) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_ResourceStreamer: failed to submit to the graphics queue!");
+        }
+
+        m_InFlight.push_back(std::move(batch));
+    }
+
+    void VK_ResourceStreamer::Publish(bool wait)
+    {
+        auto device = m_Device.Device();
+
+        // batches are retired in submission order, this frees the staging ring from its tail
+        while (!m_InFlight.empty())
+        {
+            auto& batch = m_InFlight.front();
+            if (wait)
+            {
+                vkWaitForFences(device, 1, &batch.m_Fence, VK_TRUE, UINT64_MAX);
+            }
+            if (vkGetFenceStatus(device, batch.m_Fence) != VK_SUCCESS)
+            {
+                break;
+            }
+
+            // from now on, VK_TextureTable::Resolve() returns the texture's own slot
+            for (auto& texture : batch.m_Textures)
+            {
+                m_TextureTable->Register(texture->m_TextureSlot, texture->m_Sampler, texture->m_TextureView, texture->m_ImageLayout);
+                m_PendingUploads--;
+            }
+            // from now on, the models bind their own buffers instead of the placeholder
+            for (auto& model : batch.m_Models)
+            {
+                model->m_Resident = true;
+                m_PendingUploads--;
+            }
+
+            vkDestroyFence(device, batch.m_Fence, nullptr);
+            vkFreeCommandBuffers(device, m_GraphicsCommandPool, 1, &batch.m_GraphicsCommandBuffer);
+            if (batch.m_TransferCommandBuffer != VK_NULL_HANDLE)
+            {
+                vkFreeCommandBuffers(device, m_TransferCommandPool, 1, &batch.m_TransferCommandBuffer);
+            }
+            if (batch.m_TransferComplete != VK_NULL_HANDLE)
+            {
+                vkDestroySemaphore(device, batch.m_TransferComplete, nullptr);
+            }
+
+            m_StagingUsed -= batch.m_StagingRingBytes;
+            if (!m_StagingUsed)
+            {
+                m_StagingHead = 0;
+            }
+            m_InFlight.pop_front();
+        }
+    }
+}
@@ -0,0 +1,180 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+#include "auxiliary/jobSystem.h"
+#include "renderer/textureCompressor.h"
+
+#include "renderer/model.h"
+
+#include "VKdevice.h"
+#include "VKbuffer.h"
+#include "VKtexture.h"
+#include "VKtextureTable.h"
+
+namespace GfxRenderEngine
+{
+    class VK_Model;
+
+    // Asynchronous texture and mesh loading: images are decoded (and block-compressed) on worker threads,
+    // textures and meshes are copied through a staging ring buffer on the transfer queue and handed over
+    // to the graphics queue with a queue family ownership transfer. A resource is published only after
+    // the fence of its upload has signaled: a texture is then registered in the texture table, until then
+    // its slot resolves to a placeholder; a mesh draws its bounding box until then (see VK_Model).
+    // Textures require the texture table (descriptor indexing), meshes do not.
+    class VK_ResourceStreamer
+    {
+
+    public:
+
+        static constexpr VkDeviceSize STAGING_RING_SIZE = 64 * 1024 * 1024;
+        // texel block size of all formats in use divides this (copy offset requirement)
+        static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+        // keeps Update() short, at least one resource is uploaded per frame
+        static constexpr VkDeviceSize MAX_UPLOAD_BYTES_PER_FRAME = 16 * 1024 * 1024;
+        // smaller meshes (sprites, particles, ...) are uploaded at once and never show a placeholder
+        static constexpr VkDeviceSize MIN_STREAMED_MESH_SIZE = 64 * 1024;
+
+    public:
+
+        // textureTable may be nullptr, then only meshes are streamed;
+        // the job system has to outlive the streamer, the destructor drains the decode jobs
+        VK_ResourceStreamer(VK_Device& device, VK_TextureTable* textureTable, JobSystem& jobSystem);
+        ~VK_ResourceStreamer();
+
+        VK_ResourceStreamer(const VK_ResourceStreamer&) = delete;
+        VK_ResourceStreamer& operator=(const VK_ResourceStreamer&) = delete;
+
+        bool StreamsTextures() const { return m_TextureTable != nullptr; }
+
+        // thread-safe, both return at once; the texture slot resolves to the placeholder until the upload is done
+        std::shared_ptr<VK_Texture> Load(const std::string& filepath, bool flip = true);
+        // takes over pixels with 3 or 4 channels; with compression, BC1 is promoted
+        // to BC3 for images that are not opaque
+        std::shared_ptr<VK_Texture> Load(uint width, uint height, uint channels, std::vector<uchar>&& pixels,
+                                         bool compress, TextureCompressor::Format format, bool sRGB);
+        // thread-safe, returns at once; the model has to be created with streamed = true
+        // and draws its placeholder until the upload is done
+        void Load(const std::shared_ptr<VK_Model>& model, const std::vector<Vertex>& vertices, const std::vector<uint>& indices);
+
+        // main thread, once per frame: publishes finished uploads and submits decoded images and meshes
+        void Update();
+        // blocks until all requested textures and meshes are published
+        void Flush();
+
+        uint GetPendingUploads() const { return m_PendingUploads.load(); }
+
+    private:
+
+        struct Request
+        {
+            std::shared_ptr<VK_Texture> m_Texture;
+            std::string m_Filepath;
+            bool m_Flip = true;
+            uint m_Width = 0;
+            uint m_Height = 0;
+            uint m_Channels = 4;
+            std::vector<uchar> m_Pixels;
+            bool m_Compress = false;
+            TextureCompressor::Format m_Format = TextureCompressor::Format::BC1;
+            bool m_sRGB = true;
+            TextureCompressor::CompressedImage m_CompressedImage;
+            bool m_Compressed = false;
+            bool m_Failed = false;
+
+            // mesh requests
+            std::shared_ptr<VK_Model> m_Model;
+            std::vector<Vertex> m_Vertices;
+            std::vector<uint> m_Indices;
+        };
+
+        struct Batch
+        {
+            VkCommandBuffer m_TransferCommandBuffer = VK_NULL_HANDLE;
+            VkCommandBuffer m_GraphicsCommandBuffer = VK_NULL_HANDLE;
+            VkSemaphore m_TransferComplete = VK_NULL_HANDLE;
+            VkFence m_Fence = VK_NULL_HANDLE;
+            VkDeviceSize m_StagingRingBytes = 0;
+            std::vector<std::unique_ptr<VK_Buffer>> m_StagingBuffers; // larger than the ring
+            std::vector<std::shared_ptr<VK_Texture>> m_Textures;
+            std::vector<std::shared_ptr<VK_Model>> m_Models;
+        };
+
+    private:
+
+        void Submit(std::shared_ptr<Request> request);
+        void Decode(Request& request);
+        void Publish(bool wait);
+        void UploadDecoded(VkDeviceSize budget);
+        bool Record(Request& request, Batch& batch);
+        void RecordTexture(Request& request, Batch& batch, VkBuffer stagingBuffer, VkDeviceSize stagingOffset);
+        void RecordMesh(Request& request, Batch& batch, VkBuffer stagingBuffer, VkDeviceSize stagingOffset);
+        void BeginBatch(Batch& batch);
+        void SubmitBatch(Batch& batch);
+        void RecordOwnershipTransfer(VkCommandBuffer commandBuffer, VK_Texture& texture, bool release);
+        bool AllocateStaging(VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize& allocatedBytes);
+        static VkDeviceSize GetStagingSize(const Request& request);
+        static VkDeviceSize GetIndexOffset(const Request& request);
+        static void WriteStaging(const Request& request, uchar* destination);
+        VkCommandBuffer BeginCommandBuffer(VkCommandPool commandPool);
+        VkCommandPool CreateCommandPool(uint queueFamily);
+
+    private:
+
+        VK_Device& m_Device;
+        VK_TextureTable* m_TextureTable;
+        JobSystem& m_JobSystem;
+        bool m_DedicatedTransferQueue;
+        uint m_TransferQueueFamily;
+        uint m_GraphicsQueueFamily;
+        VkCommandPool m_TransferCommandPool;
+        VkCommandPool m_GraphicsCommandPool;
+
+        std::shared_ptr<VK_Texture> m_Placeholder;
+
+        std::unique_ptr<VK_Buffer> m_StagingRing;
+        uchar* m_StagingMemory;
+        VkDeviceSize m_StagingHead;
+        VkDeviceSize m_StagingUsed;
+
+        // decoded on worker threads
+        JobCounter m_DecodeJobs;
+        std::mutex m_DecodedMutex;
+        std::vector<std::shared_ptr<Request>> m_Decoded;
+
+        // main thread only
+        std::deque<std::shared_ptr<Request>> m_UploadQueue;
+        std::deque<Batch> m_InFlight;
+        std::atomic<uint> m_PendingUploads;
+
+    };
+}
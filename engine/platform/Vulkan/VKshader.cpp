@@ -18,53 +18,174 @@
    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
-   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
 #include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
 #include <shaderc/shaderc.hpp>
 
 #include "engine.h"
 #include "auxiliary/file.h"
+#include "auxiliary/hash.h"
 
 #include "VKshader.h"
 
 namespace GfxRenderEngine
 {
 
-    VK_Shader::VK_Shader(const std::string& sourceFilepath, const std::string& spirvFilepath, bool optimize)
-        : m_SourceFilepath(sourceFilepath), m_SpirvFilepath(spirvFilepath), m_Optimize(optimize)
+    namespace
+    {
+        // resolves #include "file" relative to the including file
+        class ShaderIncluder : public shaderc::CompileOptions::IncluderInterface
+        {
+
+        public:
+
+            virtual shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type,
+                                                       const char* requestingSource, size_t includeDepth) override
+            {
+                auto include = new Include;
+                include->m_Filepath = (std::filesystem::path(requestingSource).parent_path() / requestedSource).generic_string();
+
+                std::ifstream in(include->m_Filepath, std::ios::in | std::ios::binary);
+                if (in)
+                {
+                    std::stringstream content;
+                    content << in.rdbuf();
+                    include->m_Content = content.str();
+                }
+                else
+                {
+                    // an empty source name tells shaderc that the include failed
+                    include->m_Content = "could not open include file " + include->m_Filepath;
+                    include->m_Filepath.clear();
+                }
+
+                include->m_Result.source_name = include->m_Filepath.c_str();
+                include->m_Result.source_name_length = include->m_Filepath.size();
+                include->m_Result.content = include->m_Content.c_str();
+                include->m_Result.content_length = include->m_Content.size();
+                include->m_Result.user_data = include;
+                return &include->m_Result;
+            }
+
+            virtual void ReleaseInclude(shaderc_include_result* data) override
+            {
+                delete static_cast<Include*>(data->user_data);
+            }
+
+        private:
+
+            struct Include
+            {
+                std::string m_Filepath;
+                std::string m_Content;
+                shaderc_include_result m_Result;
+            };
+
+        };
+    }
+
+    VK_Shader::VK_Shader(const std::string& sourceFilepath, const std::string& spirvFilepath, bool optimize, const Defines& defines)
+        : m_Optimize(optimize), m_Defines(defines),
+          m_SourceFilepath(sourceFilepath), m_SpirvFilepath(spirvFilepath),
+          m_Hash(0), m_Ok(false), m_Cached(false)
     {
 
         ReadFile();
-        Compile();
+        m_Hash = Hash();
+
+        std::string cacheFilepath = GetCacheFilepath();
+        if (EngineCore::FileExists(cacheFilepath))
+        {
+            m_Ok = EngineCore::CopyFile(cacheFilepath, m_SpirvFilepath);
+            m_Cached = m_Ok;
+        }
+
+        if (!m_Ok)
+        {
+            Compile();
+        }
 
     }
 
+    bool VK_Shader::ReadFile(const std::string& filepath, std::string& content)
+    {
+        std::ifstream in(filepath, std::ios::in | std::ios::binary);
+        if (!in)
+        {
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        content = buffer.str();
+        return true;
+    }
+
     void VK_Shader::ReadFile()
     {
-        std::string sourceCode;
-        std::ifstream in(m_SourceFilepath, std::ios::in | std::ios::binary);
-        if (in)
+        if (!ReadFile(m_SourceFilepath, m_SourceCode))
+        {
+            LOG_CORE_ERROR("VK_Shader: Could not open shader file '{0}'", m_SourceFilepath);
+        }
+    }
+
+    uint64 VK_Shader::Hash() const
+    {
+        uint64 hash = HashBuffer(m_SourceCode.data(), m_SourceCode.size());
+
+        std::size_t options = hash;
+        HashCombine(options, CACHE_VERSION, m_Optimize, EngineCore::GetFileExtension(m_SourceFilepath));
+        for (auto& define : m_Defines)
+        {
+            HashCombine(options, define.first, define.second);
+        }
+        hash = options;
+
+        HashIncludes(m_SourceCode, m_SourceFilepath, hash, 0);
+        return hash;
+    }
+
+    // folds the content of every (nested) include file into the hash
+    void VK_Shader::HashIncludes(const std::string& sourceCode, const std::string& sourceFilepath, uint64& hash, uint depth) const
+    {
+        if (depth > MAX_INCLUDE_DEPTH)
+        {
+            return;
+        }
+
+        std::istringstream lines(sourceCode);
+        std::string line;
+        while (std::getline(lines, line))
         {
-            in.seekg(0, std::ios::end);
-            size_t size = in.tellg();
-            if (size != -1)
+            size_t position = line.find_first_not_of(" \t");
+            if ((position == std::string::npos) || (line.compare(position, 8, "#include") != 0))
             {
-                sourceCode.resize(size);
-                in.seekg(0, std::ios::beg);
-                in.read(&sourceCode[0], size);
+                continue;
             }
-            else
+            size_t begin = line.find_first_of("\"<", position + 8);
+            size_t end = (begin == std::string::npos) ? std::string::npos : line.find_first_of("\">", begin + 1);
+            if (end == std::string::npos)
             {
-                LOG_CORE_ERROR("VK_Shader: Could not read shader file '{0}'", m_SourceFilepath);
+                continue;
             }
+
+            std::string includeFilepath = (std::filesystem::path(sourceFilepath).parent_path() /
+                                           line.substr(begin + 1, end - begin - 1)).generic_string();
+            std::string includeCode;
+            ReadFile(includeFilepath, includeCode);
+            hash = HashBuffer(includeCode.data(), includeCode.size(), hash);
+            HashIncludes(includeCode, includeFilepath, hash, depth + 1);
         }
-        else
-        {
-            LOG_CORE_ERROR("VK_Shader: Could not open shader file '{0}'", m_SourceFilepath);
-        }
+    }
 
-        m_SourceCode = sourceCode;
+    std::string VK_Shader::GetCacheFilepath() const
+    {
+        std::stringstream filepath;
+        filepath << CACHE_DIRECTORY << std::hex << std::setw(16) << std::setfill('0') << m_Hash << ".spv";
+        return filepath.str();
     }
 
     void VK_Shader::Compile()
@@ -76,6 +197,11 @@ namespace GfxRenderEngine
         m_Ok = false;
 
         options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2); // 1.3?
+        options.SetIncluder(std::make_unique<ShaderIncluder>());
+        for (auto& define : m_Defines)
+        {
+            options.AddMacroDefinition(define.first, define.second);
+        }
 
         if (m_Optimize)
         {
@@ -112,6 +238,30 @@ namespace GfxRenderEngine
             outputFile.write((char*)buffer.data(), buffer.size() * sizeof(uint));
             outputFile.flush();
             m_Ok = true;
+
+            // write to a temporary file first so that a crash or another process never leaves a partial cache entry behind
+            std::string cacheFilepath = GetCacheFilepath();
+            std::string tmpFilepath = EngineCore::GetTemporaryFilepath(cacheFilepath);
+            bool written = false;
+            {
+                std::ofstream cacheFile(tmpFilepath, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (cacheFile.is_open())
+                {
+                    cacheFile.write((char*)buffer.data(), buffer.size() * sizeof(uint));
+                    written = cacheFile.good();
+                }
+            }
+
+            std::error_code errorCode;
+            if (written)
+            {
+                std::filesystem::rename(tmpFilepath, cacheFilepath, errorCode);
+            }
+            if (!written || errorCode)
+            {
+                LOG_CORE_WARN("VK_Shader: Could not write shader cache entry {0}", cacheFilepath);
+                std::filesystem::remove(tmpFilepath, errorCode);
+            }
         }
     }
 }
@@ -18,34 +18,60 @@
    IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
    CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
-   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.*/
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
 #pragma once
 
 #include <string>
+#include <vector>
+#include <utility>
+
+#include "engine.h"
 
 namespace GfxRenderEngine
 {
+    // compiles GLSL to SPIR-V; results are cached in bin/cache/shaders/,
+    // keyed by a hash of the source, its include files, the defines and the compile options
     class VK_Shader
     {
     public:
-        VK_Shader(const std::string& sourceFilepath, const std::string& spirvFilepath, bool optimize = true);
+
+        using Defines = std::vector<std::pair<std::string, std::string>>;
+
+    public:
+        VK_Shader(const std::string& sourceFilepath, const std::string& spirvFilepath,
+                  bool optimize = true, const Defines& defines = {});
         ~VK_Shader() {}
 
         bool IsOk() const { return m_Ok; }
+        bool WasCached() const { return m_Cached; }
+
+        static constexpr const char* CACHE_DIRECTORY = "bin/cache/shaders/";
 
     private:
 
+        // bump to invalidate all cached shaders, e.g. after a shaderc update
+        static constexpr uint CACHE_VERSION = 1;
+        static constexpr uint MAX_INCLUDE_DEPTH = 16;
+
         void ReadFile();
         void Compile();
+        uint64 Hash() const;
+        void HashIncludes(const std::string& sourceCode, const std::string& sourceFilepath, uint64& hash, uint depth) const;
+        std::string GetCacheFilepath() const;
+
+        static bool ReadFile(const std::string& filepath, std::string& content);
 
     private:
 
         bool m_Optimize;
+        Defines m_Defines;
         std::string m_SourceFilepath;
         std::string m_SpirvFilepath;
         std::string m_SourceCode;
+        uint64 m_Hash;
         bool m_Ok;
+        bool m_Cached;
 
     };
 }
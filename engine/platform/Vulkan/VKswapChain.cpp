@@ -28,13 +28,13 @@ namespace GfxRenderEngine
 {
 
     VK_SwapChain::VK_SwapChain(std::shared_ptr<VK_Device> device, VkExtent2D extent)
-        : m_Device{device}, m_WindowExtent{extent}
+        : m_Device{device}, m_WindowExtent{extent}, m_SwapChain{VK_NULL_HANDLE}
     {
         Init();
     }
 
     VK_SwapChain::VK_SwapChain(std::shared_ptr<VK_Device> device, VkExtent2D extent, std::shared_ptr<VK_SwapChain> previous)
-        : m_Device{device}, m_WindowExtent{extent}, m_OldSwapChain{previous}
+        : m_Device{device}, m_OldSwapChain{previous}, m_WindowExtent{extent}, m_SwapChain{VK_NULL_HANDLE}
     {
         Init();
         m_OldSwapChain.reset();
@@ -42,7 +42,14 @@ namespace GfxRenderEngine
 
     void VK_SwapChain::Init()
     {
-        CreateSwapChain();
+        if (m_Device->IsHeadless())
+        {
+            CreateOffscreenImages();
+        }
+        else
+        {
+            CreateSwapChain();
+        }
         CreateImageViews();
         CreateRenderPass();
         CreateDepthResources();
@@ -64,6 +71,12 @@ namespace GfxRenderEngine
             m_SwapChain = nullptr;
         }
 
+        for (int i = 0; i < m_OffscreenImageMemorys.size(); i++)
+        {
+            vkDestroyImage(m_Device->Device(), m_SwapChainImages[i], nullptr);
+            vkFreeMemory(m_Device->Device(), m_OffscreenImageMemorys[i], nullptr);
+        }
+
         for (int i = 0; i < m_DepthImages.size(); i++)
         {
             vkDestroyImageView(m_Device->Device(), m_DepthImageViews[i], nullptr);
@@ -89,12 +102,20 @@ namespace GfxRenderEngine
 
     VkResult VK_SwapChain::AcquireNextImage(uint *imageIndex)
     {
+    auto waitStart = std::chrono::steady_clock::now();
     vkWaitForFences(
         m_Device->Device(),
         1,
         &m_InFlightFences[m_CurrentFrame],
         VK_TRUE,
         std::numeric_limits<uint64>::max());
+    m_FenceWaitTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+
+    if (m_Device->IsHeadless())
+    {
+        *imageIndex = static_cast<uint>(m_CurrentFrame);
+        return VK_SUCCESS;
+    }
 
     VkResult result = vkAcquireNextImageKHR(
         m_Device->Device(),
@@ -112,16 +133,21 @@ namespace GfxRenderEngine
     {
         if (m_ImagesInFlight[*imageIndex] != VK_NULL_HANDLE)
         {
+            auto waitStart = std::chrono::steady_clock::now();
             vkWaitForFences(m_Device->Device(), 1, &m_ImagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
+            m_FenceWaitTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
         }
         m_ImagesInFlight[*imageIndex] = m_InFlightFences[m_CurrentFrame];
 
         VkSubmitInfo submitInfo = {};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
+        // offscreen images are not acquired or presented
+        bool headless = m_Device->IsHeadless();
+
         VkSemaphore waitSemaphores[] = {m_ImageAvailableSemaphores[m_CurrentFrame]};
         VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.waitSemaphoreCount = headless ? 0 : 1;
         submitInfo.pWaitSemaphores = waitSemaphores;
         submitInfo.pWaitDstStageMask = waitStages;
 
@@ -129,7 +155,7 @@ namespace GfxRenderEngine
         submitInfo.pCommandBuffers = buffers;
 
         VkSemaphore signalSemaphores[] = {m_RenderFinishedSemaphores[m_CurrentFrame]};
-        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.signalSemaphoreCount = headless ? 0 : 1;
         submitInfo.pSignalSemaphores = signalSemaphores;
 
         vkResetFences(m_Device->Device(), 1, &m_InFlightFences[m_CurrentFrame]);
@@ -138,6 +164,12 @@ namespace GfxRenderEngine
             LOG_CORE_CRITICAL("failed to submit draw command buffer!");
         }
 
+        if (headless)
+        {
+            m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+            return VK_SUCCESS;
+        }
+
         VkPresentInfoKHR presentInfo = {};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
@@ -225,6 +257,41 @@ namespace GfxRenderEngine
         m_SwapChainExtent = extent;
     }
 
+    void VK_SwapChain::CreateOffscreenImages()
+    {
+        // one color image per frame in flight
+        uint imageCount = MAX_FRAMES_IN_FLIGHT;
+        m_SwapChainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+        m_SwapChainExtent = m_WindowExtent;
+
+        m_SwapChainImages.resize(imageCount);
+        m_OffscreenImageMemorys.resize(imageCount);
+        for (uint i = 0; i < imageCount; i++)
+        {
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.extent.width = m_SwapChainExtent.width;
+            imageInfo.extent.height = m_SwapChainExtent.height;
+            imageInfo.extent.depth = 1;
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.format = m_SwapChainImageFormat;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.flags = 0;
+
+            m_Device->CreateImageWithInfo(
+                imageInfo,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                m_SwapChainImages[i],
+                m_OffscreenImageMemorys[i]);
+        }
+    }
+
     void VK_SwapChain::CreateImageViews()
     {
         m_SwapChainImageViews.resize(m_SwapChainImages.size());
@@ -273,7 +340,7 @@ namespace GfxRenderEngine
         colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        colorAttachment.finalLayout = m_Device->IsHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
         VkAttachmentReference colorAttachmentRef = {};
         colorAttachmentRef.attachment = 0;
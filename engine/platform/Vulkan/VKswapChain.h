@@ -25,12 +25,14 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <chrono>
 #include <vulkan/vulkan.h>
 
 #include "VKdevice.h"
 
 namespace GfxRenderEngine
 {
+    // on a headless device, the swap chain renders into offscreen images and nothing is presented
     class VK_SwapChain
     {
 
@@ -63,10 +65,13 @@ namespace GfxRenderEngine
         VkResult AcquireNextImage(uint *imageIndex);
         VkResult SubmitCommandBuffers(const VkCommandBuffer *buffers, uint *imageIndex);
         bool CompareSwapFormats(const VK_SwapChain& swapChain) const;
+        // milliseconds spent in vkWaitForFences since the last AcquireNextImage()
+        float GetFenceWaitTime() const { return m_FenceWaitTime; }
 
     private:
         void Init();
         void CreateSwapChain();
+        void CreateOffscreenImages();
         void CreateImageViews();
         void CreateDepthResources();
         void CreateRenderPass();
@@ -90,6 +95,7 @@ namespace GfxRenderEngine
         std::vector<VkImageView> m_DepthImageViews;
         std::vector<VkImage> m_SwapChainImages;
         std::vector<VkImageView> m_SwapChainImageViews;
+        std::vector<VkDeviceMemory> m_OffscreenImageMemorys;
 
         std::shared_ptr<VK_Device> m_Device;
         std::shared_ptr<VK_SwapChain> m_OldSwapChain;
@@ -102,5 +108,6 @@ namespace GfxRenderEngine
         std::vector<VkFence> m_InFlightFences;
         std::vector<VkFence> m_ImagesInFlight;
         size_t m_CurrentFrame = 0;
+        float m_FenceWaitTime = 0.0f;
     };
 }
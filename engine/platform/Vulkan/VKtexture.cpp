@@ -21,12 +21,19 @@
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
 #include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
 
 #include "stb_image.h"
 #include "core.h"
+#include "auxiliary/assetSystem.h"
+#include "renderer/imageConversion.h"
 
 #include "VKcore.h"
+#include "VKbuffer.h"
 #include "VKtexture.h"
+#include "VKrenderer.h"
 
 namespace GfxRenderEngine
 {
@@ -34,8 +41,9 @@ namespace GfxRenderEngine
     VK_Texture::VK_Texture(std::shared_ptr<TextureSlotManager> textureSlotManager)
         : m_FileName(""), m_RendererID(0), m_LocalBuffer(nullptr), m_Type(0),
           m_Width(0), m_Height(0), m_BytesPerPixel(0), m_InternalFormat(0),
-          m_DataFormat(0), m_MipLevels(1),
-          m_TextureSlotManager(textureSlotManager)
+          m_DataFormat(0), m_MipLevels(1), m_Atlas(false), m_Format(VK_FORMAT_R8G8B8A8_SRGB),
+          m_TextureSlotManager(textureSlotManager), m_TextureImage(VK_NULL_HANDLE),
+          m_Sampler(VK_NULL_HANDLE), m_TextureView(VK_NULL_HANDLE)
     {
         m_TextureSlot = m_TextureSlotManager->GetTextureSlot();
     }
@@ -43,18 +51,22 @@ namespace GfxRenderEngine
     VK_Texture::~VK_Texture()
     {
         auto device = VK_Core::m_Device->Device();
+        if (VK_Renderer::m_TextureTable)
+        {
+            VK_Renderer::m_TextureTable->Unregister(m_TextureSlot);
+        }
         m_TextureSlotManager->RemoveTextureSlot(m_TextureSlot);
 
         vkDeviceWaitIdle(device);
-        vkDestroyImage(device, m_TextureImage, nullptr);
         vkDestroyImageView(device, m_TextureView, nullptr);
         vkDestroySampler(device, m_Sampler, nullptr);
-        vkFreeMemory(device, m_TextureImageMemory, nullptr);
+        VK_Core::m_Device->DestroyImage(m_TextureImage, m_TextureImageAllocation);
     }
 
     VK_Texture::VK_Texture(std::shared_ptr<TextureSlotManager> textureSlotManager, uint ID, int internalFormat, int dataFormat, int type)
         : m_TextureSlotManager{textureSlotManager}, m_RendererID{ID}, m_InternalFormat{internalFormat},
-          m_DataFormat{dataFormat}, m_Type{type}
+          m_DataFormat{dataFormat}, m_Type{type}, m_MipLevels{1}, m_Atlas{false}, m_Format{VK_FORMAT_R8G8B8A8_SRGB},
+          m_TextureImage{VK_NULL_HANDLE}, m_Sampler{VK_NULL_HANDLE}, m_TextureView{VK_NULL_HANDLE}
     {
         m_TextureSlot = m_TextureSlotManager->GetTextureSlot();
     }
@@ -76,14 +88,97 @@ namespace GfxRenderEngine
         return ok;
     }
 
+    // create texture from raw memory, sRGB or linear (e.g. normal maps)
+    bool VK_Texture::Init(const uint width, const uint height, const void* data, bool sRGB, uint channels)
+    {
+        m_Format = sRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        if (channels == 4)
+        {
+            return Init(width, height, data);
+        }
+
+        m_FileName = "raw memory";
+        m_LocalBuffer = (uchar*)data;
+        if (!m_LocalBuffer || (channels != 3))
+        {
+            LOG_CORE_CRITICAL("VK_Texture::Init: unsupported image ({0} channels)", channels);
+            return false;
+        }
+        m_Width = width;
+        m_Height = height;
+        m_BytesPerPixel = 4;
+        return Create(channels);
+    }
+
+    // create block-compressed texture from raw memory
+    bool VK_Texture::InitCompressed(const uint width, const uint height, const void* data, TextureCompressor::Format format, bool sRGB, uint channels)
+    {
+        m_FileName = "raw memory";
+        if (!data || ((channels != 3) && (channels != 4)))
+        {
+            return false;
+        }
+
+        m_Width = width;
+        m_Height = height;
+        m_BytesPerPixel = 4;
+
+        if (!VK_Core::m_Device->SupportsBCTextures())
+        {
+            m_Format = sRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+            m_LocalBuffer = (uchar*)data;
+            return Create(channels);
+        }
+
+        // the compressor reads RGBA
+        const uchar* rgba = static_cast<const uchar*>(data);
+        std::vector<uchar> expanded;
+        if (channels == 3)
+        {
+            expanded.resize(static_cast<size_t>(width) * height * 4);
+            ImageConversion::RGBToRGBA(rgba, expanded.data(), static_cast<size_t>(width) * height);
+            rgba = expanded.data();
+        }
+
+        TextureCompressor::CompressedImage image;
+        if (!TextureCompressor::GetCompressedImage(rgba, width, height, format, sRGB, image))
+        {
+            LOG_CORE_CRITICAL("failed to compress texture image!");
+            return false;
+        }
+        m_Format = GetCompressedFormat(format, sRGB);
+        return CreateCompressed(image);
+    }
+
+    VkFormat VK_Texture::GetCompressedFormat(TextureCompressor::Format format, bool sRGB)
+    {
+        switch (format)
+        {
+            case TextureCompressor::Format::BC1:
+                return sRGB ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            case TextureCompressor::Format::BC3:
+                return sRGB ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            case TextureCompressor::Format::BC5:
+                // two linear channels, there is no sRGB variant
+                return VK_FORMAT_BC5_UNORM_BLOCK;
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
     // create texture from file on disk
     bool VK_Texture::Init(const std::string& fileName, bool flip)
     {
         bool ok = false;
         int channels_in_file;
-        stbi_set_flip_vertically_on_load(flip);
+        // the per-thread flag overrides the global one once set, so every loader sets it explicitly
+        stbi_set_flip_vertically_on_load_thread(flip);
         m_FileName = fileName;
-        m_LocalBuffer = stbi_load(m_FileName.c_str(), &m_Width, &m_Height, &m_BytesPerPixel, 4);
+        m_Atlas = true;
+        AssetData fileData;
+        if (AssetSystem::Load(m_FileName, fileData))
+        {
+            m_LocalBuffer = stbi_load_from_memory(fileData.Data(), static_cast<int>(fileData.Size()), &m_Width, &m_Height, &m_BytesPerPixel, 4);
+        }
 
         if(m_LocalBuffer)
         {
@@ -102,8 +197,9 @@ namespace GfxRenderEngine
     {
         bool ok = false;
         int channels_in_file;
-        stbi_set_flip_vertically_on_load(true);
+        stbi_set_flip_vertically_on_load_thread(true);
         m_FileName = "file in memory";
+        m_Atlas = true;
         m_LocalBuffer = stbi_load_from_memory(data, length, &m_Width, &m_Height, &m_BytesPerPixel, 4);
 
         if(m_LocalBuffer)
@@ -138,7 +234,7 @@ namespace GfxRenderEngine
         barrier.image = image;
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.levelCount = m_MipLevels;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
 
@@ -183,11 +279,9 @@ namespace GfxRenderEngine
     (
         uint width, uint height, VkFormat format, VkImageTiling tiling,
         VkImageUsageFlags usage, VkMemoryPropertyFlags properties, 
-        VkImage& image, VkDeviceMemory& imageMemory
+        VkImage& image, VK_Allocation& imageAllocation
     )
     {
-        auto device = VK_Core::m_Device->Device();
-
         VkImageCreateInfo imageInfo{};
         imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -203,70 +297,133 @@ namespace GfxRenderEngine
         imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
         imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        {
-            auto result = vkCreateImage(device, &imageInfo, nullptr, &image);
-            if (result != VK_SUCCESS)
-            {
-                LOG_CORE_CRITICAL("failed to create image!");
-            }
-        }
-
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(device, image, &memRequirements);
+        // sub-allocated from a shared memory block
+        VK_Core::m_Device->CreateImage(imageInfo, properties, image, imageAllocation);
+    }
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = VK_Core::m_Device->FindMemoryType(memRequirements.memoryTypeBits, properties);
+    bool VK_Texture::SupportsLinearBlit(VkFormat format)
+    {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(VK_Core::m_Device->PhysicalDevice(), format, &formatProperties);
 
-        {
-            auto result = vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory);
-            if (result != VK_SUCCESS)
-            {
-                LOG_CORE_CRITICAL("failed to allocate image memory!");
-            }
-        }
+        VkFormatFeatureFlags required =
+            VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+            VK_FORMAT_FEATURE_BLIT_DST_BIT |
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
 
-        vkBindImageMemory(device, image, imageMemory, 0);
+        return (formatProperties.optimalTilingFeatures & required) == required;
     }
 
-    void VK_Texture::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+    void VK_Texture::GenerateMipmaps()
     {
-        auto device = VK_Core::m_Device->Device();
-
-        VkBufferCreateInfo bufferInfo{};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = size;
-        bufferInfo.usage = usage;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkCommandBuffer commandBuffer = VK_Core::m_Device->BeginSingleTimeCommands();
+        RecordMipmaps(commandBuffer);
+        VK_Core::m_Device->EndSingleTimeCommands(commandBuffer);
+    }
 
-        if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
-        {
-            LOG_CORE_CRITICAL("failed to create buffer!");
-        }
+    // all levels must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    // each level is blitted from the previous one at half the size
+    void VK_Texture::RecordMipmaps(VkCommandBuffer commandBuffer)
+    {
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.image = m_TextureImage;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        barrier.subresourceRange.levelCount = 1;
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = VK_Core::m_Device->FindMemoryType(memRequirements.memoryTypeBits, properties);
+        int mipWidth = m_Width;
+        int mipHeight = m_Height;
 
+        for (uint level = 1; level < m_MipLevels; level++)
         {
-            auto result = vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory);
-            if (result != VK_SUCCESS)
-            {
-                LOG_CORE_CRITICAL("failed to allocate buffer memory!");
-            }
+            // previous level: transfer destination -> blit source
+            barrier.subresourceRange.baseMipLevel = level - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            vkCmdPipelineBarrier
+            (
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier
+            );
+
+            int nextWidth  = mipWidth  > 1 ? mipWidth  / 2 : 1;
+            int nextHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+
+            VkImageBlit blit{};
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = level - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = 1;
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {nextWidth, nextHeight, 1};
+            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.dstSubresource.mipLevel = level;
+            blit.dstSubresource.baseArrayLayer = 0;
+            blit.dstSubresource.layerCount = 1;
+
+            vkCmdBlitImage
+            (
+                commandBuffer,
+                m_TextureImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                m_TextureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1, &blit,
+                VK_FILTER_LINEAR
+            );
+
+            // previous level is done: blit source -> shader read
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+            vkCmdPipelineBarrier
+            (
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                0,
+                0, nullptr,
+                0, nullptr,
+                1, &barrier
+            );
+
+            mipWidth = nextWidth;
+            mipHeight = nextHeight;
         }
 
-        vkBindBufferMemory(device, buffer, bufferMemory, 0);
+        // last level was only written to
+        barrier.subresourceRange.baseMipLevel = m_MipLevels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier
+        (
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier
+        );
     }
 
-    bool VK_Texture::Create()
+    bool VK_Texture::Create(uint channels)
     {
-        auto device = VK_Core::m_Device->Device();
 
         VkDeviceSize imageSize = m_Width * m_Height * 4;
 
@@ -276,73 +433,194 @@ namespace GfxRenderEngine
             return false;
         }
 
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingBufferMemory;
-        CreateBuffer
+        auto stagingBuffer = std::make_unique<VK_Buffer>
         (
-            imageSize, 
+            *VK_Core::m_Device, imageSize, 1,
             VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer,
-            stagingBufferMemory
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
         );
+        stagingBuffer->Map();
+        if (channels == 3)
+        {
+            // expanded in place, there is no intermediate RGBA copy
+            ImageConversion::RGBToRGBA(m_LocalBuffer, static_cast<uchar*>(stagingBuffer->GetMappedMemory()), static_cast<size_t>(m_Width) * m_Height);
+        }
+        else
+        {
+            stagingBuffer->WriteToBuffer((void*)m_LocalBuffer);
+        }
+        stagingBuffer->Unmap();
 
-        void* data;
-
-        vkMapMemory(device, stagingBufferMemory, 0, imageSize, 0, &data);
-            memcpy(data, m_LocalBuffer, static_cast<size_t>(imageSize));
-        vkUnmapMemory(device, stagingBufferMemory);
+        // full mip chain if the format can be blitted with linear filtering, atlases have none
+        m_MipLevels = 1;
+        if (!m_Atlas && SupportsLinearBlit(m_Format))
+        {
+            m_MipLevels = static_cast<uint>(std::floor(std::log2(std::max(m_Width, m_Height)))) + 1;
+        }
 
         CreateImage
         (
             m_Width,
             m_Height,
-            VK_FORMAT_R8G8B8A8_SRGB,
+            m_Format,
             VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             m_TextureImage,
-            m_TextureImageMemory
+            m_TextureImageAllocation
         );
 
         TransitionImageLayout
         (
             m_TextureImage,
-            VK_FORMAT_R8G8B8A8_SRGB,
+            m_Format,
             VK_IMAGE_LAYOUT_UNDEFINED,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
         );
 
         VK_Core::m_Device->CopyBufferToImage
         (
-            stagingBuffer,
+            stagingBuffer->GetBuffer(),
             m_TextureImage, 
             static_cast<uint>(m_Width), 
             static_cast<uint>(m_Height),
             1
         );
 
+        if (m_MipLevels > 1)
+        {
+            // leaves all levels in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            GenerateMipmaps();
+        }
+        else
+        {
+            TransitionImageLayout
+            (
+                m_TextureImage,
+                m_Format,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            );
+        }
+        m_ImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        // freed right away, or once the current upload batch has completed
+        VK_Core::m_Device->ReleaseAfterUpload(std::move(stagingBuffer));
+
+        CreateSamplerAndImageView();
+
+        // make the texture available to shaders at its slot
+        if (VK_Renderer::m_TextureTable)
+        {
+            VK_Renderer::m_TextureTable->Register(m_TextureSlot, m_Sampler, m_TextureView, m_ImageLayout);
+        }
+
+        return true;
+    }
+
+    // the mip chain including level 0 is taken from the compressed image
+    bool VK_Texture::CreateCompressed(const TextureCompressor::CompressedImage& image)
+    {
+        m_Width = image.m_Width;
+        m_Height = image.m_Height;
+        m_MipLevels = static_cast<uint>(image.m_MipLevels.size());
+
+        auto stagingBuffer = std::make_unique<VK_Buffer>
+        (
+            *VK_Core::m_Device, image.m_Data.size(), 1,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        stagingBuffer->Map();
+        stagingBuffer->WriteToBuffer((void*)image.m_Data.data());
+        stagingBuffer->Unmap();
+
+        CreateImage
+        (
+            m_Width,
+            m_Height,
+            m_Format,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            m_TextureImage,
+            m_TextureImageAllocation
+        );
+
         TransitionImageLayout
         (
             m_TextureImage,
-            VK_FORMAT_R8G8B8A8_SRGB,
+            m_Format,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+        );
+
+        {
+            std::vector<VkBufferImageCopy> regions(m_MipLevels);
+            for (uint level = 0; level < m_MipLevels; level++)
+            {
+                auto& region = regions[level];
+                region = {};
+                region.bufferOffset = image.m_MipLevels[level].m_Offset;
+                region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.mipLevel = level;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = {0, 0, 0};
+                region.imageExtent = {image.m_MipLevels[level].m_Width, image.m_MipLevels[level].m_Height, 1};
+            }
+
+            VkCommandBuffer commandBuffer = VK_Core::m_Device->BeginSingleTimeCommands();
+            vkCmdCopyBufferToImage
+            (
+                commandBuffer,
+                stagingBuffer->GetBuffer(),
+                m_TextureImage,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<uint>(regions.size()),
+                regions.data()
+            );
+            VK_Core::m_Device->EndSingleTimeCommands(commandBuffer);
+        }
+
+        TransitionImageLayout
+        (
+            m_TextureImage,
+            m_Format,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
         );
         m_ImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        vkDestroyBuffer(device, stagingBuffer, nullptr);
-        vkFreeMemory(device, stagingBufferMemory, nullptr);
+        // freed right away, or once the current upload batch has completed
+        VK_Core::m_Device->ReleaseAfterUpload(std::move(stagingBuffer));
+
+        CreateSamplerAndImageView();
+
+        // make the texture available to shaders at its slot
+        if (VK_Renderer::m_TextureTable)
+        {
+            VK_Renderer::m_TextureTable->Register(m_TextureSlot, m_Sampler, m_TextureView, m_ImageLayout);
+        }
+
+        return true;
+    }
 
-                // Create a texture sampler
+    void VK_Texture::CreateSamplerAndImageView()
+    {
+        auto device = VK_Core::m_Device->Device();
+
+        // Create a texture sampler
         // In Vulkan, textures are accessed by samplers
         // This separates sampling information from texture data.
         // This means you could have multiple sampler objects for the same texture with different settings
         // Note: Similar to the samplers available with OpenGL 3.3
         VkSamplerCreateInfo sampler{};
         sampler.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        // trilinear minification, magnification stays nearest (pixel art sprites);
+        // atlases stay nearest, linear filtering would blend in texels of neighboring sprites
         sampler.magFilter = VK_FILTER_NEAREST;
-        sampler.minFilter = VK_FILTER_NEAREST;
+        sampler.minFilter = m_Atlas ? VK_FILTER_NEAREST : VK_FILTER_LINEAR;
         sampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
         sampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
         sampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
@@ -350,7 +628,7 @@ namespace GfxRenderEngine
         sampler.mipLodBias = 0.0f;
         sampler.compareOp = VK_COMPARE_OP_NEVER;
         sampler.minLod = 0.0f;
-        sampler.maxLod = 0.0f;
+        sampler.maxLod = static_cast<float>(m_MipLevels - 1);
         sampler.maxAnisotropy = 1.0;
         sampler.anisotropyEnable = VK_FALSE;
         sampler.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
@@ -371,7 +649,7 @@ namespace GfxRenderEngine
         VkImageViewCreateInfo view {};
         view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         view.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        view.format = VK_FORMAT_R8G8B8A8_SRGB;
+        view.format = m_Format;
         view.components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
         // A subresource range describes the set of mip levels (and array layers) that can be accessed through this image view
         // It's possible to create multiple image views for a single image referring to different (and/or overlapping) ranges of the image
@@ -381,7 +659,7 @@ namespace GfxRenderEngine
         view.subresourceRange.layerCount = 1;
         // Linear tiling usually won't support mip maps
         // Only set mip map count if optimal tiling is used
-        view.subresourceRange.levelCount = 1;
+        view.subresourceRange.levelCount = m_MipLevels;
         // The view will be based on the texture's image
         view.image = m_TextureImage;
 
@@ -392,8 +670,6 @@ namespace GfxRenderEngine
                 LOG_CORE_CRITICAL("failed to create image view!");
             }
         }
-
-        return true;
     }
 
     void VK_Texture::Bind() const
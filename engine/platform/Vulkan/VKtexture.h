@@ -26,6 +26,7 @@
 
 #include "engine.h"
 #include "renderer/texture.h"
+#include "renderer/textureCompressor.h"
 
 #include "VKdevice.h"
 #include "VKtextureSlotManager.h"
@@ -41,9 +42,16 @@ namespace GfxRenderEngine
         ~VK_Texture();
 
         virtual bool Init(const uint width, const uint height, const void* data) override;
+        // RGB images (channels = 3) are expanded to RGBA while they are written to the staging buffer
+        bool Init(const uint width, const uint height, const void* data, bool sRGB, uint channels = 4);
+        // images from files are sprite sheets and the font atlas: no mips and nearest filtering,
+        // so neighboring sprites and glyphs do not bleed into each other
         virtual bool Init(const std::string& fileName, bool flip = true) override;
         virtual bool Init(const unsigned char* data, int length) override;
         virtual bool Init(const uint width, const uint height, const uint rendererID) override;
+        // block-compressed upload of an RGB or RGBA image, the compressed mip chain comes from the texture cache;
+        // without device support for BC formats the image is uploaded uncompressed (sRGB or linear)
+        bool InitCompressed(const uint width, const uint height, const void* data, TextureCompressor::Format format, bool sRGB, uint channels = 4);
         virtual void Bind() const override;
         virtual void Unbind() const override;
         virtual int GetWidth() const override { return m_Width; }
@@ -57,14 +65,17 @@ namespace GfxRenderEngine
 
     private:
 
-        bool Create();
-        void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, 
-                          VkMemoryPropertyFlags properties, VkBuffer& buffer,
-                          VkDeviceMemory& bufferMemory);
+        bool Create(uint channels = 4);
+        bool CreateCompressed(const TextureCompressor::CompressedImage& image);
+        void CreateSamplerAndImageView();
+        static VkFormat GetCompressedFormat(TextureCompressor::Format format, bool sRGB);
         void CreateImage(uint width, uint height, VkFormat format, VkImageTiling tiling,
                          VkImageUsageFlags usage, VkMemoryPropertyFlags properties, 
-                         VkImage& image, VkDeviceMemory& imageMemory);
+                         VkImage& image, VK_Allocation& imageAllocation);
         void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
+        bool SupportsLinearBlit(VkFormat format);
+        void GenerateMipmaps();
+        void RecordMipmaps(VkCommandBuffer commandBuffer);
 
     private:
 
@@ -73,13 +84,15 @@ namespace GfxRenderEngine
         int m_Width, m_Height, m_BytesPerPixel;
         int m_TextureSlot;
         uint m_MipLevels;
+        bool m_Atlas;
+        VkFormat m_Format;
         std::shared_ptr<TextureSlotManager> m_TextureSlotManager;
 
         int m_InternalFormat, m_DataFormat;
         int m_Type;
 
         VkImage m_TextureImage;
-        VkDeviceMemory m_TextureImageMemory;
+        VK_Allocation m_TextureImageAllocation;
 
         public:
 
@@ -87,5 +100,10 @@ namespace GfxRenderEngine
         VkImageView m_TextureView;
         VkImageLayout m_ImageLayout;
 
+    private:
+
+        // records uploads of streamed textures
+        friend class VK_ResourceStreamer;
+
     };
 }
@@ -24,39 +24,39 @@
 
 namespace GfxRenderEngine
 {
-    static constexpr int INITIAL_SLOT = 1;
-
     VKTextureSlotManager::VKTextureSlotManager()
     {
-        uint maxTextureSlots = 1024;
-        m_TextureSlots.resize(maxTextureSlots);
-        for(auto slot : m_TextureSlots)
+        m_TextureSlots.resize(MAX_TEXTURE_SLOTS, false);
+
+        // free list as a stack, the lowest slot on top
+        m_FreeSlots.reserve(MAX_TEXTURE_SLOTS - 1);
+        for (uint slot = MAX_TEXTURE_SLOTS - 1; slot > INVALID_SLOT; slot--)
         {
-            slot = false;
+            m_FreeSlots.push_back(slot);
         }
     }
 
     uint VKTextureSlotManager::GetTextureSlot()
     {
-        uint textureSlot = INITIAL_SLOT;
-        for(auto slot : m_TextureSlots)
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_FreeSlots.empty())
         {
-            if(!slot)
-            {
-                slot = true;
-                return textureSlot;
-            }
-            textureSlot++;
+            LOG_CORE_CRITICAL("no free texture slot found");
+            return INVALID_SLOT;
         }
-        LOG_APP_CRITICAL("no free texture slot found");
-        return INITIAL_SLOT - 1;
+        uint slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+        m_TextureSlots[slot] = true;
+        return slot;
     }
 
     void VKTextureSlotManager::RemoveTextureSlot(uint slot)
     {
-        if ((slot >= INITIAL_SLOT) && (slot < m_TextureSlots.size()))
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if ((slot > INVALID_SLOT) && (slot < MAX_TEXTURE_SLOTS) && m_TextureSlots[slot])
         {
-            m_TextureSlots[slot-1] = false;
+            m_TextureSlots[slot] = false;
+            m_FreeSlots.push_back(slot);
         }
     }
 }
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
 #include "engine.h"
@@ -30,19 +31,28 @@
 namespace GfxRenderEngine
 {
 
+    // slots index the global texture table (see VK_TextureTable); slot 0 is never handed out
     class VKTextureSlotManager : public TextureSlotManager
     {
 
+    public:
+
+        static constexpr uint MAX_TEXTURE_SLOTS = 1024;
+        static constexpr uint INVALID_SLOT = 0;
+
     public:
 
         VKTextureSlotManager();
 
+        // O(1), thread-safe
         virtual uint GetTextureSlot() override;
         virtual void RemoveTextureSlot(uint slot) override;
 
     private:
 
-        std::vector<bool> m_TextureSlots; 
+        std::mutex m_Mutex;
+        std::vector<uint> m_FreeSlots;
+        std::vector<bool> m_TextureSlots;
 
     };
 }
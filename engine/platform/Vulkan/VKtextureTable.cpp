@@ -0,0 +1,130 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "VKtextureTable.h"
+
+namespace GfxRenderEngine
+{
+    VK_TextureTable::VK_TextureTable(VK_Device& device)
+        : m_Device{device}, m_DescriptorPool{VK_NULL_HANDLE},
+          m_DescriptorSetLayout{VK_NULL_HANDLE}, m_DescriptorSet{VK_NULL_HANDLE},
+          m_PlaceholderSlot{VKTextureSlotManager::INVALID_SLOT}
+    {
+        for (auto& resident : m_Resident)
+        {
+            resident.store(false, std::memory_order_relaxed);
+        }
+
+        // update-after-bind: textures can be registered while frames that use other slots are in flight
+        VkDescriptorBindingFlagsEXT bindingFlags =
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        bindingFlagsInfo.bindingCount = 1;
+        bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = MAX_TEXTURES;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = &bindingFlagsInfo;
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+        if (vkCreateDescriptorSetLayout(m_Device.Device(), &layoutInfo, nullptr, &m_DescriptorSetLayout) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_TextureTable: failed to create descriptor set layout!");
+        }
+
+        VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_TEXTURES};
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+        poolInfo.maxSets = 1;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        if (vkCreateDescriptorPool(m_Device.Device(), &poolInfo, nullptr, &m_DescriptorPool) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_TextureTable: failed to create descriptor pool!");
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_DescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_DescriptorSetLayout;
+        if (vkAllocateDescriptorSets(m_Device.Device(), &allocInfo, &m_DescriptorSet) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_TextureTable: failed to allocate descriptor set!");
+        }
+    }
+
+    VK_TextureTable::~VK_TextureTable()
+    {
+        vkDeviceWaitIdle(m_Device.Device());
+        vkDestroyDescriptorPool(m_Device.Device(), m_DescriptorPool, nullptr);
+        vkDestroyDescriptorSetLayout(m_Device.Device(), m_DescriptorSetLayout, nullptr);
+    }
+
+    void VK_TextureTable::Register(uint slot, VkSampler sampler, VkImageView imageView, VkImageLayout imageLayout)
+    {
+        if ((slot == VKTextureSlotManager::INVALID_SLOT) || (slot >= MAX_TEXTURES))
+        {
+            LOG_CORE_ERROR("VK_TextureTable::Register: invalid texture slot {0}", slot);
+            return;
+        }
+
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.sampler     = sampler;
+        imageInfo.imageView   = imageView;
+        imageInfo.imageLayout = imageLayout;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = m_DescriptorSet;
+        write.dstBinding = 0;
+        write.dstArrayElement = slot;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.descriptorCount = 1;
+        write.pImageInfo = &imageInfo;
+
+        // writes to the same descriptor set must be externally synchronized
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        vkUpdateDescriptorSets(m_Device.Device(), 1, &write, 0, nullptr);
+        m_Resident[slot].store(true, std::memory_order_release);
+    }
+
+    void VK_TextureTable::Unregister(uint slot)
+    {
+        if (slot < MAX_TEXTURES)
+        {
+            m_Resident[slot].store(false, std::memory_order_release);
+        }
+    }
+}
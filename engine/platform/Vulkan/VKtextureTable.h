@@ -0,0 +1,84 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKdevice.h"
+#include "VKtextureSlotManager.h"
+
+namespace GfxRenderEngine
+{
+    // Global array of combined image samplers indexed by texture slot (descriptor indexing).
+    // A VK_Texture writes itself to its slot when created; shaders select textures with indices
+    // from the instance buffer, so one descriptor set serves all materials.
+    // Only created if VK_Device::SupportsBindlessTextures(), otherwise materials use VK_MaterialCache.
+    // Slots are resident once registered; Resolve() maps all other slots to the placeholder,
+    // so streamed textures can be written to the table while frames are in flight.
+    class VK_TextureTable
+    {
+
+    public:
+
+        static constexpr uint MAX_TEXTURES = VKTextureSlotManager::MAX_TEXTURE_SLOTS;
+
+    public:
+
+        VK_TextureTable(VK_Device& device);
+        ~VK_TextureTable();
+
+        VK_TextureTable(const VK_TextureTable&) = delete;
+        VK_TextureTable& operator=(const VK_TextureTable&) = delete;
+
+        // thread-safe; slots not written or of destroyed textures are never read (partially bound)
+        void Register(uint slot, VkSampler sampler, VkImageView imageView, VkImageLayout imageLayout);
+        void Unregister(uint slot);
+
+        // slot to write into instance data: the slot itself if resident, otherwise the placeholder
+        uint Resolve(uint slot) const
+        {
+            bool resident = (slot < MAX_TEXTURES) && m_Resident[slot].load(std::memory_order_acquire);
+            return resident ? slot : m_PlaceholderSlot.load(std::memory_order_relaxed);
+        }
+        void SetPlaceholder(uint slot) { m_PlaceholderSlot.store(slot, std::memory_order_relaxed); }
+
+        VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+        VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
+
+    private:
+
+        VK_Device& m_Device;
+        VkDescriptorPool m_DescriptorPool;
+        VkDescriptorSetLayout m_DescriptorSetLayout;
+        VkDescriptorSet m_DescriptorSet;
+        std::mutex m_Mutex;
+        std::array<std::atomic<bool>, MAX_TEXTURES> m_Resident;
+        std::atomic<uint> m_PlaceholderSlot;
+
+    };
+}
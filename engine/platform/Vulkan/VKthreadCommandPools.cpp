@@ -0,0 +1,93 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "auxiliary/jobSystem.h"
+
+#include "VKthreadCommandPools.h"
+
+namespace GfxRenderEngine
+{
+    VK_ThreadCommandPools::VK_ThreadCommandPools(VK_Device& device, uint numberOfFrames, uint numberOfThreads)
+        : m_Device{device}, m_NumberOfThreads{numberOfThreads}
+    {
+        m_Pools.resize(numberOfFrames * numberOfThreads);
+        for (auto& pool : m_Pools)
+        {
+            VkCommandPoolCreateInfo poolInfo = {};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.queueFamilyIndex = m_Device.GetGraphicsQueueFamily();
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+            if (vkCreateCommandPool(m_Device.Device(), &poolInfo, nullptr, &pool.m_CommandPool) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to create thread command pool!");
+            }
+            pool.m_Used = 0;
+        }
+    }
+
+    VK_ThreadCommandPools::~VK_ThreadCommandPools()
+    {
+        // destroying a pool frees its command buffers
+        for (auto& pool : m_Pools)
+        {
+            vkDestroyCommandPool(m_Device.Device(), pool.m_CommandPool, nullptr);
+        }
+    }
+
+    void VK_ThreadCommandPools::Reset(uint frameIndex)
+    {
+        for (uint threadIndex = 0; threadIndex < m_NumberOfThreads; threadIndex++)
+        {
+            auto& pool = m_Pools[frameIndex * m_NumberOfThreads + threadIndex];
+            if (pool.m_Used)
+            {
+                vkResetCommandPool(m_Device.Device(), pool.m_CommandPool, 0);
+                pool.m_Used = 0;
+            }
+        }
+    }
+
+    VkCommandBuffer VK_ThreadCommandPools::Allocate(uint frameIndex)
+    {
+        uint threadIndex = JobSystem::GetThreadIndex();
+        ASSERT(threadIndex < m_NumberOfThreads);
+        auto& pool = m_Pools[frameIndex * m_NumberOfThreads + threadIndex];
+
+        if (pool.m_Used == pool.m_CommandBuffers.size())
+        {
+            VkCommandBufferAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocateInfo.commandPool = pool.m_CommandPool;
+            allocateInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer;
+            if (vkAllocateCommandBuffers(m_Device.Device(), &allocateInfo, &commandBuffer) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("failed to allocate secondary command buffer");
+            }
+            pool.m_CommandBuffers.push_back(commandBuffer);
+        }
+        return pool.m_CommandBuffers[pool.m_Used++];
+    }
+}
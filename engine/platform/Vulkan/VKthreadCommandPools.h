@@ -0,0 +1,69 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+#include "VKdevice.h"
+
+namespace GfxRenderEngine
+{
+    // one command pool per frame in flight and per job system thread;
+    // secondary command buffers are recycled by resetting the pools of a frame
+    class VK_ThreadCommandPools
+    {
+
+    public:
+
+        VK_ThreadCommandPools(VK_Device& device, uint numberOfFrames, uint numberOfThreads);
+        ~VK_ThreadCommandPools();
+
+        VK_ThreadCommandPools(const VK_ThreadCommandPools&) = delete;
+        VK_ThreadCommandPools& operator=(const VK_ThreadCommandPools&) = delete;
+
+        // the frame must not be in flight anymore
+        void Reset(uint frameIndex);
+
+        // returns a secondary command buffer from the calling thread's pool
+        VkCommandBuffer Allocate(uint frameIndex);
+
+    private:
+
+        struct ThreadPool
+        {
+            VkCommandPool m_CommandPool;
+            std::vector<VkCommandBuffer> m_CommandBuffers;
+            uint m_Used;
+        };
+
+    private:
+
+        VK_Device& m_Device;
+        uint m_NumberOfThreads;
+        std::vector<ThreadPool> m_Pools; // [frameIndex * m_NumberOfThreads + threadIndex]
+
+    };
+}
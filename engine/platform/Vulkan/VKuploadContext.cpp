@@ -0,0 +1,178 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "VKuploadContext.h"
+#include "VKdevice.h"
+#include "VKbuffer.h"
+
+namespace GfxRenderEngine
+{
+
+    VK_UploadContext::VK_UploadContext(VK_Device& device)
+        : m_Device{device}, m_Depth{0}, m_StagingBytes{0}
+    {
+    }
+
+    VK_UploadContext::~VK_UploadContext()
+    {
+        if (m_Current.m_CommandBuffer != VK_NULL_HANDLE)
+        {
+            Submit();
+        }
+        Collect(true);
+    }
+
+    void VK_UploadContext::Begin()
+    {
+        m_Depth++;
+    }
+
+    void VK_UploadContext::End()
+    {
+        ASSERT(m_Depth > 0);
+        if (--m_Depth == 0)
+        {
+            Submit();
+        }
+    }
+
+    VkCommandBuffer VK_UploadContext::GetCommandBuffer()
+    {
+        if (m_Current.m_CommandBuffer == VK_NULL_HANDLE)
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = m_Device.GetCommandPool();
+            allocInfo.commandBufferCount = 1;
+
+            if (vkAllocateCommandBuffers(m_Device.Device(), &allocInfo, &m_Current.m_CommandBuffer) != VK_SUCCESS)
+            {
+                LOG_CORE_CRITICAL("VK_UploadContext: failed to allocate command buffer!");
+            }
+
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            vkBeginCommandBuffer(m_Current.m_CommandBuffer, &beginInfo);
+        }
+        return m_Current.m_CommandBuffer;
+    }
+
+    void VK_UploadContext::ReleaseAfterUpload(std::unique_ptr<VK_Buffer> stagingBuffer)
+    {
+        if (!IsRecording())
+        {
+            // the copy was submitted and waited for already
+            return;
+        }
+        m_StagingBytes += stagingBuffer->GetBufferSize();
+        m_Current.m_StagingBuffers.push_back(std::move(stagingBuffer));
+
+        if (m_StagingBytes > MAX_STAGING_BYTES_PER_SUBMIT)
+        {
+            Submit();
+        }
+    }
+
+    void VK_UploadContext::Submit()
+    {
+        m_StagingBytes = 0;
+        if (m_Current.m_CommandBuffer == VK_NULL_HANDLE)
+        {
+            // nothing was recorded
+            m_Current = Submission{};
+            return;
+        }
+
+        // make all transfer writes of this batch visible to vertex input and shaders
+        // of any later submission to the same queue
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier
+        (
+            m_Current.m_CommandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr
+        );
+
+        vkEndCommandBuffer(m_Current.m_CommandBuffer);
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(m_Device.Device(), &fenceInfo, nullptr, &m_Current.m_Fence) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_UploadContext: failed to create fence!");
+        }
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &m_Current.m_CommandBuffer;
+
+        if (vkQueueSubmit(m_Device.GraphicsQueue(), 1, &submitInfo, m_Current.m_Fence) != VK_SUCCESS)
+        {
+            LOG_CORE_CRITICAL("VK_UploadContext: failed to submit upload batch!");
+        }
+
+        m_InFlight.push_back(std::move(m_Current));
+        m_Current = Submission{};
+    }
+
+    void VK_UploadContext::Retire(Submission& submission)
+    {
+        auto device = m_Device.Device();
+        vkDestroyFence(device, submission.m_Fence, nullptr);
+        vkFreeCommandBuffers(device, m_Device.GetCommandPool(), 1, &submission.m_CommandBuffer);
+        submission.m_StagingBuffers.clear();
+    }
+
+    void VK_UploadContext::Collect(bool wait)
+    {
+        auto device = m_Device.Device();
+        auto iterator = m_InFlight.begin();
+        while (iterator != m_InFlight.end())
+        {
+            if (wait)
+            {
+                vkWaitForFences(device, 1, &iterator->m_Fence, VK_TRUE, UINT64_MAX);
+            }
+            if (vkGetFenceStatus(device, iterator->m_Fence) == VK_SUCCESS)
+            {
+                Retire(*iterator);
+                iterator = m_InFlight.erase(iterator);
+            }
+            else
+            {
+                ++iterator;
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+    class VK_Device;
+    class VK_Buffer;
+
+    // Batches staging copies and layout transitions into as few command buffers as possible.
+    // Between Begin() and End(), VK_Device::BeginSingleTimeCommands() hands out the batch
+    // command buffer instead of submitting and waiting for every single upload.
+    // Staging buffers are kept alive until the fence of their submission has signaled.
+    class VK_UploadContext
+    {
+
+    public:
+
+        // submit early when this much staging memory is waiting in the current batch
+        static constexpr VkDeviceSize MAX_STAGING_BYTES_PER_SUBMIT = 256 * 1024 * 1024;
+
+    public:
+
+        VK_UploadContext(VK_Device& device);
+        ~VK_UploadContext();
+
+        VK_UploadContext(const VK_UploadContext&) = delete;
+        VK_UploadContext& operator=(const VK_UploadContext&) = delete;
+
+        // batches can be nested, only the outermost End() submits
+        void Begin();
+        void End();
+        bool IsRecording() const { return m_Depth > 0; }
+
+        VkCommandBuffer GetCommandBuffer();
+        void ReleaseAfterUpload(std::unique_ptr<VK_Buffer> stagingBuffer);
+
+        // frees staging memory of all completed submissions
+        void Collect(bool wait = false);
+
+    private:
+
+        struct Submission
+        {
+            VkFence m_Fence = VK_NULL_HANDLE;
+            VkCommandBuffer m_CommandBuffer = VK_NULL_HANDLE;
+            std::vector<std::unique_ptr<VK_Buffer>> m_StagingBuffers;
+        };
+
+        void Submit();
+        void Retire(Submission& submission);
+
+    private:
+
+        VK_Device& m_Device;
+        uint m_Depth;
+        VkDeviceSize m_StagingBytes;
+
+        Submission m_Current;
+        std::vector<Submission> m_InFlight;
+
+    };
+}
@@ -81,6 +81,7 @@ namespace GfxRenderEngine
         GLFWimage icon;
         size_t fileSize;
         const uchar* data = (const uchar*) ResourceSystem::GetDataPointer(fileSize, "/images/images/I_Vulkan.png", IDB_VULKAN, "PNG");
+        stbi_set_flip_vertically_on_load_thread(false); // GLFW expects the top row first
         icon.pixels = stbi_load_from_memory(data, fileSize, &icon.width, &icon.height, 0, 4); //rgba channels
         if (icon.pixels) 
         {
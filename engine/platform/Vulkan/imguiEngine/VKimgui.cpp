@@ -27,6 +27,7 @@
 #include "core.h"
 
 #include "imguiEngine/VKimgui.h"
+#include "VKrenderer.h"
 
 namespace GfxRenderEngine
 {
@@ -142,6 +143,19 @@ namespace GfxRenderEngine
             1000.0f / ImGui::GetIO().Framerate,
             ImGui::GetIO().Framerate
         );
+        auto memoryStatistics = VK_Core::m_Device->GetAllocator().GetStatistics();
+        ImGui::Text
+        (
+            "Device memory %.1f MB in use, %.1f MB in %u blocks, fragmentation %.1f%%",
+            memoryStatistics.m_BytesInUse / (1024.0f * 1024.0f),
+            memoryStatistics.m_BytesAllocated / (1024.0f * 1024.0f),
+            memoryStatistics.m_BlockCount,
+            memoryStatistics.m_Fragmentation * 100.0f
+        );
+        if (VK_Renderer::m_GpuTimer)
+        {
+            VK_Renderer::m_GpuTimer->ShowStatistics();
+        }
         ImGui::End();
         ImGui::PopStyleColor();
     }
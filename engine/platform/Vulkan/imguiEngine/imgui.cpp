@@ -39,7 +39,11 @@ namespace GfxRenderEngine
 
     std::shared_ptr<Imgui> Imgui::Create(VkRenderPass renderPass, uint imageCount)
     {
-        if (!m_Imgui)     m_Imgui     = std::make_shared<VK_Imgui>(renderPass, imageCount);
+        // ImGui needs a window
+        if (!m_Imgui && !VK_Core::m_Device->IsHeadless())
+        {
+            m_Imgui = std::make_shared<VK_Imgui>(renderPass, imageCount);
+        }
         if (!m_ImguiNull) m_ImguiNull = std::make_shared<ImguiNull>();
 
         return m_ImguiNull;
@@ -49,7 +53,7 @@ namespace GfxRenderEngine
     {
         m_Callback = callback;
         m_ImguiDebugWindowEnabled = !m_ImguiDebugWindowEnabled;
-        if (m_ImguiDebugWindowEnabled)
+        if (m_ImguiDebugWindowEnabled && m_Imgui)
         {
             return m_Imgui;
         }
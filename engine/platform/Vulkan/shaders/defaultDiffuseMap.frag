@@ -55,12 +55,6 @@ layout(set = 0, binding = 1) uniform sampler2D tex1;
 
 layout (location = 0) out vec4 outColor;
 
-layout(push_constant) uniform Push
-{
-    mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
-} push;
-
 void main()
 {
 
@@ -108,19 +102,20 @@ void main()
     }
     // ------------------------------
 
-    vec3 pixelColor;
+    // fragDiffuseMapTextureSlot is a marker (see Vertex::SPRITESHEET), not a texture slot
+    const int SPRITESHEET = 1;
+
+    vec3 pixelColor = fragColor.xyz;
     float alpha = 1.0;
-    if (fragDiffuseMapTextureSlot > 0)
+    if (fragDiffuseMapTextureSlot == SPRITESHEET)
     {
         // {0.0, 1.0} - {1.0, 1.0}
         // |        /            |
         // {0.0, 0.0} - {1.0, 0.0}
 
-        if (fragDiffuseMapTextureSlot == 1)
-        {
-            alpha = texture(tex1,fragUV).w;
-            pixelColor = texture(tex1,fragUV).xyz;
-        }
+        vec4 texel = texture(tex1,fragUV);
+        alpha = texel.w;
+        pixelColor = texel.xyz;
         if (alpha == 0) discard;
         if (fragUnlit != 0)
         {
@@ -129,10 +124,6 @@ void main()
         }
         pixelColor *= fragAmplification;
     }
-    else
-    {
-        pixelColor = fragColor.xyz;
-    }
 
     outColor.xyz = ambientLightColor*pixelColor.xyz + (diffusedLightColor  * pixelColor.xyz) + specularLightColor;
 
@@ -52,11 +52,16 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
 
 layout(set = 0, binding = 1) uniform sampler2D tex1;
 
-layout(push_constant) uniform Push
+struct InstanceData
 {
     mat4 m_ModelMatrix;
     mat4 m_NormalMatrix;
-} push;
+};
+
+layout(set = 0, binding = 3) readonly buffer InstanceBuffer
+{
+    InstanceData m_Instances[];
+} instances;
 
 layout(location = 0) out vec3  fragColor;
 layout(location = 1) out vec3  fragPositionWorld;
@@ -69,17 +74,19 @@ layout(location = 7) out vec3  toCameraDirection;
 
 void main()
 {
+    InstanceData instance = instances.m_Instances[gl_InstanceIndex];
+
     // lighting
-    vec4 positionWorld = push.m_ModelMatrix * vec4(position, 1.0);
+    vec4 positionWorld = instance.m_ModelMatrix * vec4(position, 1.0);
     fragPositionWorld = positionWorld.xyz;
-    fragMormalWorld = normalize(mat3(push.m_NormalMatrix) * normal);
+    fragMormalWorld = normalize(mat3(instance.m_NormalMatrix) * normal);
     fragColor = color;
     fragDiffuseMapTextureSlot = diffuseMapTextureSlot;
     fragAmplification = amplification;
     fragUnlit = unlit;
 
     // projection * view * model * position
-    gl_Position = ubo.m_Projection * ubo.m_View * push.m_ModelMatrix * vec4(position, 1.0);
+    gl_Position = ubo.m_Projection * ubo.m_View * instance.m_ModelMatrix * vec4(position, 1.0);
     fragUV = uv;
 
     vec3 cameraPosWorld = (inverse(ubo.m_View) * vec4(0.0,0.0,0.0,1.0)).xyz;
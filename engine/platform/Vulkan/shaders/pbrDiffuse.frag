@@ -25,6 +25,10 @@
 
 #version 450
 
+#ifdef BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
 layout(location = 0)       in vec3  fragColor;
 layout(location = 1)       in vec3  fragPositionWorld;
 layout(location = 2)       in vec3  fragNormalWorld;
@@ -32,6 +36,7 @@ layout(location = 3)       in vec2  fragUV;
 layout(location = 4)       in float fragAmplification;
 layout(location = 5)  flat in int   fragUnlit;
 layout(location = 6)       in vec3  toCameraDirection;
+layout(location = 7)  flat in vec3  fragMaterial;
 
 struct PointLight
 {
@@ -50,16 +55,16 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
     int m_NumberOfActiveLights;
 } ubo;
 
+#ifdef BINDLESS
+layout(set = 1, binding = 0) uniform sampler2D textures[MAX_TEXTURES];
+layout(location = 8) flat in ivec3 fragTextureSlots;
+#define diffuseMap textures[nonuniformEXT(fragTextureSlots.x)]
+#else
 layout(set = 1, binding = 0) uniform sampler2D diffuseMap;
+#endif
 
 layout (location = 0) out vec4 outColor;
 
-layout(push_constant) uniform Push
-{
-    mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
-} push;
-
 const float PI = 3.14159265359;
 
 // ----------------------------------------------------------------------------
@@ -111,8 +116,8 @@ void main()
       discard; 
     }
 
-    float roughness           = push.m_NormalMatrix[3].x;
-    float metallic            = push.m_NormalMatrix[3].y;
+    float roughness           = fragMaterial.x;
+    float metallic            = fragMaterial.y;
 
     vec3  ambientLightColor   = ubo.m_AmbientLightColor.xyz * ubo.m_AmbientLightColor.w;
 
@@ -50,13 +50,17 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
     int m_NumberOfActiveLights;
 } ubo;
 
-layout(set = 1, binding = 0) uniform sampler2D diffuseMap;
-
-layout(push_constant) uniform Push
+struct InstanceData
 {
     mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
-} push;
+    mat4 m_NormalMatrix; // [3].x: roughness, [3].y: metallic, [3].z: normal map intensity
+                         // [0..2].w: texture slots (bindless texture table)
+};
+
+layout(set = 0, binding = 3) readonly buffer InstanceBuffer
+{
+    InstanceData m_Instances[];
+} instances;
 
 layout(location = 0)  out  vec3  fragColor;
 layout(location = 1)  out  vec3  fragPositionWorld;
@@ -65,18 +69,24 @@ layout(location = 3)  out  vec2  fragUV;
 layout(location = 4)  out  float fragAmplification;
 layout(location = 5)  out  int   fragUnlit;
 layout(location = 6)  out  vec3  toCameraDirection;
+layout(location = 7) flat out vec3  fragMaterial;
+layout(location = 8) flat out ivec3 fragTextureSlots;
 
 void main()
 {
-    vec4 positionWorld = push.m_ModelMatrix * vec4(position, 1.0);
+    InstanceData instance = instances.m_Instances[gl_InstanceIndex];
+    fragMaterial = instance.m_NormalMatrix[3].xyz;
+    fragTextureSlots = ivec3(instance.m_NormalMatrix[0].w, instance.m_NormalMatrix[1].w, instance.m_NormalMatrix[2].w);
+
+    vec4 positionWorld = instance.m_ModelMatrix * vec4(position, 1.0);
     fragPositionWorld = positionWorld.xyz;
-    fragNormalWorld = normalize(mat3(push.m_NormalMatrix) * normal);
+    fragNormalWorld = normalize(mat3(instance.m_NormalMatrix) * normal);
     fragColor = color;
     fragAmplification = amplification;
     fragUnlit = unlit;
 
     // projection * view * model * position
-    gl_Position = ubo.m_Projection * ubo.m_View * push.m_ModelMatrix * vec4(position, 1.0);
+    gl_Position = ubo.m_Projection * ubo.m_View * instance.m_ModelMatrix * vec4(position, 1.0);
     fragUV = uv;
 
     vec3 cameraPosWorld = (inverse(ubo.m_View) * vec4(0.0,0.0,0.0,1.0)).xyz;
@@ -25,6 +25,10 @@
 
 #version 450
 
+#ifdef BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
 layout(location = 0)       in vec3  fragColor;
 layout(location = 1)       in vec3  fragPositionWorld;
 layout(location = 2)       in vec3  fragNormalWorld;
@@ -34,6 +38,7 @@ layout(location = 5)  flat in int   fragUnlit;
 layout(location = 6)       in vec3  fragTangentViewPos;
 layout(location = 7)       in vec3  fragTangentFragPos;
 layout(location = 8)       in vec3  fragTangentLightPos[10];
+layout(location = 18)  flat in vec3  fragMaterial;
 
 struct PointLight
 {
@@ -52,17 +57,18 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
     int m_NumberOfActiveLights;
 } ubo;
 
+#ifdef BINDLESS
+layout(set = 1, binding = 0) uniform sampler2D textures[MAX_TEXTURES];
+layout(location = 19) flat in ivec3 fragTextureSlots;
+#define diffuseMap textures[nonuniformEXT(fragTextureSlots.x)]
+#define normalMap textures[nonuniformEXT(fragTextureSlots.y)]
+#else
 layout(set = 1, binding = 0) uniform sampler2D diffuseMap;
 layout(set = 1, binding = 1) uniform sampler2D normalMap;
+#endif
 
 layout (location = 0) out vec4 outColor;
 
-layout(push_constant) uniform Push
-{
-    mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
-} push;
-
 const float PI = 3.14159265359;
 
 // ----------------------------------------------------------------------------
@@ -114,9 +120,9 @@ void main()
       discard; 
     }
 
-    float roughness           = push.m_NormalMatrix[3].x;
-    float metallic            = push.m_NormalMatrix[3].y;
-    float normalMapIntensity  = push.m_NormalMatrix[3].z;
+    float roughness           = fragMaterial.x;
+    float metallic            = fragMaterial.y;
+    float normalMapIntensity  = fragMaterial.z;
 
     vec3  ambientLightColor   = ubo.m_AmbientLightColor.xyz * ubo.m_AmbientLightColor.w;
 
@@ -129,7 +135,9 @@ void main()
     vec3 V = normalize(fragTangentViewPos - fragTangentFragPos);
 
     // normal in tangent space
-    vec3 surfaceNormalfromMap = normalize(texture(normalMap,fragUV).xyz * 2 - vec3(1.0, 1.0, 1.0));
+    // z is reconstructed from x and y (two-channel BC5 normal maps)
+    vec2 normalXY = texture(normalMap,fragUV).xy * 2 - vec2(1.0, 1.0);
+    vec3 surfaceNormalfromMap = normalize(vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0))));
     vec3 N = mix(vec3(0.0, 0.0, 1.0), surfaceNormalfromMap, normalMapIntensity);
 
     // reflectance equation
@@ -51,14 +51,17 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
     int m_NumberOfActiveLights;
 } ubo;
 
-layout(set = 1, binding = 0) uniform sampler2D diffuseMap;
-layout(set = 1, binding = 1) uniform sampler2D normalMap;
-
-layout(push_constant) uniform Push
+struct InstanceData
 {
     mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
-} push;
+    mat4 m_NormalMatrix; // [3].x: roughness, [3].y: metallic, [3].z: normal map intensity
+                         // [0..2].w: texture slots (bindless texture table)
+};
+
+layout(set = 0, binding = 3) readonly buffer InstanceBuffer
+{
+    InstanceData m_Instances[];
+} instances;
 
 layout(location = 0)  out  vec3  fragColor;
 layout(location = 1)  out  vec3  fragPositionWorld;
@@ -69,24 +72,30 @@ layout(location = 5)  out  int   fragUnlit;
 layout(location = 6)  out  vec3  fragTangentViewPos;
 layout(location = 7)  out  vec3  fragTangentFragPos;
 layout(location = 8)  out  vec3  fragTangentLightPos[10];
+layout(location = 18) flat out vec3  fragMaterial;
+layout(location = 19) flat out ivec3 fragTextureSlots;
 
 void main()
 {
-    vec4 positionWorld = push.m_ModelMatrix * vec4(position, 1.0);
+    InstanceData instance = instances.m_Instances[gl_InstanceIndex];
+    fragMaterial = instance.m_NormalMatrix[3].xyz;
+    fragTextureSlots = ivec3(instance.m_NormalMatrix[0].w, instance.m_NormalMatrix[1].w, instance.m_NormalMatrix[2].w);
+
+    vec4 positionWorld = instance.m_ModelMatrix * vec4(position, 1.0);
     fragPositionWorld = positionWorld.xyz;
-    fragNormalWorld = normalize(mat3(push.m_NormalMatrix) * normal);
+    fragNormalWorld = normalize(mat3(instance.m_NormalMatrix) * normal);
     fragColor = color;
     fragAmplification = amplification;
     fragUnlit = unlit;
 
     // projection * view * model * position
-    gl_Position = ubo.m_Projection * ubo.m_View * push.m_ModelMatrix * vec4(position, 1.0);
+    gl_Position = ubo.m_Projection * ubo.m_View * instance.m_ModelMatrix * vec4(position, 1.0);
     fragUV = uv;
 
     vec3 cameraPosWorld = (inverse(ubo.m_View) * vec4(0.0,0.0,0.0,1.0)).xyz;
 
     // lights and camera in tangent space
-    mat3 normalMatrix = transpose(inverse(mat3(push.m_ModelMatrix)));
+    mat3 normalMatrix = transpose(inverse(mat3(instance.m_ModelMatrix)));
     vec3 T = normalize(normalMatrix * tangent);
     vec3 N = normalize(normalMatrix * normal);
 
@@ -32,6 +32,7 @@ layout(location = 3)       in vec2  fragUV;
 layout(location = 4)       in float fragAmplification;
 layout(location = 5)  flat in int   fragUnlit;
 layout(location = 6)       in vec3  toCameraDirection;
+layout(location = 7)  flat in vec3  fragMaterial;
 
 struct PointLight
 {
@@ -52,12 +53,6 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
 
 layout (location = 0) out vec4 outColor;
 
-layout(push_constant) uniform Push
-{
-    mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
-} push;
-
 const float PI = 3.14159265359;
 
 // ----------------------------------------------------------------------------
@@ -105,8 +100,8 @@ void main()
 {
     vec4 albedo = vec4(fragColor, 1.0);
 
-    float roughness           = push.m_NormalMatrix[3].x;
-    float metallic            = push.m_NormalMatrix[3].y;
+    float roughness           = fragMaterial.x;
+    float metallic            = fragMaterial.y;
 
     vec3  ambientLightColor   = ubo.m_AmbientLightColor.xyz * ubo.m_AmbientLightColor.w;
 
@@ -50,11 +50,16 @@ layout(set = 0, binding = 0) uniform GlobalUniformBuffer
     int m_NumberOfActiveLights;
 } ubo;
 
-layout(push_constant) uniform Push
+struct InstanceData
 {
     mat4 m_ModelMatrix;
-    mat4 m_NormalMatrix;
-} push;
+    mat4 m_NormalMatrix; // [3].x: roughness, [3].y: metallic, [3].z: normal map intensity
+};
+
+layout(set = 0, binding = 3) readonly buffer InstanceBuffer
+{
+    InstanceData m_Instances[];
+} instances;
 
 layout(location = 0)  out  vec3  fragColor;
 layout(location = 1)  out  vec3  fragPositionWorld;
@@ -63,18 +68,22 @@ layout(location = 3)  out  vec2  fragUV;
 layout(location = 4)  out  float fragAmplification;
 layout(location = 5)  out  int   fragUnlit;
 layout(location = 6)  out  vec3  toCameraDirection;
+layout(location = 7) flat out vec3  fragMaterial;
 
 void main()
 {
-    vec4 positionWorld = push.m_ModelMatrix * vec4(position, 1.0);
+    InstanceData instance = instances.m_Instances[gl_InstanceIndex];
+    fragMaterial = instance.m_NormalMatrix[3].xyz;
+
+    vec4 positionWorld = instance.m_ModelMatrix * vec4(position, 1.0);
     fragPositionWorld = positionWorld.xyz;
-    fragNormalWorld = normalize(mat3(push.m_NormalMatrix) * normal);
+    fragNormalWorld = normalize(mat3(instance.m_NormalMatrix) * normal);
     fragColor = color;
     fragAmplification = amplification;
     fragUnlit = unlit;
 
     // projection * view * model * position
-    gl_Position = ubo.m_Projection * ubo.m_View * push.m_ModelMatrix * vec4(position, 1.0);
+    gl_Position = ubo.m_Projection * ubo.m_View * instance.m_ModelMatrix * vec4(position, 1.0);
     fragUV = uv;
 
     vec3 cameraPosWorld = (inverse(ubo.m_View) * vec4(0.0,0.0,0.0,1.0)).xyz;
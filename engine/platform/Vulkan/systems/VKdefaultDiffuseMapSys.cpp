@@ -41,17 +41,12 @@ namespace GfxRenderEngine
 
     void VK_RenderSystemDefaultDiffuseMap::CreatePipelineLayout(std::vector<VkDescriptorSetLayout>& descriptorSetLayouts)
     {
-        VkPushConstantRange pushConstantRange{};
-        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(VK_PushConstantDataDefaultDiffuseMap);
-
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         pipelineLayoutInfo.setLayoutCount = static_cast<uint>(descriptorSetLayouts.size());
         pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-        pipelineLayoutInfo.pushConstantRangeCount = 1;
-        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        pipelineLayoutInfo.pushConstantRangeCount = 0;
+        pipelineLayoutInfo.pPushConstantRanges = nullptr;
         if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("failed to create pipeline layout!");
@@ -96,28 +91,24 @@ namespace GfxRenderEngine
         auto view = registry.view<MeshComponent, TransformComponent, DefaultDiffuseComponent>();
         for (auto entity : view)
         {
-            auto& defaultDiffuseComponent = view.get<DefaultDiffuseComponent>(entity);
-            auto& transform = view.get<TransformComponent>(entity);
-            VK_PushConstantDataDefaultDiffuseMap push{};
-            push.m_ModelMatrix  = transform.GetMat4();
-            push.m_NormalMatrix = transform.GetNormalMatrix();
-            push.m_NormalMatrix[3].x = defaultDiffuseComponent.m_Roughness;
-            push.m_NormalMatrix[3].y = defaultDiffuseComponent.m_Metallic;
-            vkCmdPushConstants(
-                frameInfo.m_CommandBuffer,
-                m_PipelineLayout,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(VK_PushConstantDataDefaultDiffuseMap),
-                &push);
-
             auto& mesh = view.get<MeshComponent>(entity);
-            if (mesh.m_Enabled)
+            auto& transform = view.get<TransformComponent>(entity);
+            if (!mesh.m_Enabled || !frameInfo.m_Frustum.IsVisible(mesh.GetAABB(), mesh.GetBoundingSphere(), transform.GetMat4()))
             {
-                static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
-                static_cast<VK_Model*>(mesh.m_Model.get())->Draw(frameInfo.m_CommandBuffer);
+                continue;
             }
+
+            auto& defaultDiffuseComponent = view.get<DefaultDiffuseComponent>(entity);
+            VK_InstanceData instance{};
+            instance.m_ModelMatrix  = transform.GetMat4();
+            instance.m_NormalMatrix = transform.GetNormalMatrix();
+            instance.m_NormalMatrix[3].x = defaultDiffuseComponent.m_Roughness;
+            instance.m_NormalMatrix[3].y = defaultDiffuseComponent.m_Metallic;
+
+            m_InstanceBatch.Add(static_cast<VK_Model*>(mesh.m_Model.get()), VK_NULL_HANDLE, instance);
         }
+
+        m_InstanceBatch.Draw(frameInfo, m_PipelineLayout);
     }
 
     void VK_RenderSystemDefaultDiffuseMap::DrawParticles(const VK_FrameInfo& frameInfo, std::shared_ptr<ParticleSystem>& particleSystem)
@@ -136,28 +127,20 @@ namespace GfxRenderEngine
         
         m_Pipeline->Bind(frameInfo.m_CommandBuffer);
 
-        for (auto& particle : particleSystem->m_ParticlePool)
+        // all live particles sharing an animation frame are one instanced draw
+        for (uint index = 0; index < particleSystem->GetPoolSize(); index++)
         {
-            if (!particle.m_Enabled)
+            if (!particleSystem->IsAlive(index))
             {
                 continue;
             }
-            auto& transform = particleSystem->m_Registry.get<TransformComponent>(particle.m_Entity);
-            VK_PushConstantDataDefaultDiffuseMap push{};
-            push.m_ModelMatrix  = transform.GetMat4();
-            push.m_NormalMatrix = transform.GetNormalMatrix();
-            vkCmdPushConstants(
-                frameInfo.m_CommandBuffer,
-                m_PipelineLayout,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(VK_PushConstantDataDefaultDiffuseMap),
-                &push);
-
-            auto& mesh = particleSystem->m_Registry.get<MeshComponent>(particle.m_SpriteEntity);
-            static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
-            static_cast<VK_Model*>(mesh.m_Model.get())->Draw(frameInfo.m_CommandBuffer);
+            VK_InstanceData instance{};
+            instance.m_ModelMatrix  = particleSystem->GetMat4(index);
+            instance.m_NormalMatrix = particleSystem->GetNormalMatrix(index);
+
+            m_InstanceBatch.Add(static_cast<VK_Model*>(particleSystem->GetModel(index)), VK_NULL_HANDLE, instance);
         }
-        
+
+        m_InstanceBatch.Draw(frameInfo, m_PipelineLayout);
     }
 }
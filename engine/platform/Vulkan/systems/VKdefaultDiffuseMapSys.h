@@ -36,15 +36,10 @@
 #include "VKpipeline.h"
 #include "VKframeInfo.h"
 #include "VKdescriptor.h"
+#include "VKinstanceBuffer.h"
 
 namespace GfxRenderEngine
 {
-    struct VK_PushConstantDataDefaultDiffuseMap
-    {
-        glm::mat4 m_ModelMatrix{1.0f};
-        glm::mat4 m_NormalMatrix{1.0f}; // 4x4 because of alignment
-    };
-
     class VK_RenderSystemDefaultDiffuseMap
     {
 
@@ -68,6 +63,7 @@ namespace GfxRenderEngine
 
         VkPipelineLayout m_PipelineLayout;
         std::unique_ptr<VK_Pipeline> m_Pipeline;
+        VK_InstanceBatch m_InstanceBatch;
 
     };
 }
@@ -23,12 +23,14 @@
 #include "VKcore.h"
 #include "VKswapChain.h"
 #include "VKmodel.h"
+#include "VKrenderer.h"
 
 #include "systems/VKpbrDiffuseNormalSys.h"
 
 namespace GfxRenderEngine
 {
     VK_RenderSystemPbrDiffuseNormal::VK_RenderSystemPbrDiffuseNormal(VkRenderPass renderPass, std::vector<VkDescriptorSetLayout>& descriptorSetLayouts)
+        : m_BindlessTextures{VK_Core::m_Device->SupportsBindlessTextures()}
     {
         CreatePipelineLayout(descriptorSetLayouts);
         CreatePipeline(renderPass);
@@ -41,17 +43,12 @@ namespace GfxRenderEngine
 
     void VK_RenderSystemPbrDiffuseNormal::CreatePipelineLayout(std::vector<VkDescriptorSetLayout>& descriptorSetLayouts)
     {
-        VkPushConstantRange pushConstantRange{};
-        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(VK_PushConstantDataPbrDiffuseNormal);
-
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         pipelineLayoutInfo.setLayoutCount = static_cast<uint>(descriptorSetLayouts.size());
         pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-        pipelineLayoutInfo.pushConstantRangeCount = 1;
-        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        pipelineLayoutInfo.pushConstantRangeCount = 0;
+        pipelineLayoutInfo.pPushConstantRanges = nullptr;
         if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("failed to create pipeline layout!");
@@ -73,53 +70,63 @@ namespace GfxRenderEngine
         (
             VK_Core::m_Device,
             "bin/pbrDiffuseNormal.vert.spv",
-            "bin/pbrDiffuseNormal.frag.spv",
+            m_BindlessTextures ? "bin/pbrDiffuseNormalBindless.frag.spv" : "bin/pbrDiffuseNormal.frag.spv",
             pipelineConfig
         );
     }
 
     void VK_RenderSystemPbrDiffuseNormal::RenderEntities(const VK_FrameInfo& frameInfo, entt::registry& registry)
     {
+        // with bindless textures, set 1 is the texture table and stays bound for all materials
+        VkDescriptorSet descriptorSets[] = {frameInfo.m_GlobalDescriptorSet, frameInfo.m_TextureTableDescriptorSet};
+        vkCmdBindDescriptorSets
+        (
+            frameInfo.m_CommandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            m_PipelineLayout,
+            0,
+            m_BindlessTextures ? 2 : 1,
+            descriptorSets,
+            0,
+            nullptr
+        );
         m_Pipeline->Bind(frameInfo.m_CommandBuffer);
 
         auto view = registry.view<MeshComponent, TransformComponent, PbrDiffuseNormalComponent>();
         for (auto entity : view)
         {
-            auto& pbrDiffuseNormalComponent = view.get<PbrDiffuseNormalComponent>(entity);
-            VkDescriptorSet localDescriptorSet = pbrDiffuseNormalComponent.m_DescriptorSet[frameInfo.m_FrameIndex];
-            std::vector<VkDescriptorSet> descriptorSets = {frameInfo.m_GlobalDescriptorSet, localDescriptorSet};
-            vkCmdBindDescriptorSets
-            (
-                frameInfo.m_CommandBuffer,
-                VK_PIPELINE_BIND_POINT_GRAPHICS,
-                m_PipelineLayout,
-                0,
-                2,
-                descriptorSets.data(),
-                0,
-                nullptr
-            );
+            auto& mesh = view.get<MeshComponent>(entity);
             auto& transform = view.get<TransformComponent>(entity);
-            VK_PushConstantDataPbrDiffuseNormal push{};
-            push.m_ModelMatrix  = transform.GetMat4();
-            push.m_NormalMatrix = transform.GetNormalMatrix();
-            push.m_NormalMatrix[3].x = pbrDiffuseNormalComponent.m_Roughness;
-            push.m_NormalMatrix[3].y = pbrDiffuseNormalComponent.m_Metallic;
-            push.m_NormalMatrix[3].z = pbrDiffuseNormalComponent.m_NormalMapIntensity;
-            vkCmdPushConstants(
-                frameInfo.m_CommandBuffer,
-                m_PipelineLayout,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(VK_PushConstantDataPbrDiffuseNormal),
-                &push);
+            if (!mesh.m_Enabled || !frameInfo.m_Frustum.IsVisible(mesh.GetAABB(), mesh.GetBoundingSphere(), transform.GetMat4()))
+            {
+                continue;
+            }
 
-            auto& mesh = view.get<MeshComponent>(entity);
-            if (mesh.m_Enabled)
+            auto& pbrDiffuseNormalComponent = view.get<PbrDiffuseNormalComponent>(entity);
+            VK_InstanceData instance{};
+            instance.m_ModelMatrix  = transform.GetMat4();
+            instance.m_NormalMatrix = transform.GetNormalMatrix();
+            instance.m_NormalMatrix[3].x = pbrDiffuseNormalComponent.m_Roughness;
+            instance.m_NormalMatrix[3].y = pbrDiffuseNormalComponent.m_Metallic;
+            instance.m_NormalMatrix[3].z = pbrDiffuseNormalComponent.m_NormalMapIntensity;
+
+            if (m_BindlessTextures)
             {
-                static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
-                static_cast<VK_Model*>(mesh.m_Model.get())->Draw(frameInfo.m_CommandBuffer);
+                // texture slots, [0..2].w are not used by the normal matrix;
+                // streamed textures show the placeholder until they are resident
+                auto& textureTable = *VK_Renderer::m_TextureTable;
+                instance.m_NormalMatrix[0].w = static_cast<float>(textureTable.Resolve(pbrDiffuseNormalComponent.m_DiffuseMapSlot));
+                instance.m_NormalMatrix[1].w = static_cast<float>(textureTable.Resolve(pbrDiffuseNormalComponent.m_NormalMapSlot));
+                // no material descriptor set: instances of a model are batched across materials
+                m_InstanceBatch.Add(static_cast<VK_Model*>(mesh.m_Model.get()), VK_NULL_HANDLE, instance);
+            }
+            else
+            {
+                m_InstanceBatch.Add(static_cast<VK_Model*>(mesh.m_Model.get()), pbrDiffuseNormalComponent.m_DescriptorSet[frameInfo.m_FrameIndex], instance);
             }
         }
+
+        // one instanced draw per material and model
+        m_InstanceBatch.Draw(frameInfo, m_PipelineLayout);
     }
 }
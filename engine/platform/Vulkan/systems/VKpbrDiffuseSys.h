@@ -35,15 +35,10 @@
 #include "VKpipeline.h"
 #include "VKframeInfo.h"
 #include "VKdescriptor.h"
+#include "VKinstanceBuffer.h"
 
 namespace GfxRenderEngine
 {
-    struct VK_PushConstantDataPbrDiffuse
-    {
-        glm::mat4 m_ModelMatrix{1.0f};
-        glm::mat4 m_NormalMatrix{1.0f}; // 4x4 because of alignment
-    };
-
     class VK_RenderSystemPbrDiffuse
     {
 
@@ -64,8 +59,10 @@ namespace GfxRenderEngine
 
     private:
 
+        bool m_BindlessTextures;
         VkPipelineLayout m_PipelineLayout;
         std::unique_ptr<VK_Pipeline> m_Pipeline;
+        VK_InstanceBatch m_InstanceBatch;
 
     };
 }
@@ -41,19 +41,14 @@ namespace GfxRenderEngine
 
     void VK_RenderSystemPbrNoMap::CreatePipelineLayout(VkDescriptorSetLayout globalDescriptorSetLayout)
     {
-        VkPushConstantRange pushConstantRange{};
-        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        pushConstantRange.offset = 0;
-        pushConstantRange.size = sizeof(VK_PushConstantDataPbrNoMap);
-
         std::vector<VkDescriptorSetLayout> descriptorSetLayouts{globalDescriptorSetLayout};
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
         pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         pipelineLayoutInfo.setLayoutCount = static_cast<uint>(descriptorSetLayouts.size());
         pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-        pipelineLayoutInfo.pushConstantRangeCount = 1;
-        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        pipelineLayoutInfo.pushConstantRangeCount = 0;
+        pipelineLayoutInfo.pPushConstantRanges = nullptr;
         if (vkCreatePipelineLayout(VK_Core::m_Device->Device(), &pipelineLayoutInfo, nullptr, &m_PipelineLayout) != VK_SUCCESS)
         {
             LOG_CORE_CRITICAL("failed to create pipeline layout!");
@@ -98,30 +93,24 @@ namespace GfxRenderEngine
         auto view = registry.view<MeshComponent, TransformComponent, PbrNoMapComponent>();
         for (auto entity : view)
         {
-            auto& pbrNoMapComponent = view.get<PbrNoMapComponent>(entity);
-            auto& transform = view.get<TransformComponent>(entity);
-            VK_PushConstantDataPbrNoMap push{};
-
-            push.m_ModelMatrix  = transform.GetMat4();
-            push.m_NormalMatrix = transform.GetNormalMatrix();
-            push.m_NormalMatrix[3].x = pbrNoMapComponent.m_Roughness;
-            push.m_NormalMatrix[3].y = pbrNoMapComponent.m_Metallic;
-
-            vkCmdPushConstants(
-                frameInfo.m_CommandBuffer,
-                m_PipelineLayout,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(VK_PushConstantDataPbrNoMap),
-                &push);
-
             auto& mesh = view.get<MeshComponent>(entity);
-            if (mesh.m_Enabled)
+            auto& transform = view.get<TransformComponent>(entity);
+            if (!mesh.m_Enabled || !frameInfo.m_Frustum.IsVisible(mesh.GetAABB(), mesh.GetBoundingSphere(), transform.GetMat4()))
             {
-                static_cast<VK_Model*>(mesh.m_Model.get())->Bind(frameInfo.m_CommandBuffer);
-                static_cast<VK_Model*>(mesh.m_Model.get())->Draw(frameInfo.m_CommandBuffer);
+                continue;
             }
+
+            auto& pbrNoMapComponent = view.get<PbrNoMapComponent>(entity);
+            VK_InstanceData instance{};
+            instance.m_ModelMatrix  = transform.GetMat4();
+            instance.m_NormalMatrix = transform.GetNormalMatrix();
+            instance.m_NormalMatrix[3].x = pbrNoMapComponent.m_Roughness;
+            instance.m_NormalMatrix[3].y = pbrNoMapComponent.m_Metallic;
+
+            m_InstanceBatch.Add(static_cast<VK_Model*>(mesh.m_Model.get()), VK_NULL_HANDLE, instance);
         }
-    }
 
+        // one instanced draw per material and model
+        m_InstanceBatch.Draw(frameInfo, m_PipelineLayout);
+    }
 }
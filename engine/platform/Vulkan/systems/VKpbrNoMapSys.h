@@ -35,15 +35,10 @@
 #include "VKpipeline.h"
 #include "VKframeInfo.h"
 #include "VKdescriptor.h"
+#include "VKinstanceBuffer.h"
 
 namespace GfxRenderEngine
 {
-    struct VK_PushConstantDataPbrNoMap
-    {
-        glm::mat4 m_ModelMatrix{1.0f};
-        glm::mat4 m_NormalMatrix{1.0f}; // 4x4 because of alignment
-    };
-
     class VK_RenderSystemPbrNoMap
     {
 
@@ -66,6 +61,7 @@ namespace GfxRenderEngine
 
         VkPipelineLayout m_PipelineLayout;
         std::unique_ptr<VK_Pipeline> m_Pipeline;
+        VK_InstanceBatch m_InstanceBatch;
 
     };
 }
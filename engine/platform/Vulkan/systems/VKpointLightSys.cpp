@@ -27,6 +27,7 @@
 
 #include "VKswapChain.h"
 #include "VKmodel.h"
+#include "VKinstanceBuffer.h"
 
 namespace GfxRenderEngine
 {
@@ -130,6 +131,7 @@ namespace GfxRenderEngine
             );
 
             vkCmdDraw(frameInfo.m_CommandBuffer, 6, 1, 0, 0);
+            frameInfo.m_InstanceBuffer->AddDrawCalls(1);
         }
     }
 
@@ -0,0 +1,202 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define FRUSTUM_SSE
+    #include <xmmintrin.h>
+#endif
+
+#include <cmath>
+#include <algorithm>
+
+#include "renderer/frustum.h"
+
+namespace GfxRenderEngine
+{
+    // distance that is never reached: the plane accepts everything
+    static constexpr float ACCEPT_ALL = 1.0e30f;
+
+    Frustum::Frustum()
+    {
+        for (uint i = 0; i < PLANES; i++)
+        {
+            m_X[i] = m_Y[i] = m_Z[i] = 0.0f;
+            m_W[i] = ACCEPT_ALL;
+        }
+    }
+
+    Frustum::Frustum(const glm::mat4& viewProjection)
+        : Frustum()
+    {
+        Update(viewProjection);
+    }
+
+    void Frustum::Update(const glm::mat4& viewProjection)
+    {
+        // Gribb/Hartmann: planes are sums and differences of the matrix rows
+        auto row = [&viewProjection](int index)
+        {
+            return glm::vec4(viewProjection[0][index], viewProjection[1][index], viewProjection[2][index], viewProjection[3][index]);
+        };
+
+        glm::vec4 planes[6] =
+        {
+            row(3) + row(0), // left
+            row(3) - row(0), // right
+            row(3) + row(1), // bottom
+            row(3) - row(1), // top
+            row(2),          // near (depth zero to one)
+            row(3) - row(2)  // far
+        };
+
+        for (uint i = 0; i < 6; i++)
+        {
+            float length = glm::length(glm::vec3(planes[i]));
+            if (length > 0.0f)
+            {
+                planes[i] /= length;
+            }
+            m_X[i] = planes[i].x;
+            m_Y[i] = planes[i].y;
+            m_Z[i] = planes[i].z;
+            m_W[i] = planes[i].w;
+        }
+    }
+
+    bool Frustum::IsVisible(const AABB& aabb, const BoundingSphere& sphere, const glm::mat4& modelMatrix) const
+    {
+        switch (TestSphere(sphere, modelMatrix))
+        {
+            case Containment::Outside:
+                return false;
+            case Containment::Inside:
+                return true;
+            default:
+                // the box is tighter than the sphere
+                return IsVisible(aabb, modelMatrix);
+        }
+    }
+
+    bool Frustum::IsVisible(const BoundingSphere& sphere, const glm::mat4& modelMatrix) const
+    {
+        return TestSphere(sphere, modelMatrix) != Containment::Outside;
+    }
+
+    Frustum::Containment Frustum::TestSphere(const BoundingSphere& sphere, const glm::mat4& modelMatrix) const
+    {
+        glm::vec3 center = modelMatrix * glm::vec4(sphere.m_Center, 1.0f);
+        float scale = std::max({glm::length(glm::vec3(modelMatrix[0])),
+                                glm::length(glm::vec3(modelMatrix[1])),
+                                glm::length(glm::vec3(modelMatrix[2]))});
+        float radius = sphere.m_Radius * scale;
+
+        #ifdef FRUSTUM_SSE
+            __m128 centerX = _mm_set1_ps(center.x);
+            __m128 centerY = _mm_set1_ps(center.y);
+            __m128 centerZ = _mm_set1_ps(center.z);
+            __m128 positiveRadius = _mm_set1_ps(radius);
+            __m128 negativeRadius = _mm_set1_ps(-radius);
+            int intersecting = 0;
+            for (uint i = 0; i < PLANES; i += 4)
+            {
+                __m128 distance = _mm_add_ps
+                (
+                    _mm_add_ps(_mm_mul_ps(_mm_load_ps(&m_X[i]), centerX), _mm_mul_ps(_mm_load_ps(&m_Y[i]), centerY)),
+                    _mm_add_ps(_mm_mul_ps(_mm_load_ps(&m_Z[i]), centerZ), _mm_load_ps(&m_W[i]))
+                );
+                if (_mm_movemask_ps(_mm_cmplt_ps(distance, negativeRadius)))
+                {
+                    return Containment::Outside;
+                }
+                intersecting |= _mm_movemask_ps(_mm_cmplt_ps(distance, positiveRadius));
+            }
+        #else
+            bool intersecting = false;
+            for (uint i = 0; i < PLANES; i++)
+            {
+                float distance = m_X[i] * center.x + m_Y[i] * center.y + m_Z[i] * center.z + m_W[i];
+                if (distance < -radius)
+                {
+                    return Containment::Outside;
+                }
+                intersecting |= (distance < radius);
+            }
+        #endif
+        return intersecting ? Containment::Intersecting : Containment::Inside;
+    }
+
+    bool Frustum::IsVisible(const AABB& aabb, const glm::mat4& modelMatrix) const
+    {
+        // world-space box around the transformed box (Arvo)
+        glm::vec3 localCenter = (aabb.m_Min + aabb.m_Max) * 0.5f;
+        glm::vec3 localExtent = (aabb.m_Max - aabb.m_Min) * 0.5f;
+        glm::vec3 center = modelMatrix * glm::vec4(localCenter, 1.0f);
+        glm::vec3 extent
+        {
+            std::abs(modelMatrix[0].x) * localExtent.x + std::abs(modelMatrix[1].x) * localExtent.y + std::abs(modelMatrix[2].x) * localExtent.z,
+            std::abs(modelMatrix[0].y) * localExtent.x + std::abs(modelMatrix[1].y) * localExtent.y + std::abs(modelMatrix[2].y) * localExtent.z,
+            std::abs(modelMatrix[0].z) * localExtent.x + std::abs(modelMatrix[1].z) * localExtent.y + std::abs(modelMatrix[2].z) * localExtent.z
+        };
+
+        #ifdef FRUSTUM_SSE
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            __m128 centerX = _mm_set1_ps(center.x);
+            __m128 centerY = _mm_set1_ps(center.y);
+            __m128 centerZ = _mm_set1_ps(center.z);
+            __m128 extentX = _mm_set1_ps(extent.x);
+            __m128 extentY = _mm_set1_ps(extent.y);
+            __m128 extentZ = _mm_set1_ps(extent.z);
+            for (uint i = 0; i < PLANES; i += 4)
+            {
+                __m128 planeX = _mm_load_ps(&m_X[i]);
+                __m128 planeY = _mm_load_ps(&m_Y[i]);
+                __m128 planeZ = _mm_load_ps(&m_Z[i]);
+                __m128 distance = _mm_add_ps
+                (
+                    _mm_add_ps(_mm_mul_ps(planeX, centerX), _mm_mul_ps(planeY, centerY)),
+                    _mm_add_ps(_mm_mul_ps(planeZ, centerZ), _mm_load_ps(&m_W[i]))
+                );
+                // projected half size of the box onto the plane normal
+                __m128 radius = _mm_add_ps
+                (
+                    _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, planeX), extentX), _mm_mul_ps(_mm_andnot_ps(signMask, planeY), extentY)),
+                    _mm_mul_ps(_mm_andnot_ps(signMask, planeZ), extentZ)
+                );
+                if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps())))
+                {
+                    return false;
+                }
+            }
+        #else
+            for (uint i = 0; i < PLANES; i++)
+            {
+                float distance = m_X[i] * center.x + m_Y[i] * center.y + m_Z[i] * center.z + m_W[i];
+                float radius = std::abs(m_X[i]) * extent.x + std::abs(m_Y[i]) * extent.y + std::abs(m_Z[i]) * extent.z;
+                if (distance + radius < 0.0f)
+                {
+                    return false;
+                }
+            }
+        #endif
+        return true;
+    }
+}
@@ -0,0 +1,70 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include "engine.h"
+#include "renderer/boundingVolume.h"
+
+namespace GfxRenderEngine
+{
+    // the six planes of a view frustum, extracted from projection * view
+    // (Vulkan clip space, depth from zero to one)
+    class Frustum
+    {
+
+    public:
+
+        Frustum();
+        Frustum(const glm::mat4& viewProjection);
+
+        void Update(const glm::mat4& viewProjection);
+
+        // bounding volumes are in model space; the sphere is tested first,
+        // the box only if the sphere intersects a plane
+        bool IsVisible(const AABB& aabb, const BoundingSphere& sphere, const glm::mat4& modelMatrix) const;
+        bool IsVisible(const BoundingSphere& sphere, const glm::mat4& modelMatrix) const;
+        bool IsVisible(const AABB& aabb, const glm::mat4& modelMatrix) const;
+
+    private:
+
+        enum class Containment
+        {
+            Outside,
+            Intersecting,
+            Inside
+        };
+
+        Containment TestSphere(const BoundingSphere& sphere, const glm::mat4& modelMatrix) const;
+
+    private:
+
+        // planes as structure of arrays for a 4-wide test;
+        // entries 6 and 7 are padding and accept everything
+        static constexpr uint PLANES = 8;
+        alignas(16) float m_X[PLANES];
+        alignas(16) float m_Y[PLANES];
+        alignas(16) float m_Z[PLANES];
+        alignas(16) float m_W[PLANES];
+
+    };
+}
@@ -48,3 +48,19 @@ std::shared_ptr<GraphicsContext> GraphicsContext::Create(void* window, uint refr
     return graphicsContext;
 }
 
+std::shared_ptr<GraphicsContext> GraphicsContext::CreateHeadless(uint width, uint height)
+{
+    std::shared_ptr<GraphicsContext> graphicsContext;
+
+    switch(RendererAPI::GetAPI())
+    {
+        case RendererAPI::VULKAN:
+            graphicsContext = std::make_shared<VK_Context>(width, height);
+            break;
+        default:
+            graphicsContext = nullptr;
+            break;
+    }
+
+    return graphicsContext;
+}
@@ -46,12 +46,15 @@ namespace GfxRenderEngine
 
         virtual std::shared_ptr<Renderer> GetRenderer() const = 0;
         virtual std::shared_ptr<Model> LoadModel(const Builder& builder) = 0;
+        virtual void BeginUploadBatch() = 0;
+        virtual void EndUploadBatch() = 0;
         virtual void ToggleDebugWindow(const GenericCallback& callback = nullptr) = 0;
 
         virtual uint GetContextWidth() const = 0;
         virtual uint GetContextHeight() const = 0;
 
         static std::shared_ptr<GraphicsContext> Create(void* window, uint refreshRate = 60);
+        static std::shared_ptr<GraphicsContext> CreateHeadless(uint width, uint height);
 
     private: 
     
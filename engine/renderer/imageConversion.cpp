@@ -0,0 +1,120 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define IMAGE_CONVERSION_SSSE3
+    #include <tmmintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#endif
+
+#include <cstring>
+
+#include "renderer/imageConversion.h"
+
+// the SSSE3 path is selected at run time, the rest of the engine is not built for SSSE3
+#if defined(IMAGE_CONVERSION_SSSE3) && (defined(__GNUC__) || defined(__clang__))
+    #define TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+    #define TARGET_SSSE3
+#endif
+
+namespace GfxRenderEngine
+{
+    void ImageConversion::RGBToRGBA(const uchar* rgb, uchar* rgba, size_t pixelCount)
+    {
+        size_t converted = 0;
+        if (SupportsSSSE3())
+        {
+            converted = RGBToRGBASSSE3(rgb, rgba, pixelCount);
+        }
+        RGBToRGBAScalar(rgb + converted * 3, rgba + converted * 4, pixelCount - converted);
+    }
+
+    void ImageConversion::RGBToRGBAScalar(const uchar* rgb, uchar* rgba, size_t pixelCount)
+    {
+        for (size_t pixel = 0; pixel < pixelCount; pixel++)
+        {
+            rgba[0] = rgb[0];
+            rgba[1] = rgb[1];
+            rgba[2] = rgb[2];
+            rgba[3] = 0xff;
+            rgb += 3;
+            rgba += 4;
+        }
+    }
+
+    // 16 pixels per iteration: three 16-byte loads, four shuffled 16-byte stores;
+    // returns the number of converted pixels, the remainder is left to the scalar loop
+    TARGET_SSSE3 size_t ImageConversion::RGBToRGBASSSE3(const uchar* rgb, uchar* rgba, size_t pixelCount)
+    {
+        #ifdef IMAGE_CONVERSION_SSSE3
+            const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+
+            size_t blocks = pixelCount / 16;
+            for (size_t block = 0; block < blocks; block++)
+            {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 16));
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 32));
+
+                // each register holds the 12 source bytes of four pixels in its lower lanes
+                __m128i pixels0 = a;
+                __m128i pixels1 = _mm_alignr_epi8(b, a, 12);
+                __m128i pixels2 = _mm_alignr_epi8(c, b, 8);
+                __m128i pixels3 = _mm_srli_si128(c, 4);
+
+                __m128i* destination = reinterpret_cast<__m128i*>(rgba);
+                _mm_storeu_si128(destination + 0, _mm_or_si128(_mm_shuffle_epi8(pixels0, shuffle), alpha));
+                _mm_storeu_si128(destination + 1, _mm_or_si128(_mm_shuffle_epi8(pixels1, shuffle), alpha));
+                _mm_storeu_si128(destination + 2, _mm_or_si128(_mm_shuffle_epi8(pixels2, shuffle), alpha));
+                _mm_storeu_si128(destination + 3, _mm_or_si128(_mm_shuffle_epi8(pixels3, shuffle), alpha));
+
+                rgb += 48;
+                rgba += 64;
+            }
+            return blocks * 16;
+        #else
+            return 0;
+        #endif
+    }
+
+    bool ImageConversion::SupportsSSSE3()
+    {
+        #if defined(IMAGE_CONVERSION_SSSE3) && defined(_MSC_VER)
+            static const bool supported = []()
+            {
+                int cpuInfo[4];
+                __cpuid(cpuInfo, 1);
+                return (cpuInfo[2] & (1 << 9)) != 0;
+            }();
+            return supported;
+        #elif defined(IMAGE_CONVERSION_SSSE3)
+            static const bool supported = __builtin_cpu_supports("ssse3");
+            return supported;
+        #else
+            return false;
+        #endif
+    }
+}
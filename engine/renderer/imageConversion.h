@@ -0,0 +1,49 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <cstddef>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+
+    // pixel format conversions for texture uploads
+    class ImageConversion
+    {
+
+    public:
+
+        // expands packed RGB8 to RGBA8 with opaque alpha; the destination may be
+        // mapped (write-combined) staging memory, it is written sequentially and never read
+        static void RGBToRGBA(const uchar* rgb, uchar* rgba, size_t pixelCount);
+
+    private:
+
+        static void RGBToRGBAScalar(const uchar* rgb, uchar* rgba, size_t pixelCount);
+        static size_t RGBToRGBASSSE3(const uchar* rgb, uchar* rgba, size_t pixelCount);
+        static bool SupportsSSSE3();
+
+    };
+}
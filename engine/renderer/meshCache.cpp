@@ -0,0 +1,160 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#include "renderer/meshCache.h"
+#include "auxiliary/mappedFile.h"
+#include "auxiliary/assetSystem.h"
+#include "auxiliary/hash.h"
+#include "auxiliary/file.h"
+
+namespace GfxRenderEngine
+{
+
+    uint64 MeshCache::HashFile(const std::string& filepath, uint64 seed)
+    {
+        // packaged files store their content hash, loose files are hashed
+        uint64 hash = AssetSystem::Hash(filepath);
+        if (!hash)
+        {
+            return 0;
+        }
+        if (seed)
+        {
+            HashCombine(hash, seed);
+        }
+        return hash;
+    }
+
+    std::string MeshCache::GetFilepath(uint64 key)
+    {
+        std::stringstream filepath;
+        filepath << CACHE_DIRECTORY << std::hex << std::setw(16) << std::setfill('0') << key << ".mesh";
+        return filepath.str();
+    }
+
+    bool MeshCache::Load(uint64 key, std::vector<Vertex>& vertices, std::vector<uint>& indices, std::vector<Primitive>& primitives)
+    {
+        if (!key)
+        {
+            return false;
+        }
+
+        MappedFile file(GetFilepath(key));
+        if (!file.IsValid() || (file.Size() < sizeof(Header)))
+        {
+            return false;
+        }
+
+        Header header;
+        memcpy(&header, file.Data(), sizeof(Header));
+        if ((header.m_Magic != MAGIC) || (header.m_Version != VERSION) ||
+            (header.m_VertexSize != sizeof(Vertex)) || (header.m_PrimitiveSize != sizeof(Primitive)) ||
+            (header.m_Key != key))
+        {
+            LOG_CORE_WARN("MeshCache::Load: ignoring stale cache file {0}", GetFilepath(key));
+            return false;
+        }
+
+        size_t vertexBytes    = header.m_VertexCount    * sizeof(Vertex);
+        size_t indexBytes     = header.m_IndexCount     * sizeof(uint);
+        size_t primitiveBytes = header.m_PrimitiveCount * sizeof(Primitive);
+        if (file.Size() != sizeof(Header) + vertexBytes + indexBytes + primitiveBytes)
+        {
+            LOG_CORE_WARN("MeshCache::Load: truncated cache file {0}", GetFilepath(key));
+            return false;
+        }
+
+        const uchar* data = file.Data() + sizeof(Header);
+        vertices.resize(header.m_VertexCount);
+        memcpy(vertices.data(), data, vertexBytes);
+        data += vertexBytes;
+
+        indices.resize(header.m_IndexCount);
+        memcpy(indices.data(), data, indexBytes);
+        data += indexBytes;
+
+        primitives.resize(header.m_PrimitiveCount);
+        memcpy(primitives.data(), data, primitiveBytes);
+
+        return true;
+    }
+
+    bool MeshCache::Save(uint64 key, const std::vector<Vertex>& vertices, const std::vector<uint>& indices, const std::vector<Primitive>& primitives)
+    {
+        if (!key)
+        {
+            return false;
+        }
+
+        if (!EngineCore::IsDirectory(CACHE_DIRECTORY))
+        {
+            EngineCore::CreateDirectory(CACHE_DIRECTORY);
+        }
+
+        Header header{};
+        header.m_Magic          = MAGIC;
+        header.m_Version        = VERSION;
+        header.m_VertexSize     = sizeof(Vertex);
+        header.m_PrimitiveSize  = sizeof(Primitive);
+        header.m_Key            = key;
+        header.m_VertexCount    = vertices.size();
+        header.m_IndexCount     = indices.size();
+        header.m_PrimitiveCount = primitives.size();
+
+        // write to a temporary file first so that a crash never leaves a partial cache entry behind
+        std::string filepath = GetFilepath(key);
+        // (one per thread: files with the same content may be saved concurrently while a scene loads)
+        std::string tmpFilepath = EngineCore::GetTemporaryFilepath(filepath);
+        {
+            std::ofstream outputFile(tmpFilepath, std::ios::binary | std::ios::trunc);
+            if (!outputFile.is_open())
+            {
+                LOG_CORE_WARN("MeshCache::Save: could not open {0}", tmpFilepath);
+                return false;
+            }
+            outputFile.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            outputFile.write(reinterpret_cast<const char*>(vertices.data()),   vertices.size()   * sizeof(Vertex));
+            outputFile.write(reinterpret_cast<const char*>(indices.data()),    indices.size()    * sizeof(uint));
+            outputFile.write(reinterpret_cast<const char*>(primitives.data()), primitives.size() * sizeof(Primitive));
+            if (!outputFile.good())
+            {
+                LOG_CORE_WARN("MeshCache::Save: could not write {0}", tmpFilepath);
+                return false;
+            }
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(tmpFilepath, filepath, errorCode);
+        if (errorCode)
+        {
+            LOG_CORE_WARN("MeshCache::Save: could not rename {0} ({1})", tmpFilepath, errorCode.message());
+            std::filesystem::remove(tmpFilepath, errorCode);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,67 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "engine.h"
+#include "renderer/model.h"
+
+namespace GfxRenderEngine
+{
+
+    // on-disk cache of the final vertex/index/primitive arrays produced by the Builder,
+    // keyed by a hash of the source file contents and the load parameters
+    class MeshCache
+    {
+
+    public:
+
+        static uint64 HashFile(const std::string& filepath, uint64 seed = 0);
+
+        static bool Load(uint64 key, std::vector<Vertex>& vertices, std::vector<uint>& indices, std::vector<Primitive>& primitives);
+        static bool Save(uint64 key, const std::vector<Vertex>& vertices, const std::vector<uint>& indices, const std::vector<Primitive>& primitives);
+
+    private:
+
+        struct Header
+        {
+            uint   m_Magic;
+            uint   m_Version;
+            uint   m_VertexSize;
+            uint   m_PrimitiveSize;
+            uint64 m_Key;
+            uint64 m_VertexCount;
+            uint64 m_IndexCount;
+            uint64 m_PrimitiveCount;
+        };
+
+        static constexpr uint MAGIC   = 0x4853454d; // "MESH"
+        static constexpr uint VERSION = 2;
+        static constexpr const char* CACHE_DIRECTORY = "bin/cache/meshes/";
+
+        static std::string GetFilepath(uint64 key);
+
+    };
+}
@@ -23,6 +23,7 @@
 #include <memory>
 #include <iostream>
 #include <unordered_map>
+#include <sstream>
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
@@ -32,9 +33,13 @@
 
 #include "core.h"
 #include "VKmodel.h"
+#include "VKrenderer.h"
 #include "renderer/model.h"
+#include "renderer/meshCache.h"
+#include "renderer/modelCache.h"
 #include "auxiliary/hash.h"
 #include "auxiliary/file.h"
+#include "auxiliary/assetSystem.h"
 #include "auxiliary/debug.h"
 #include "auxiliary/math.h"
 #include "scene/scene.h"
@@ -55,6 +60,60 @@ namespace std
 
 namespace GfxRenderEngine
 {
+    namespace
+    {
+        // tinygltf and tinyobj read their files through the asset system;
+        // tinygltf keeps its buffers in vectors, so these are copied
+        bool AssetFileExists(const std::string& filepath, void*)
+        {
+            return AssetSystem::Exists(filepath);
+        }
+
+        bool AssetReadWholeFile(std::vector<unsigned char>* data, std::string* err, const std::string& filepath, void*)
+        {
+            if (!AssetSystem::Read(filepath, *data))
+            {
+                if (err)
+                {
+                    (*err) += "File read error : " + filepath + "\n";
+                }
+                return false;
+            }
+            return true;
+        }
+
+        class AssetMaterialReader : public tinyobj::MaterialReader
+        {
+
+        public:
+
+            AssetMaterialReader(const std::string& baseDirectory)
+                : m_BaseDirectory(baseDirectory) {}
+
+            bool operator()(const std::string& materialId, std::vector<tinyobj::material_t>* materials,
+                            std::map<std::string, int>* materialMap, std::string* warn, std::string* err) override
+            {
+                AssetData data;
+                if (!AssetSystem::Load(m_BaseDirectory + materialId, data))
+                {
+                    if (warn)
+                    {
+                        (*warn) += "Material file [ " + m_BaseDirectory + materialId + " ] not found.\n";
+                    }
+                    return false;
+                }
+                AssetStream stream(data);
+                tinyobj::LoadMtl(materialMap, materials, &stream, warn, err);
+                return true;
+            }
+
+        private:
+
+            std::string m_BaseDirectory;
+
+        };
+    }
+
     bool Vertex::operator==(const Vertex& other) const
     {
         return (m_Position    == other.m_Position) &&
@@ -67,7 +126,7 @@ namespace GfxRenderEngine
     }
 
     Builder::Builder(const std::string& filepath)
-        : m_Filepath(filepath), m_Transform(nullptr)
+        : m_Filepath(filepath), m_Transform(nullptr), m_GltfHash(0)
     {
         m_Basepath = EngineCore::GetPathWithoutFilename(filepath);
     }
@@ -75,38 +134,63 @@ namespace GfxRenderEngine
     void Builder::LoadImagesGLTF()
     {
         m_ImageOffset = VK_Model::m_Images.size();
+
+        // normal maps are stored linear, all other maps keep their sRGB encoding
+        // (material texture indices address the images directly, see AssignMaterial())
+        std::vector<bool> isNormalMap(m_GltfModel.images.size(), false);
+        for (auto& material : m_Materials)
+        {
+            if ((material.m_Features & Material::HAS_NORMAL_MAP) && (material.m_NormalMapIndex < isNormalMap.size()))
+            {
+                isNormalMap[material.m_NormalMapIndex] = true;
+            }
+        }
+
         // retrieve all images from the glTF file
         for (uint i = 0; i < m_GltfModel.images.size(); i++)
         {
             std::string imageFilepath = m_Basepath + m_GltfModel.images[i].uri;
             tinygltf::Image& glTFImage = m_GltfModel.images[i];
 
-            // glTFImage.component - the number of channels in each pixel
-            // three channels per pixel need to be converted to four channels per pixel
-            uchar* buffer;
-            uint64 bufferSize;
-            if (glTFImage.component == 3)
+            if (VK_Renderer::m_ResourceStreamer->StreamsTextures())
             {
-                bufferSize = glTFImage.width * glTFImage.height * 4;
-                std::vector<uchar> imageData(bufferSize, 0x00);
+                // converted, compressed and uploaded in the background, see VK_ResourceStreamer
+                auto format = isNormalMap[i] ? TextureCompressor::Format::BC5 : TextureCompressor::Format::BC1;
+                auto texture = VK_Renderer::m_ResourceStreamer->Load
+                (
+                    glTFImage.width, glTFImage.height, glTFImage.component, std::move(glTFImage.image),
+                    COMPRESS_TEXTURES, format, !isNormalMap[i]
+                );
+                VK_Model::m_Images.push_back(texture);
+                continue;
+            }
 
-                buffer = (uchar*)imageData.data();
-                uchar* rgba = buffer;
-                uchar* rgb = &glTFImage.image[0];
-                for (uint i = 0; i < glTFImage.width * glTFImage.height; ++i)
+            // glTFImage.component - the number of channels in each pixel (3 or 4, see DecodeImagesGLTF());
+            // VK_Texture expands RGB to RGBA while writing the staging buffer
+            uint channels = glTFImage.component;
+            uchar* buffer = glTFImage.image.data();
+            auto texture = std::make_shared<VK_Texture>(Engine::m_TextureSlotManager);
+            if (COMPRESS_TEXTURES)
+            {
+                TextureCompressor::Format format;
+                if (isNormalMap[i])
                 {
-                    memcpy(rgba, rgb, sizeof(uchar) * 3);
-                    rgba += 4;
-                    rgb += 3;
+                    format = TextureCompressor::Format::BC5;
                 }
+                else if ((channels == 3) || TextureCompressor::IsOpaque(buffer, glTFImage.width, glTFImage.height))
+                {
+                    format = TextureCompressor::Format::BC1;
+                }
+                else
+                {
+                    format = TextureCompressor::Format::BC3;
+                }
+                texture->InitCompressed(glTFImage.width, glTFImage.height, buffer, format, !isNormalMap[i], channels);
             }
             else
             {
-                buffer = &glTFImage.image[0];
-                bufferSize = glTFImage.image.size();
+                texture->Init(glTFImage.width, glTFImage.height, buffer, !isNormalMap[i] /*sRGB*/, channels);
             }
-            auto texture = std::make_shared<VK_Texture>(Engine::m_TextureSlotManager);
-            texture->Init(glTFImage.width, glTFImage.height, buffer);
             VK_Model::m_Images.push_back(texture);
         }
     }
@@ -156,6 +240,18 @@ namespace GfxRenderEngine
 
     void Builder::LoadVertexDataGLTF(uint meshIndex)
     {
+        uint64 cacheKey = 0;
+        if (m_GltfHash)
+        {
+            cacheKey = m_GltfHash;
+            HashCombine(cacheKey, meshIndex);
+            if (MeshCache::Load(cacheKey, m_Vertices, m_Indices, m_Primitives))
+            {
+                CalculateBoundingVolumes();
+                return;
+            }
+        }
+
         // handle vertex data
         m_Vertices.clear();
         m_Indices.clear();
@@ -163,6 +259,8 @@ namespace GfxRenderEngine
 
         for (const auto& glTFPrimitive : m_GltfModel.meshes[meshIndex].primitives)
         {
+            uint firstVertex = static_cast<uint>(m_Vertices.size());
+            uint firstIndex  = static_cast<uint>(m_Indices.size());
             uint vertexCount = 0;
             uint indexCount  = 0;
 
@@ -253,16 +351,18 @@ namespace GfxRenderEngine
             }
 
             Primitive primitive;
-            primitive.m_FirstVertex = static_cast<uint32_t>(m_Vertices.size());
+            primitive.m_FirstVertex = firstVertex;
             primitive.m_VertexCount = vertexCount;
             primitive.m_IndexCount  = indexCount;
-            primitive.m_FirstIndex  = static_cast<uint32_t>(m_Indices.size());
+            primitive.m_FirstIndex  = firstIndex;
 
             m_Primitives.push_back(primitive);
         }
 
         // calculate tangents
         CalculateTangents();
+        CalculateBoundingVolumes();
+        MeshCache::Save(cacheKey, m_Vertices, m_Indices, m_Primitives);
     }
 
     void Builder::LoadTransformationMatrix(TransformComponent& transform, int nodeIndex)
@@ -416,17 +516,170 @@ namespace GfxRenderEngine
 
     void Builder::LoadGLTF(entt::registry& registry, TreeNode& sceneHierarchy, Dictionary& dictionary, TransformComponent* transform)
     {
-        std::string warn, err;
+        if (ParseGLTF())
+        {
+            BuildGLTF(registry, sceneHierarchy, dictionary);
+        }
+    }
 
-        stbi_set_flip_vertically_on_load(false);
+    bool Builder::ParseGLTF()
+    {
+        std::string warn, err;
 
-        if (!m_GltfLoader.LoadASCIIFromFile(&m_GltfModel, &err, &warn, m_Filepath))
+        // tinygltf only collects the encoded images, they are decoded in parallel afterwards
+        tinygltf::FsCallbacks fsCallbacks{&AssetFileExists, &tinygltf::ExpandFilePath, &AssetReadWholeFile, &tinygltf::WriteWholeFile, nullptr};
+        m_GltfLoader.SetFsCallbacks(fsCallbacks);
+        m_GltfLoader.SetImageLoader(&Builder::DeferImageData, this);
+        // the JSON is parsed in place
+        AssetData gltfData;
+        if (!AssetSystem::Load(m_Filepath, gltfData))
+        {
+            LOG_CORE_CRITICAL("LoadGLTF: could not read {0}", m_Filepath);
+            return false;
+        }
+        if (!m_GltfLoader.LoadASCIIFromString(&m_GltfModel, &err, &warn, reinterpret_cast<const char*>(gltfData.Data()),
+                                              static_cast<uint>(gltfData.Size()), EngineCore::GetPathWithoutFilename(m_Filepath)))
         {
             LOG_CORE_CRITICAL("LoadGLTF errors: {0}, warnings: {1}", err, warn);
+            return false;
+        }
+        if (!DecodeImagesGLTF())
+        {
+            return false;
         }
 
-        LoadImagesGLTF();
+        // the mesh cache key covers the glTF file and all of its buffers
+        m_GltfHash = MeshCache::HashFile(m_Filepath);
+        if (m_GltfHash)
+        {
+            for (auto& buffer : m_GltfModel.buffers)
+            {
+                HashCombine(m_GltfHash, HashBuffer(buffer.data.data(), buffer.data.size()));
+            }
+        }
+
+        // materials first: they determine how each image is stored
         LoadMaterialsGLTF();
+        PrepareMeshesGLTF();
+
+        m_Parsed = true;
+        return true;
+    }
+
+    bool Builder::DeferImageData(tinygltf::Image* image, const int imageIndex, std::string* err, std::string* warn,
+                                 int width, int height, const unsigned char* bytes, int size, void* userData)
+    {
+        auto builder = static_cast<Builder*>(userData);
+        if (imageIndex < 0 || !bytes || size <= 0)
+        {
+            if (err)
+            {
+                (*err) += "no image data for image[" + std::to_string(imageIndex) + "]\n";
+            }
+            return false;
+        }
+        if (builder->m_EncodedImages.size() <= static_cast<size_t>(imageIndex))
+        {
+            builder->m_EncodedImages.resize(imageIndex + 1);
+        }
+        builder->m_EncodedImages[imageIndex].assign(bytes, bytes + size);
+        return true;
+    }
+
+    bool Builder::DecodeImagesGLTF()
+    {
+        uint imageCount = static_cast<uint>(m_GltfModel.images.size());
+        m_EncodedImages.resize(imageCount);
+        std::vector<uchar> decoded(imageCount, false);
+
+        Engine::m_Engine->GetJobSystem().ParallelFor("Builder::DecodeImages", imageCount, 1, [&](uint begin, uint end)
+        {
+            // ParallelFor also runs on the calling thread; all stb_image users set the per-thread flag explicitly
+            stbi_set_flip_vertically_on_load_thread(false);
+            for (uint index = begin; index < end; index++)
+            {
+                auto& encoded = m_EncodedImages[index];
+                auto& glTFImage = m_GltfModel.images[index];
+                int width, height, channelsInFile;
+                if (!stbi_info_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channelsInFile))
+                {
+                    continue;
+                }
+
+                // RGB stays packed, it is expanded to RGBA on upload
+                int channels = (channelsInFile == 3) ? 3 : 4;
+                uchar* pixels = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channelsInFile, channels);
+                if (!pixels)
+                {
+                    continue;
+                }
+                glTFImage.width = width;
+                glTFImage.height = height;
+                glTFImage.component = channels;
+                glTFImage.bits = 8;
+                glTFImage.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+                glTFImage.image.assign(pixels, pixels + static_cast<size_t>(width) * height * channels);
+                stbi_image_free(pixels);
+                std::vector<uchar>().swap(encoded);
+                decoded[index] = true;
+            }
+        });
+        m_EncodedImages.clear();
+
+        for (uint index = 0; index < imageCount; index++)
+        {
+            if (!decoded[index])
+            {
+                LOG_CORE_CRITICAL("LoadGLTF: could not decode image {0} ('{1}') in {2}", index, m_GltfModel.images[index].uri, m_Filepath);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Builder::PrepareMeshesGLTF()
+    {
+        m_Meshes.clear();
+        m_Meshes.resize(m_GltfModel.meshes.size());
+        for (uint meshIndex = 0; meshIndex < m_GltfModel.meshes.size(); meshIndex++)
+        {
+            // meshes already resident on the GPU are shared, see CreateGameObject()
+            if (ModelCache::Get(GetModelKey(meshIndex)))
+            {
+                continue;
+            }
+
+            LoadVertexDataGLTF(meshIndex);
+
+            auto& mesh = m_Meshes[meshIndex];
+            mesh.m_Vertices.swap(m_Vertices);
+            mesh.m_Indices.swap(m_Indices);
+            mesh.m_Primitives.swap(m_Primitives);
+            mesh.m_AABB = m_AABB;
+            mesh.m_BoundingSphere = m_BoundingSphere;
+            mesh.m_Prepared = true;
+        }
+        m_Vertices.clear();
+        m_Indices.clear();
+        m_Primitives.clear();
+    }
+
+    uint64 Builder::GetModelKey(uint meshIndex) const
+    {
+        // nodes that reference the same mesh, also across files with the same content, share one model
+        uint64 contentHash = m_GltfHash ? m_GltfHash : std::hash<std::string>{}(m_Filepath);
+        return ModelCache::GetKey(contentHash, meshIndex);
+    }
+
+    void Builder::BuildGLTF(entt::registry& registry, TreeNode& sceneHierarchy, Dictionary& dictionary)
+    {
+        if (!m_Parsed)
+        {
+            LOG_CORE_WARN("Builder::BuildGLTF: {0} was not parsed", m_Filepath);
+            return;
+        }
+
+        LoadImagesGLTF();
 
         for (auto& scene : m_GltfModel.scenes)
         {
@@ -511,10 +764,33 @@ namespace GfxRenderEngine
         auto& nodeName = node.name;
         uint meshIndex = node.mesh;
 
-        LoadVertexDataGLTF(meshIndex);
-        LOG_CORE_INFO("Vertex count: {0}, Index count: {1} (file: {2}, node: {3})", m_Vertices.size(), m_Indices.size(), m_Filepath, nodeName);
+        uint64 modelKey = GetModelKey(meshIndex);
+        auto model = ModelCache::Get(modelKey);
+        if (model)
+        {
+            LOG_CORE_INFO("shared model (file: {0}, node: {1})", m_Filepath, nodeName);
+        }
+        else
+        {
+            auto& mesh = m_Meshes[meshIndex];
+            if (mesh.m_Prepared)
+            {
+                m_Vertices.swap(mesh.m_Vertices);
+                m_Indices.swap(mesh.m_Indices);
+                m_Primitives.swap(mesh.m_Primitives);
+                m_AABB = mesh.m_AABB;
+                m_BoundingSphere = mesh.m_BoundingSphere;
+                mesh = MeshData{};
+            }
+            else
+            {
+                // the model was released after parsing
+                LoadVertexDataGLTF(meshIndex);
+            }
+            LOG_CORE_INFO("Vertex count: {0}, Index count: {1} (file: {2}, node: {3})", m_Vertices.size(), m_Indices.size(), m_Filepath, nodeName);
+            model = ModelCache::Insert(modelKey, Engine::m_Engine->LoadModel(*this));
+        }
 
-        auto model = Engine::m_Engine->LoadModel(*this);
         auto entity = registry.create();
 
         auto longName = m_Filepath + std::string("::") + scene.name + std::string("::") + nodeName;
@@ -540,12 +816,30 @@ namespace GfxRenderEngine
 
     void Builder::LoadModel(const std::string &filepath, int diffuseMapTextureSlot, int fragAmplification, int normalTextureSlot)
     {
+        size_t parameters = 0;
+        HashCombine(parameters, diffuseMapTextureSlot, fragAmplification, normalTextureSlot);
+        uint64 cacheKey = MeshCache::HashFile(filepath, parameters);
+        if (MeshCache::Load(cacheKey, m_Vertices, m_Indices, m_Primitives))
+        {
+            CalculateBoundingVolumes();
+            LOG_CORE_INFO("Vertex count: {0}, Index count: {1} ({2}, cached)", m_Vertices.size(), m_Indices.size(), filepath);
+            return;
+        }
+
         tinyobj::attrib_t attrib;
         std::vector<tinyobj::shape_t> shapes;
         std::vector<tinyobj::material_t> materials;
         std::string warn, err;
 
-        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str()))
+        // material libraries are resolved relative to the OBJ file, through packages or loose files
+        AssetData objData;
+        if (!AssetSystem::Load(filepath, objData))
+        {
+            LOG_CORE_CRITICAL("LoadModel: could not read {0}", filepath);
+        }
+        AssetStream objStream(objData);
+        AssetMaterialReader materialReader(EngineCore::GetPathWithoutFilename(filepath));
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &objStream, &materialReader))
         {
             LOG_CORE_CRITICAL("LoadModel errors: {0}, warnings: {1}", err, warn);
         }
@@ -610,6 +904,8 @@ namespace GfxRenderEngine
         }
         // calculate tangents
         CalculateTangents();
+        CalculateBoundingVolumes();
+        MeshCache::Save(cacheKey, m_Vertices, m_Indices, m_Primitives);
         LOG_CORE_INFO("Vertex count: {0}, Index count: {1} ({2})", m_Vertices.size(), m_Indices.size(), filepath);
     }
 
@@ -681,6 +977,46 @@ namespace GfxRenderEngine
         }
     }
 
+    void Builder::CalculateBoundingVolumes()
+    {
+        for (auto& primitive : m_Primitives)
+        {
+            if (primitive.m_FirstVertex + primitive.m_VertexCount <= m_Vertices.size())
+            {
+                CalculateBoundingVolumes(m_Vertices.data() + primitive.m_FirstVertex, primitive.m_VertexCount,
+                                         primitive.m_AABB, primitive.m_BoundingSphere);
+            }
+        }
+        CalculateBoundingVolumes(m_Vertices.data(), static_cast<uint>(m_Vertices.size()), m_AABB, m_BoundingSphere);
+    }
+
+    void Builder::CalculateBoundingVolumes(const Vertex* vertices, uint vertexCount, AABB& aabb, BoundingSphere& sphere)
+    {
+        if (!vertexCount)
+        {
+            aabb = AABB{};
+            sphere = BoundingSphere{};
+            return;
+        }
+
+        aabb.m_Min = aabb.m_Max = vertices[0].m_Position;
+        for (uint index = 1; index < vertexCount; index++)
+        {
+            aabb.m_Min = glm::min(aabb.m_Min, vertices[index].m_Position);
+            aabb.m_Max = glm::max(aabb.m_Max, vertices[index].m_Position);
+        }
+
+        // centered on the box, tighter than its half diagonal
+        sphere.m_Center = (aabb.m_Min + aabb.m_Max) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (uint index = 0; index < vertexCount; index++)
+        {
+            glm::vec3 distance = vertices[index].m_Position - sphere.m_Center;
+            radiusSquared = std::max(radiusSquared, glm::dot(distance, distance));
+        }
+        sphere.m_Radius = std::sqrt(radiusSquared);
+    }
+
     void Builder::LoadSprite(Sprite* sprite, const glm::mat4& position, float amplification, int unlit, const glm::vec4& color)
     {
         m_Vertices.clear();
@@ -689,7 +1025,8 @@ namespace GfxRenderEngine
         // 0 - 1
         // | / |
         // 3 - 2
-        int slot = sprite->GetTextureSlot();
+        // all sprites live in the spritesheet; its slot in the texture table is not known to the shader
+        int slot = Vertex::SPRITESHEET;
 
         Vertex vertex[4]
         {
@@ -706,7 +1043,6 @@ namespace GfxRenderEngine
             {/*pos*/ {position[3]}, /*col*/ {0.0f, 0.9f, 0.1f}, /*norm*/ {0.0f, 0.0f, 1.0f}, /*uv*/ {sprite->m_Pos1X, 1.0f-sprite->m_Pos1Y}, slot, amplification, unlit}
         };
         for (int i = 0; i < 4; i++) m_Vertices.push_back(vertex[i]);
-        slot++;
 
         m_Indices.push_back(0);
         m_Indices.push_back(1);
@@ -714,6 +1050,8 @@ namespace GfxRenderEngine
         m_Indices.push_back(1);
         m_Indices.push_back(2);
         m_Indices.push_back(3);
+
+        CalculateBoundingVolumes();
     }
 
     void Builder::LoadParticle(const glm::vec4& color)
@@ -747,5 +1085,7 @@ namespace GfxRenderEngine
         m_Indices.push_back(1);
         m_Indices.push_back(2);
         m_Indices.push_back(3);
+
+        CalculateBoundingVolumes();
     }
 }
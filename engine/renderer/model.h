@@ -31,6 +31,7 @@
 #include "scene/components.h"
 #include "scene/dictionary.h"
 #include "renderer/texture.h"
+#include "renderer/boundingVolume.h"
 #include "sprite/sprite.h"
 #include "entt.hpp"
 
@@ -39,6 +40,11 @@ namespace GfxRenderEngine
 
     struct Vertex
     {
+        // values of m_DiffuseMapTextureSlot for the default diffuse shader; this is a marker,
+        // not a texture slot: the spritesheet is bound at set 0, binding 1 (see defaultDiffuseMap.frag)
+        static constexpr int NO_TEXTURE = 0;
+        static constexpr int SPRITESHEET = 1;
+
         glm::vec3 m_Position;
         glm::vec3 m_Color;
         glm::vec3 m_Normal;
@@ -58,6 +64,8 @@ namespace GfxRenderEngine
         uint m_FirstVertex;
         uint m_IndexCount;
         uint m_VertexCount;
+        AABB m_AABB;
+        BoundingSphere m_BoundingSphere;
     };
 
     struct Material
@@ -88,6 +96,11 @@ namespace GfxRenderEngine
 
         void LoadModel(const std::string& filepath, int diffuseMapTextureSlot = 0, int fragAmplification = 1.0, int normalTextureSlot = 0);
         void LoadGLTF(entt::registry& registry, TreeNode& sceneHierarchy, Dictionary& dictionary, TransformComponent* transform = nullptr);
+
+        // ParseGLTF touches no GPU or scene state and may run on a worker thread,
+        // BuildGLTF uploads the images and models and creates the entities on the main thread
+        bool ParseGLTF();
+        void BuildGLTF(entt::registry& registry, TreeNode& sceneHierarchy, Dictionary& dictionary);
         void LoadSprite(Sprite* sprite, const glm::mat4& position, float amplification, int unlit = 0, const glm::vec4& color = glm::vec4(1.0f));
         void LoadParticle(const glm::vec4& color);
 
@@ -97,16 +110,43 @@ namespace GfxRenderEngine
         std::vector<Vertex> m_Vertices{};
         std::vector<Primitive> m_Primitives{};
 
+        // bounding volumes of all vertices, in model space
+        AABB m_AABB;
+        BoundingSphere m_BoundingSphere;
+
+    private:
+
+        // glTF images are block-compressed (BC1/BC3 for color, BC5 for normal maps), see TextureCompressor
+        static constexpr bool COMPRESS_TEXTURES = true;
+
+        // vertex data of one glTF mesh, prepared by ParseGLTF
+        struct MeshData
+        {
+            bool m_Prepared{false};
+            std::vector<uint> m_Indices;
+            std::vector<Vertex> m_Vertices;
+            std::vector<Primitive> m_Primitives;
+            AABB m_AABB;
+            BoundingSphere m_BoundingSphere;
+        };
+
     private:
 
         void LoadImagesGLTF();
+        bool DecodeImagesGLTF();
+        static bool DeferImageData(tinygltf::Image* image, const int imageIndex, std::string* err, std::string* warn,
+                                   int width, int height, const unsigned char* bytes, int size, void* userData);
         void LoadMaterialsGLTF();
         void LoadVertexDataGLTF(uint meshIndex);
+        void PrepareMeshesGLTF();
+        uint64 GetModelKey(uint meshIndex) const;
         void LoadTransformationMatrix(TransformComponent& transform, int nodeIndex);
         void AssignMaterial(entt::registry& registry, entt::entity entity, int materialIndex);
         void ProcessNode(tinygltf::Scene& scene, uint nodeIndex, entt::registry& registry, Dictionary& dictionary, TreeNode* currentNode);
         TreeNode* CreateGameObject(tinygltf::Scene& scene, uint nodeIndex, entt::registry& registry, Dictionary& dictionary, TreeNode* currentNode);
         void CalculateTangents();
+        void CalculateBoundingVolumes();
+        static void CalculateBoundingVolumes(const Vertex* vertices, uint vertexCount, AABB& aabb, BoundingSphere& sphere);
 
     private:
 
@@ -117,6 +157,10 @@ namespace GfxRenderEngine
         std::vector<Material> m_Materials;
         TransformComponent* m_Transform;
         uint m_ImageOffset;
+        uint64 m_GltfHash;
+        std::vector<MeshData> m_Meshes;
+        std::vector<std::vector<uchar>> m_EncodedImages;
+        bool m_Parsed{false};
 
     };
 
@@ -134,5 +178,18 @@ namespace GfxRenderEngine
         virtual void CreateVertexBuffers(const std::vector<Vertex>& vertices) = 0;
         virtual void CreateIndexBuffers(const std::vector<uint>& indices) = 0;
 
+        const AABB& GetAABB() const { return m_AABB; }
+        const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
+
+        // model cache key, 0 for models that are not shared through the model cache
+        uint64 GetCacheKey() const { return m_CacheKey; }
+        void SetCacheKey(uint64 key) { m_CacheKey = key; }
+
+    protected:
+
+        AABB m_AABB;
+        BoundingSphere m_BoundingSphere;
+        uint64 m_CacheKey{0};
+
     };
 }
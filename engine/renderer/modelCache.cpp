@@ -0,0 +1,90 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "renderer/modelCache.h"
+#include "auxiliary/hash.h"
+
+namespace GfxRenderEngine
+{
+
+    std::mutex ModelCache::m_Mutex;
+    std::unordered_map<uint64, std::weak_ptr<Model>> ModelCache::m_Models;
+
+    uint64 ModelCache::GetKey(uint64 contentHash, uint meshIndex)
+    {
+        uint64 key = contentHash;
+        HashCombine(key, meshIndex);
+        return key;
+    }
+
+    std::shared_ptr<Model> ModelCache::Get(uint64 key)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto iterator = m_Models.find(key);
+        if (iterator == m_Models.end())
+        {
+            return nullptr;
+        }
+        return iterator->second.lock();
+    }
+
+    std::shared_ptr<Model> ModelCache::Insert(uint64 key, const std::shared_ptr<Model>& model)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto& entry = m_Models[key];
+        if (auto existing = entry.lock())
+        {
+            return existing;
+        }
+        model->SetCacheKey(key);
+        entry = model;
+
+        // keep the map from growing with entries of released models
+        if (m_Models.size() % 64 == 0)
+        {
+            RemoveExpired();
+        }
+        return model;
+    }
+
+    size_t ModelCache::Size()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        RemoveExpired();
+        return m_Models.size();
+    }
+
+    void ModelCache::RemoveExpired()
+    {
+        for (auto iterator = m_Models.begin(); iterator != m_Models.end();)
+        {
+            if (iterator->second.expired())
+            {
+                iterator = m_Models.erase(iterator);
+            }
+            else
+            {
+                ++iterator;
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
+#include "engine.h"
+#include "renderer/model.h"
+
+namespace GfxRenderEngine
+{
+
+    // in-memory registry of GPU models shared by all game objects that use the same mesh,
+    // keyed by content hash and mesh index; an entry expires with the last handle to its model
+    class ModelCache
+    {
+
+    public:
+
+        static uint64 GetKey(uint64 contentHash, uint meshIndex);
+
+        // nullptr if the model was never loaded or is no longer used
+        static std::shared_ptr<Model> Get(uint64 key);
+        // if another thread inserted the same key first, its model is returned instead
+        static std::shared_ptr<Model> Insert(uint64 key, const std::shared_ptr<Model>& model);
+
+        // number of models alive
+        static size_t Size();
+
+    private:
+
+        static void RemoveExpired();
+
+    private:
+
+        static std::mutex m_Mutex;
+        static std::unordered_map<uint64, std::weak_ptr<Model>> m_Models;
+
+    };
+}
@@ -0,0 +1,530 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <algorithm>
+
+#include "core.h"
+#include "renderer/textureCompressor.h"
+#include "auxiliary/mappedFile.h"
+#include "auxiliary/hash.h"
+#include "auxiliary/file.h"
+#include "auxiliary/instrumentation.h"
+
+namespace GfxRenderEngine
+{
+
+    namespace
+    {
+        uint16_t To565(const int* color)
+        {
+            int r = (color[0] * 31 + 127) / 255;
+            int g = (color[1] * 63 + 127) / 255;
+            int b = (color[2] * 31 + 127) / 255;
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        void From565(uint16_t color, int* rgb)
+        {
+            int r = (color >> 11) & 0x1f;
+            int g = (color >> 5)  & 0x3f;
+            int b =  color        & 0x1f;
+            rgb[0] = (r << 3) | (r >> 2);
+            rgb[1] = (g << 2) | (g >> 4);
+            rgb[2] = (b << 3) | (b >> 2);
+        }
+
+        // 8-bit sRGB to linear
+        struct SRGBToLinearTable
+        {
+            float m_Values[256];
+
+            SRGBToLinearTable()
+            {
+                for (uint i = 0; i < 256; i++)
+                {
+                    float value = static_cast<float>(i) / 255.0f;
+                    m_Values[i] = (value <= 0.04045f) ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+            }
+        };
+
+        // linear to 8-bit sRGB, sampled finely enough for the dark end of the curve
+        struct LinearToSRGBTable
+        {
+            static constexpr uint SIZE = 4096;
+            uchar m_Values[SIZE];
+
+            LinearToSRGBTable()
+            {
+                for (uint i = 0; i < SIZE; i++)
+                {
+                    float value = static_cast<float>(i) / static_cast<float>(SIZE - 1);
+                    float sRGB = (value <= 0.0031308f) ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                    m_Values[i] = static_cast<uchar>(std::clamp(sRGB * 255.0f + 0.5f, 0.0f, 255.0f));
+                }
+            }
+
+            uchar operator()(float linear) const
+            {
+                uint index = static_cast<uint>(std::clamp(linear, 0.0f, 1.0f) * static_cast<float>(SIZE - 1) + 0.5f);
+                return m_Values[index];
+            }
+        };
+    }
+
+    bool TextureCompressor::IsOpaque(const uchar* rgba, uint width, uint height)
+    {
+        size_t pixels = static_cast<size_t>(width) * height;
+        for (size_t pixel = 0; pixel < pixels; pixel++)
+        {
+            if (rgba[pixel * 4 + 3] != 0xff)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint64 TextureCompressor::GetKey(const uchar* rgba, uint width, uint height, Format format, bool sRGB)
+    {
+        uint64 key = HashBuffer(rgba, static_cast<size_t>(width) * height * 4);
+        HashCombine(key, width, height, static_cast<uint>(format), sRGB, VERSION);
+        return key;
+    }
+
+    std::string TextureCompressor::GetFilepath(uint64 key)
+    {
+        std::stringstream filepath;
+        filepath << CACHE_DIRECTORY << std::hex << std::setw(16) << std::setfill('0') << key << ".ctex";
+        return filepath.str();
+    }
+
+    bool TextureCompressor::GetCompressedImage(const uchar* rgba, uint width, uint height, Format format, bool sRGB, CompressedImage& image)
+    {
+        if (!rgba || !width || !height)
+        {
+            return false;
+        }
+
+        uint64 key = GetKey(rgba, width, height, format, sRGB);
+        if (Load(key, image))
+        {
+            return true;
+        }
+
+        Compress(rgba, width, height, format, sRGB, image);
+        Save(key, image);
+        return true;
+    }
+
+    void TextureCompressor::Compress(const uchar* rgba, uint width, uint height, Format format, bool sRGB, CompressedImage& image)
+    {
+        PROFILE_SCOPE("TextureCompressor::Compress");
+        image.m_Format = format;
+        image.m_Width  = width;
+        image.m_Height = height;
+        image.m_MipLevels.clear();
+
+        uint mipLevels = static_cast<uint>(std::floor(std::log2(std::max(width, height)))) + 1;
+        uint blockSize = GetBlockSize(format);
+
+        uint64 offset = 0;
+        uint levelWidth = width;
+        uint levelHeight = height;
+        for (uint level = 0; level < mipLevels; level++)
+        {
+            uint64 size = static_cast<uint64>((levelWidth + 3) / 4) * ((levelHeight + 3) / 4) * blockSize;
+            image.m_MipLevels.push_back({levelWidth, levelHeight, offset, size});
+            offset += size;
+            levelWidth  = std::max(levelWidth  / 2, 1u);
+            levelHeight = std::max(levelHeight / 2, 1u);
+        }
+        image.m_Data.resize(offset);
+
+        // each level is filtered from the previous one
+        Filter filter = (format == Format::BC5) ? Filter::NormalMap : (sRGB ? Filter::sRGB : Filter::Linear);
+        const uchar* levelData = rgba;
+        std::vector<uchar> downsampled;
+        std::vector<uchar> scratch;
+        for (uint level = 0; level < mipLevels; level++)
+        {
+            auto& mipLevel = image.m_MipLevels[level];
+            EncodeLevel(levelData, mipLevel.m_Width, mipLevel.m_Height, format, image.m_Data.data() + mipLevel.m_Offset);
+
+            if (level + 1 < mipLevels)
+            {
+                auto& nextLevel = image.m_MipLevels[level + 1];
+                scratch.resize(static_cast<size_t>(nextLevel.m_Width) * nextLevel.m_Height * 4);
+                Downsample(levelData, mipLevel.m_Width, mipLevel.m_Height, filter, scratch.data());
+                downsampled.swap(scratch);
+                levelData = downsampled.data();
+            }
+        }
+    }
+
+    // 2x2 box filter, the last row/column is repeated for odd sizes
+    void TextureCompressor::Downsample(const uchar* source, uint width, uint height, Filter filter, uchar* destination)
+    {
+        static const SRGBToLinearTable toLinear;
+        static const LinearToSRGBTable toSRGB;
+
+        uint destinationWidth  = std::max(width  / 2, 1u);
+        uint destinationHeight = std::max(height / 2, 1u);
+        for (uint y = 0; y < destinationHeight; y++)
+        {
+            const uchar* row0 = source + static_cast<size_t>(std::min(2 * y,     height - 1)) * width * 4;
+            const uchar* row1 = source + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * width * 4;
+            for (uint x = 0; x < destinationWidth; x++)
+            {
+                const uchar* texels[4] =
+                {
+                    row0 + std::min(2 * x, width - 1) * 4, row0 + std::min(2 * x + 1, width - 1) * 4,
+                    row1 + std::min(2 * x, width - 1) * 4, row1 + std::min(2 * x + 1, width - 1) * 4
+                };
+
+                switch (filter)
+                {
+                    case Filter::Linear:
+                    {
+                        for (uint channel = 0; channel < 3; channel++)
+                        {
+                            uint sum = texels[0][channel] + texels[1][channel] + texels[2][channel] + texels[3][channel];
+                            destination[channel] = static_cast<uchar>((sum + 2) / 4);
+                        }
+                        break;
+                    }
+                    case Filter::sRGB:
+                    {
+                        for (uint channel = 0; channel < 3; channel++)
+                        {
+                            float sum = toLinear.m_Values[texels[0][channel]] + toLinear.m_Values[texels[1][channel]] +
+                                        toLinear.m_Values[texels[2][channel]] + toLinear.m_Values[texels[3][channel]];
+                            destination[channel] = toSRGB(sum * 0.25f);
+                        }
+                        break;
+                    }
+                    case Filter::NormalMap:
+                    {
+                        glm::vec3 normal{0.0f};
+                        for (auto texel : texels)
+                        {
+                            normal += glm::vec3(texel[0], texel[1], texel[2]) / 127.5f - 1.0f;
+                        }
+                        float length = glm::length(normal);
+                        // opposing normals cancel out, the flat normal is the neutral choice
+                        normal = (length > 1.0e-6f) ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+                        for (uint channel = 0; channel < 3; channel++)
+                        {
+                            destination[channel] = static_cast<uchar>(std::clamp((normal[channel] + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f));
+                        }
+                        break;
+                    }
+                }
+
+                uint alpha = texels[0][3] + texels[1][3] + texels[2][3] + texels[3][3];
+                destination[3] = static_cast<uchar>((alpha + 2) / 4);
+                destination += 4;
+            }
+        }
+    }
+
+    void TextureCompressor::EncodeLevel(const uchar* rgba, uint width, uint height, Format format, uchar* output)
+    {
+        uint blockRows = (height + 3) / 4;
+        if (Engine::m_Engine && (blockRows > ROWS_PER_JOB))
+        {
+            Engine::m_Engine->GetJobSystem().ParallelFor("TextureCompressor::EncodeLevel", blockRows, ROWS_PER_JOB, [&](uint firstRow, uint lastRow)
+            {
+                EncodeRows(rgba, width, height, format, firstRow, lastRow, output);
+            });
+        }
+        else
+        {
+            EncodeRows(rgba, width, height, format, 0, blockRows, output);
+        }
+    }
+
+    void TextureCompressor::EncodeRows(const uchar* rgba, uint width, uint height, Format format, uint firstRow, uint lastRow, uchar* output)
+    {
+        uint blocksPerRow = (width + 3) / 4;
+        uint blockSize = GetBlockSize(format);
+        uchar block[16 * 4];
+        for (uint blockY = firstRow; blockY < lastRow; blockY++)
+        {
+            for (uint blockX = 0; blockX < blocksPerRow; blockX++)
+            {
+                FetchBlock(rgba, width, height, blockX, blockY, block);
+                uchar* destination = output + (static_cast<size_t>(blockY) * blocksPerRow + blockX) * blockSize;
+                switch (format)
+                {
+                    case Format::BC1:
+                        EncodeBlockBC1(block, destination);
+                        break;
+                    case Format::BC3:
+                        EncodeBlockBC4(block, 3, destination);
+                        EncodeBlockBC1(block, destination + 8);
+                        break;
+                    case Format::BC5:
+                        EncodeBlockBC4(block, 0, destination);
+                        EncodeBlockBC4(block, 1, destination + 8);
+                        break;
+                }
+            }
+        }
+    }
+
+    // 4x4 RGBA pixels, edge pixels are repeated for partial blocks
+    void TextureCompressor::FetchBlock(const uchar* rgba, uint width, uint height, uint blockX, uint blockY, uchar* block)
+    {
+        for (uint y = 0; y < 4; y++)
+        {
+            uint sourceY = std::min(blockY * 4 + y, height - 1);
+            for (uint x = 0; x < 4; x++)
+            {
+                uint sourceX = std::min(blockX * 4 + x, width - 1);
+                memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+            }
+        }
+    }
+
+    // end points from the inset bounding box of the block colors, four color mode
+    void TextureCompressor::EncodeBlockBC1(const uchar* block, uchar* output)
+    {
+        int minColor[3] = {255, 255, 255};
+        int maxColor[3] = {0, 0, 0};
+        for (uint pixel = 0; pixel < 16; pixel++)
+        {
+            for (uint channel = 0; channel < 3; channel++)
+            {
+                minColor[channel] = std::min(minColor[channel], static_cast<int>(block[pixel * 4 + channel]));
+                maxColor[channel] = std::max(maxColor[channel], static_cast<int>(block[pixel * 4 + channel]));
+            }
+        }
+        for (uint channel = 0; channel < 3; channel++)
+        {
+            int inset = (maxColor[channel] - minColor[channel]) >> 4;
+            minColor[channel] += inset;
+            maxColor[channel] -= inset;
+        }
+
+        uint16_t color0 = To565(maxColor);
+        uint16_t color1 = To565(minColor);
+        if (color0 < color1)
+        {
+            std::swap(color0, color1);
+        }
+
+        uint indices = 0;
+        if (color0 != color1)
+        {
+            int palette[4][3];
+            From565(color0, palette[0]);
+            From565(color1, palette[1]);
+            for (uint channel = 0; channel < 3; channel++)
+            {
+                palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+                palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+            }
+
+            for (uint pixel = 0; pixel < 16; pixel++)
+            {
+                uint bestIndex = 0;
+                int bestDistance = std::numeric_limits<int>::max();
+                for (uint index = 0; index < 4; index++)
+                {
+                    int distance = 0;
+                    for (uint channel = 0; channel < 3; channel++)
+                    {
+                        int delta = static_cast<int>(block[pixel * 4 + channel]) - palette[index][channel];
+                        distance += delta * delta;
+                    }
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestIndex = index;
+                    }
+                }
+                indices |= bestIndex << (2 * pixel);
+            }
+        }
+
+        output[0] = color0 & 0xff;
+        output[1] = color0 >> 8;
+        output[2] = color1 & 0xff;
+        output[3] = color1 >> 8;
+        for (uint byte = 0; byte < 4; byte++)
+        {
+            output[4 + byte] = (indices >> (8 * byte)) & 0xff;
+        }
+    }
+
+    // single channel block (BC3 alpha, BC5 red/green), eight value mode
+    void TextureCompressor::EncodeBlockBC4(const uchar* block, uint channel, uchar* output)
+    {
+        int minValue = 255;
+        int maxValue = 0;
+        for (uint pixel = 0; pixel < 16; pixel++)
+        {
+            minValue = std::min(minValue, static_cast<int>(block[pixel * 4 + channel]));
+            maxValue = std::max(maxValue, static_cast<int>(block[pixel * 4 + channel]));
+        }
+
+        uint64 indices = 0;
+        if (maxValue > minValue)
+        {
+            int palette[8];
+            palette[0] = maxValue;
+            palette[1] = minValue;
+            for (uint index = 2; index < 8; index++)
+            {
+                palette[index] = ((8 - index) * maxValue + (index - 1) * minValue) / 7;
+            }
+
+            for (uint pixel = 0; pixel < 16; pixel++)
+            {
+                int value = block[pixel * 4 + channel];
+                uint64 bestIndex = 0;
+                int bestDistance = std::abs(value - palette[0]);
+                for (uint index = 1; index < 8; index++)
+                {
+                    int distance = std::abs(value - palette[index]);
+                    if (distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestIndex = index;
+                    }
+                }
+                indices |= bestIndex << (3 * pixel);
+            }
+        }
+
+        output[0] = static_cast<uchar>(maxValue);
+        output[1] = static_cast<uchar>(minValue);
+        for (uint byte = 0; byte < 6; byte++)
+        {
+            output[2 + byte] = (indices >> (8 * byte)) & 0xff;
+        }
+    }
+
+    bool TextureCompressor::Load(uint64 key, CompressedImage& image)
+    {
+        MappedFile file(GetFilepath(key));
+        if (!file.IsValid() || (file.Size() < sizeof(Header)))
+        {
+            return false;
+        }
+
+        Header header;
+        memcpy(&header, file.Data(), sizeof(Header));
+        bool validFormat = (header.m_Format == static_cast<uint>(Format::BC1)) ||
+                           (header.m_Format == static_cast<uint>(Format::BC3)) ||
+                           (header.m_Format == static_cast<uint>(Format::BC5));
+        if ((header.m_Magic != MAGIC) || (header.m_Version != VERSION) || (header.m_Key != key) || !validFormat)
+        {
+            LOG_CORE_WARN("TextureCompressor::Load: ignoring stale cache file {0}", GetFilepath(key));
+            return false;
+        }
+
+        size_t mipLevelBytes = header.m_MipLevelCount * sizeof(MipLevel);
+        if (file.Size() != sizeof(Header) + mipLevelBytes + header.m_DataSize)
+        {
+            LOG_CORE_WARN("TextureCompressor::Load: truncated cache file {0}", GetFilepath(key));
+            return false;
+        }
+
+        const uchar* data = file.Data() + sizeof(Header);
+        image.m_Format = static_cast<Format>(header.m_Format);
+        image.m_Width  = header.m_Width;
+        image.m_Height = header.m_Height;
+        image.m_MipLevels.resize(header.m_MipLevelCount);
+        memcpy(image.m_MipLevels.data(), data, mipLevelBytes);
+        data += mipLevelBytes;
+
+        for (auto& mipLevel : image.m_MipLevels)
+        {
+            if (mipLevel.m_Offset + mipLevel.m_Size > header.m_DataSize)
+            {
+                LOG_CORE_WARN("TextureCompressor::Load: corrupt cache file {0}", GetFilepath(key));
+                return false;
+            }
+        }
+
+        image.m_Data.resize(header.m_DataSize);
+        memcpy(image.m_Data.data(), data, header.m_DataSize);
+        return true;
+    }
+
+    bool TextureCompressor::Save(uint64 key, const CompressedImage& image)
+    {
+        if (!EngineCore::IsDirectory(CACHE_DIRECTORY))
+        {
+            EngineCore::CreateDirectory(CACHE_DIRECTORY);
+        }
+
+        Header header{};
+        header.m_Magic         = MAGIC;
+        header.m_Version       = VERSION;
+        header.m_Format        = static_cast<uint>(image.m_Format);
+        header.m_Width         = image.m_Width;
+        header.m_Height        = image.m_Height;
+        header.m_MipLevelCount = static_cast<uint>(image.m_MipLevels.size());
+        header.m_Key           = key;
+        header.m_DataSize      = image.m_Data.size();
+
+        // write to a temporary file first so that a crash never leaves a partial cache entry behind;
+        // one per thread, identical images may be compressed concurrently
+        std::string filepath = GetFilepath(key);
+        std::string tmpFilepath = EngineCore::GetTemporaryFilepath(filepath);
+        {
+            std::ofstream outputFile(tmpFilepath, std::ios::binary | std::ios::trunc);
+            if (!outputFile.is_open())
+            {
+                LOG_CORE_WARN("TextureCompressor::Save: could not open {0}", tmpFilepath);
+                return false;
+            }
+            outputFile.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+            outputFile.write(reinterpret_cast<const char*>(image.m_MipLevels.data()), image.m_MipLevels.size() * sizeof(MipLevel));
+            outputFile.write(reinterpret_cast<const char*>(image.m_Data.data()), image.m_Data.size());
+            if (!outputFile.good())
+            {
+                LOG_CORE_WARN("TextureCompressor::Save: could not write {0}", tmpFilepath);
+                return false;
+            }
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(tmpFilepath, filepath, errorCode);
+        if (errorCode)
+        {
+            LOG_CORE_WARN("TextureCompressor::Save: could not rename {0} ({1})", tmpFilepath, errorCode.message());
+            std::filesystem::remove(tmpFilepath, errorCode);
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,119 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "engine.h"
+
+namespace GfxRenderEngine
+{
+
+    // CPU block compression of RGBA8 images into BC1/BC3/BC5 including a box-filtered mip chain;
+    // results are kept in an on-disk cache keyed by a hash of the pixels and the target format
+    class TextureCompressor
+    {
+
+    public:
+
+        enum class Format : uint
+        {
+            BC1 = 1, // RGB, 4 bits per pixel: opaque color maps
+            BC3 = 3, // RGBA, 8 bits per pixel: color maps with alpha
+            BC5 = 5  // RG, 8 bits per pixel: tangent space normal maps, z is reconstructed in the shader
+        };
+
+        struct MipLevel
+        {
+            uint   m_Width;
+            uint   m_Height;
+            uint64 m_Offset;
+            uint64 m_Size;
+        };
+
+        struct CompressedImage
+        {
+            Format m_Format;
+            uint m_Width;
+            uint m_Height;
+            std::vector<MipLevel> m_MipLevels;
+            std::vector<uchar> m_Data;
+        };
+
+    public:
+
+        // bytes per 4x4 block
+        static uint GetBlockSize(Format format) { return (format == Format::BC1) ? 8 : 16; }
+        static bool IsOpaque(const uchar* rgba, uint width, uint height);
+
+        // loads the image from the cache or compresses it and stores it in the cache;
+        // sRGB images are filtered in linear space, BC5 normals are renormalized per mip level
+        static bool GetCompressedImage(const uchar* rgba, uint width, uint height, Format format, bool sRGB, CompressedImage& image);
+        static void Compress(const uchar* rgba, uint width, uint height, Format format, bool sRGB, CompressedImage& image);
+
+        static uint64 GetKey(const uchar* rgba, uint width, uint height, Format format, bool sRGB);
+        static bool Load(uint64 key, CompressedImage& image);
+        static bool Save(uint64 key, const CompressedImage& image);
+
+    private:
+
+        struct Header
+        {
+            uint   m_Magic;
+            uint   m_Version;
+            uint   m_Format;
+            uint   m_Width;
+            uint   m_Height;
+            uint   m_MipLevelCount;
+            uint64 m_Key;
+            uint64 m_DataSize;
+        };
+
+        static constexpr uint MAGIC   = 0x58455443; // "CTEX"
+        static constexpr uint VERSION = 2; // 2: gamma-correct and normal-preserving mips
+        static constexpr const char* CACHE_DIRECTORY = "bin/cache/textures/";
+
+        // block rows per job
+        static constexpr uint ROWS_PER_JOB = 16;
+
+        // how mip levels are filtered
+        enum class Filter
+        {
+            Linear,
+            sRGB,     // color channels are averaged in linear space, alpha is linear
+            NormalMap // xyz are averaged as vectors and renormalized, alpha is linear
+        };
+
+    private:
+
+        static std::string GetFilepath(uint64 key);
+        static void Downsample(const uchar* source, uint width, uint height, Filter filter, uchar* destination);
+        static void EncodeLevel(const uchar* rgba, uint width, uint height, Format format, uchar* output);
+        static void EncodeRows(const uchar* rgba, uint width, uint height, Format format, uint firstRow, uint lastRow, uchar* output);
+        static void FetchBlock(const uchar* rgba, uint width, uint height, uint blockX, uint blockY, uchar* block);
+        static void EncodeBlockBC1(const uchar* block, uchar* output);
+        static void EncodeBlockBC4(const uchar* block, uint channel, uchar* output);
+
+    };
+}
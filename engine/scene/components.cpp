@@ -28,6 +28,7 @@
 #include "gtx/quaternion.hpp"
 
 #include "scene/components.h"
+#include "renderer/model.h"
 #include "auxiliary/file.h"
 
 namespace GfxRenderEngine
@@ -45,6 +46,16 @@ namespace GfxRenderEngine
         m_Name = "mesh component " + std::to_string(m_DefaultNameTagCounter++);
     }
 
+    const AABB& MeshComponent::GetAABB() const
+    {
+        return m_Model->GetAABB();
+    }
+
+    const BoundingSphere& MeshComponent::GetBoundingSphere() const
+    {
+        return m_Model->GetBoundingSphere();
+    }
+
     void TransformComponent::SetScale(const glm::vec3& scale)
     {
         m_Scale = scale;
@@ -26,6 +26,7 @@
 #include <memory>
 
 #include "engine.h"
+#include "renderer/boundingVolume.h"
 
 #include "engine/platform/Vulkan/VKswapChain.h"
 
@@ -90,6 +91,10 @@ namespace GfxRenderEngine
         MeshComponent(std::string name, std::shared_ptr<Model> model, bool enabled = true);
         MeshComponent(std::shared_ptr<Model> model, bool enabled = true);
 
+        // model-space bounding volumes of the model
+        const AABB& GetAABB() const;
+        const BoundingSphere& GetBoundingSphere() const;
+
         std::string m_Name;
         std::shared_ptr<Model> m_Model;
         bool m_Enabled;
@@ -143,9 +148,12 @@ namespace GfxRenderEngine
         glm::vec3 m_Color;
     };
 
+    // m_DescriptorSet: per-material textures, VK_NULL_HANDLE with bindless textures;
+    // the texture slots index the global texture table
     struct PbrDiffuseComponent
     {
         VkDescriptorSet m_DescriptorSet[VK_SwapChain::MAX_FRAMES_IN_FLIGHT];
+        uint m_DiffuseMapSlot;
         float m_Roughness;
         float m_Metallic;
     };
@@ -153,6 +161,8 @@ namespace GfxRenderEngine
     struct PbrDiffuseNormalComponent
     {
         VkDescriptorSet m_DescriptorSet[VK_SwapChain::MAX_FRAMES_IN_FLIGHT];
+        uint m_DiffuseMapSlot;
+        uint m_NormalMapSlot;
         float m_Roughness;
         float m_Metallic;
         float m_NormalMapIntensity;
@@ -161,11 +171,16 @@ namespace GfxRenderEngine
     struct PbrDiffuseNormalRoughnessMetallicComponent
     {
         VkDescriptorSet m_DescriptorSet[VK_SwapChain::MAX_FRAMES_IN_FLIGHT];
+        uint m_DiffuseMapSlot;
+        uint m_NormalMapSlot;
+        uint m_RoughnessMetallicMapSlot;
         float m_NormalMapIntensity;
     };
 
     struct PbrDiffuseRoughnessMetallicComponent
     {
         VkDescriptorSet m_DescriptorSet[VK_SwapChain::MAX_FRAMES_IN_FLIGHT];
+        uint m_DiffuseMapSlot;
+        uint m_RoughnessMetallicMapSlot;
     };
 }
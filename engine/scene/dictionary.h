@@ -55,6 +55,8 @@ namespace GfxRenderEngine
         std::unordered_map<entt::entity, std::string> m_GameObject2ShortStr;
         std::unordered_map<entt::entity, std::string> m_GameObject2LongStr;
 
+        friend class SceneSnapshot;
+
     };
 
 }
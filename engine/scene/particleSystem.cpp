@@ -20,6 +20,14 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define PARTICLE_SYSTEM_SSE
+    #include <xmmintrin.h>
+#endif
+
+#include <cmath>
+#include <algorithm>
+
 #include "core.h"
 #include "auxiliary/random.h"
 #include "scene/particleSystem.h"
@@ -28,10 +36,20 @@
 namespace GfxRenderEngine
 {
     ParticleSystem::ParticleSystem(uint poolSize, float zaxis, SpriteSheet* spritesheet, float amplification, int unlit)
-        : m_ParticlePool{poolSize}, m_PoolIndex{0},
+        : m_PoolSize{poolSize}, m_PoolIndex{0},
           m_Spritesheet{spritesheet}, m_Zaxis{zaxis}
     {
         ASSERT(poolSize);
+        uint paddedSize = (poolSize + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+        for (auto array : {&m_PositionX, &m_PositionY, &m_PositionZ, &m_VelocityX, &m_VelocityY,
+                           &m_AccelerationX, &m_AccelerationY, &m_Rotation, &m_RotationSpeed,
+                           &m_Size, &m_StartSize, &m_FinalSize, &m_RemainingLifeTime})
+        {
+            array->assign(paddedSize, 0.0f);
+        }
+        // avoid a division by zero for unused slots
+        m_LifeTime.assign(paddedSize, 1.0f);
+
         auto numberOfSprites = m_Spritesheet->GetNumberOfSprites();
         m_AnimationSprites.resize(numberOfSprites);
         for (uint i = 0; i < numberOfSprites; i++)
@@ -41,99 +59,116 @@ namespace GfxRenderEngine
             auto sprite = m_Spritesheet->GetSprite(i);
             glm::mat4 position = sprite->GetScaleMatrix();
             builder.LoadSprite(sprite, position, amplification, unlit);
-            auto model = Engine::m_Engine->LoadModel(builder);
-            MeshComponent mesh{"particle animation", model};
-            mesh.m_Enabled = false;
-
-            m_AnimationSprites[i] = m_Registry.create();
-            m_Registry.emplace<MeshComponent>(m_AnimationSprites[i], mesh);
+            m_AnimationSprites[i] = Engine::m_Engine->LoadModel(builder);
         }
     }
 
     void ParticleSystem::Emit(const ParticleSystem::Specification& spec, const ParticleSystem::Specification& variation)
     {
-        Particle& particle = m_ParticlePool[m_PoolIndex];
-
-        particle.m_Velocity          = spec.m_Velocity + variation.m_Velocity.x * EngineCore::RandomPlusMinusOne();
-        particle.m_Acceleration      = spec.m_Acceleration;
+        uint index = m_PoolIndex;
+        m_PoolIndex = (m_PoolIndex + 1) % m_PoolSize;
 
-        particle.m_RotationSpeed     = spec.m_RotationSpeed;
+        float velocityVariation = variation.m_Velocity.x * EngineCore::RandomPlusMinusOne();
+        m_VelocityX[index]         = spec.m_Velocity.x + velocityVariation;
+        m_VelocityY[index]         = spec.m_Velocity.y + velocityVariation;
+        m_AccelerationX[index]     = spec.m_Acceleration.x;
+        m_AccelerationY[index]     = spec.m_Acceleration.y;
 
-        particle.m_StartColor        = spec.m_StartColor;
+        m_RotationSpeed[index]     = spec.m_RotationSpeed;
 
-        particle.m_StartSize         = spec.m_StartSize;
-        particle.m_FinalSize         = spec.m_FinalSize;
+        m_Size[index]              = spec.m_StartSize;
+        m_StartSize[index]         = spec.m_StartSize;
+        m_FinalSize[index]         = spec.m_FinalSize;
 
-        particle.m_LifeTime          = spec.m_LifeTime;
-        particle.m_RemainingLifeTime = particle.m_LifeTime;
+        m_LifeTime[index]          = spec.m_LifeTime;
+        m_RemainingLifeTime[index] = spec.m_LifeTime;
 
-        particle.m_Enabled = true;
-
-        m_PoolIndex = (m_PoolIndex + 1) % m_ParticlePool.size();
-
-        Builder builder{};
-        particle.m_Entity = m_Registry.create();
-
-        builder.LoadParticle(spec.m_StartColor);
-        auto model = Engine::m_Engine->LoadModel(builder);
-        MeshComponent mesh{"particle", model};
-        m_Registry.emplace<MeshComponent>(particle.m_Entity, mesh);
-
-        TransformComponent transform{};
         static uint cnt = 0;
         cnt = (cnt + 1) % 100;
-        transform.SetTranslation(glm::vec3{spec.m_Position.x, spec.m_Position.y, m_Zaxis + 0.01f * cnt});
-        transform.SetScale(glm::vec3{1.0f} * particle.m_StartSize);
-        transform.SetRotation(glm::vec3{0.0f, 0.0f, spec.m_Rotation + variation.m_Rotation * EngineCore::RandomPlusMinusOne()});
-        m_Registry.emplace<TransformComponent>(particle.m_Entity, transform);
-
-        particle.m_SmokeAnimation.Create(100ms /* per frame */, m_Spritesheet);
-        particle.m_SmokeAnimation.Start();
+        m_PositionX[index] = spec.m_Position.x;
+        m_PositionY[index] = spec.m_Position.y;
+        m_PositionZ[index] = m_Zaxis + 0.01f * cnt;
+        m_Rotation[index]  = spec.m_Rotation + variation.m_Rotation * EngineCore::RandomPlusMinusOne();
     }
 
     void ParticleSystem::OnUpdate(Timestep timestep)
     {
-        for (auto& particle : m_ParticlePool)
-        {
-            if (!particle.m_Enabled)
+        float step = timestep;
+        uint paddedSize = static_cast<uint>(m_RemainingLifeTime.size());
+
+        // all slots are updated; dead particles are skipped when rendering
+        #ifdef PARTICLE_SYSTEM_SSE
+            const __m128 timestep4 = _mm_set1_ps(step);
+            const __m128 zero4 = _mm_setzero_ps();
+            for (uint i = 0; i < paddedSize; i += SIMD_WIDTH)
             {
-                continue;
+                __m128 velocityX = _mm_add_ps(_mm_loadu_ps(&m_VelocityX[i]), _mm_mul_ps(_mm_loadu_ps(&m_AccelerationX[i]), timestep4));
+                __m128 velocityY = _mm_add_ps(_mm_loadu_ps(&m_VelocityY[i]), _mm_mul_ps(_mm_loadu_ps(&m_AccelerationY[i]), timestep4));
+                _mm_storeu_ps(&m_VelocityX[i], velocityX);
+                _mm_storeu_ps(&m_VelocityY[i], velocityY);
+                _mm_storeu_ps(&m_PositionX[i], _mm_add_ps(_mm_loadu_ps(&m_PositionX[i]), _mm_mul_ps(velocityX, timestep4)));
+                _mm_storeu_ps(&m_PositionY[i], _mm_add_ps(_mm_loadu_ps(&m_PositionY[i]), _mm_mul_ps(velocityY, timestep4)));
+                _mm_storeu_ps(&m_Rotation[i],  _mm_add_ps(_mm_loadu_ps(&m_Rotation[i]),  _mm_mul_ps(_mm_loadu_ps(&m_RotationSpeed[i]), timestep4)));
+
+                __m128 remainingLifeTime = _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&m_RemainingLifeTime[i]), timestep4), zero4);
+                _mm_storeu_ps(&m_RemainingLifeTime[i], remainingLifeTime);
+
+                // lerp(finalSize, startSize, normalizedRemainingLifeTime)
+                __m128 normalizedRemainingLifeTime = _mm_div_ps(remainingLifeTime, _mm_loadu_ps(&m_LifeTime[i]));
+                __m128 finalSize = _mm_loadu_ps(&m_FinalSize[i]);
+                __m128 startSize = _mm_loadu_ps(&m_StartSize[i]);
+                _mm_storeu_ps(&m_Size[i], _mm_add_ps(finalSize, _mm_mul_ps(_mm_sub_ps(startSize, finalSize), normalizedRemainingLifeTime)));
             }
-
-            if (particle.m_RemainingLifeTime <= 0.0ms)
+        #else
+            for (uint i = 0; i < paddedSize; i++)
             {
-                particle.m_Enabled = false;
-                continue;
-            }
+                m_VelocityX[i] += m_AccelerationX[i] * step;
+                m_VelocityY[i] += m_AccelerationY[i] * step;
+                m_PositionX[i] += m_VelocityX[i] * step;
+                m_PositionY[i] += m_VelocityY[i] * step;
+                m_Rotation[i]  += m_RotationSpeed[i] * step;
 
-            auto& transform = m_Registry.get<TransformComponent>(particle.m_Entity);
-            particle.m_Velocity += particle.m_Acceleration * static_cast<float>(timestep);
-            transform.SetTranslationX(transform.GetTranslation().x + particle.m_Velocity.x * static_cast<float>(timestep));
-            transform.SetTranslationY(transform.GetTranslation().y + particle.m_Velocity.y * static_cast<float>(timestep));
+                m_RemainingLifeTime[i] = std::max(m_RemainingLifeTime[i] - step, 0.0f);
 
-            transform.SetRotationZ(transform.GetRotation().z + particle.m_RotationSpeed * static_cast<float>(timestep));
-            particle.m_RemainingLifeTime -= timestep;
+                float normalizedRemainingLifeTime = m_RemainingLifeTime[i] / m_LifeTime[i];
+                m_Size[i] = m_FinalSize[i] + (m_StartSize[i] - m_FinalSize[i]) * normalizedRemainingLifeTime;
+            }
+        #endif
+    }
 
-            auto remainingLifeTime = static_cast<float>(particle.m_RemainingLifeTime);
-            auto lifeTime = static_cast<float>(particle.m_LifeTime);
-            auto normalizedRemainingLifeTime = remainingLifeTime / lifeTime;
+    glm::mat4 ParticleSystem::GetMat4(uint index) const
+    {
+        // translation * rotation around z * scale (x, y)
+        float size = m_Size[index];
+        float sinRotation = std::sin(m_Rotation[index]);
+        float cosRotation = std::cos(m_Rotation[index]);
+        return glm::mat4
+        {
+            { cosRotation * size, sinRotation * size, 0.0f, 0.0f},
+            {-sinRotation * size, cosRotation * size, 0.0f, 0.0f},
+            { 0.0f,               0.0f,               1.0f, 0.0f},
+            { m_PositionX[index], m_PositionY[index], m_PositionZ[index], 1.0f}
+        };
+    }
 
-            float size = glm::lerp(particle.m_FinalSize, particle.m_StartSize, normalizedRemainingLifeTime);
-            transform.SetScaleX(size);
-            transform.SetScaleY(size);
+    glm::mat4 ParticleSystem::GetNormalMatrix(uint index) const
+    {
+        // uniform scale in x and y: the rotation is sufficient
+        float sinRotation = std::sin(m_Rotation[index]);
+        float cosRotation = std::cos(m_Rotation[index]);
+        return glm::mat4
+        {
+            { cosRotation, sinRotation, 0.0f, 0.0f},
+            {-sinRotation, cosRotation, 0.0f, 0.0f},
+            { 0.0f,        0.0f,        1.0f, 0.0f},
+            { 0.0f,        0.0f,        0.0f, 1.0f}
+        };
+    }
 
-            {
-                if (!particle.m_SmokeAnimation.IsRunning())
-                {
-                    particle.m_SmokeAnimation.Start();
-                }
-
-                if (particle.m_SmokeAnimation.IsNewFrame())
-                {
-                    uint currentFrame = particle.m_SmokeAnimation.GetCurrentFrame();
-                    particle.m_SpriteEntity = m_AnimationSprites[currentFrame];
-                }
-            }
-        }
+    Model* ParticleSystem::GetModel(uint index) const
+    {
+        float age = m_LifeTime[index] - m_RemainingLifeTime[index];
+        uint frame = static_cast<uint>(age / SECONDS_PER_ANIMATION_FRAME) % m_AnimationSprites.size();
+        return m_AnimationSprites[frame].get();
     }
 }
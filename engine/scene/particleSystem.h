@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <vector>
+#include <memory>
+
 #include "engine.h"
 #include "scene/scene.h"
 #include "auxiliary/timestep.h"
@@ -29,6 +32,7 @@
 
 namespace GfxRenderEngine
 {
+    class Model;
     class ParticleSystem
     {
 
@@ -61,39 +65,43 @@ namespace GfxRenderEngine
         void Emit(const ParticleSystem::Specification& spec, const ParticleSystem::Specification& variation);
         void OnUpdate(Timestep timestep);
 
-    public:
-
-        struct Particle
-        {
-            glm::vec2 m_Velocity;
-            glm::vec2 m_Acceleration;
-
-            float m_RotationSpeed;
-
-            glm::vec4 m_StartColor;
+        // render data
+        uint GetPoolSize() const { return m_PoolSize; }
+        bool IsAlive(uint index) const { return m_RemainingLifeTime[index] > 0.0f; }
+        glm::mat4 GetMat4(uint index) const;
+        glm::mat4 GetNormalMatrix(uint index) const;
+        Model* GetModel(uint index) const;
 
-            float m_StartSize;
-            float m_FinalSize;
-
-            Timestep m_LifeTime{0ms};
-            Timestep m_RemainingLifeTime{0ms};
-
-            SpriteAnimation m_SmokeAnimation;
-
-            bool m_Enabled;
-            entt::entity m_Entity;
-            entt::entity m_SpriteEntity;
-        };
+    private:
 
-        std::vector<Particle> m_ParticlePool;
-        entt::registry m_Registry;
+        // particles are processed in groups of four
+        static constexpr uint SIMD_WIDTH = 4;
+        static constexpr float SECONDS_PER_ANIMATION_FRAME = 0.1f;
 
     private:
 
+        uint m_PoolSize;
         uint m_PoolIndex;
         float m_Zaxis;
 
-        std::vector<entt::entity> m_AnimationSprites;
+        // structure of arrays, padded to a multiple of SIMD_WIDTH
+        std::vector<float> m_PositionX;
+        std::vector<float> m_PositionY;
+        std::vector<float> m_PositionZ;
+        std::vector<float> m_VelocityX;
+        std::vector<float> m_VelocityY;
+        std::vector<float> m_AccelerationX;
+        std::vector<float> m_AccelerationY;
+        std::vector<float> m_Rotation;
+        std::vector<float> m_RotationSpeed;
+        std::vector<float> m_Size;
+        std::vector<float> m_StartSize;
+        std::vector<float> m_FinalSize;
+        std::vector<float> m_LifeTime;
+        std::vector<float> m_RemainingLifeTime;
+
+        // one shared quad per animation frame
+        std::vector<std::shared_ptr<Model>> m_AnimationSprites;
         SpriteSheet* m_Spritesheet;
 
     };
@@ -0,0 +1,206 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "core.h"
+#include "auxiliary/file.h"
+#include "auxiliary/assetSystem.h"
+#include "renderer/model.h"
+#include "scene/scene.h"
+#include "scene/prefab.h"
+#include "yaml-cpp/yaml.h"
+
+namespace GfxRenderEngine
+{
+    Prefab::Prefab(const std::string& filepath)
+        : m_Filepath(filepath)
+    {
+        auto entity = m_Registry.create();
+        TransformComponent transform{};
+        m_Registry.emplace<TransformComponent>(entity, transform);
+        m_Root.SetGameObject(entity);
+    }
+
+    Prefab::~Prefab()
+    {
+    }
+
+    bool Prefab::Load(Scene& scene)
+    {
+        return Parse() && Build(scene);
+    }
+
+    bool Prefab::Parse()
+    {
+        YAML::Node yamlNode;
+
+        AssetData yamlData;
+        if (AssetSystem::Load(m_Filepath, yamlData))
+        {
+            LOG_CORE_WARN("Loading prefab {0}", m_Filepath);
+            AssetStream yamlStream(yamlData);
+            yamlNode = YAML::Load(yamlStream);
+        }
+        else
+        {
+            LOG_CORE_CRITICAL("Prefab::Load could not find file {0}", m_Filepath);
+            return false;
+        }
+
+        if (yamlNode["glTF-files"])
+        {
+            const auto& gltfFileList = yamlNode["glTF-files"];
+            for (const auto& gltfFile : gltfFileList)
+            {
+                if (AssetSystem::Exists(gltfFile.as<std::string>()))
+                {
+                    LOG_CORE_WARN("Prefab::Load found {0}", gltfFile.as<std::string>());
+                    auto builder = std::make_unique<Builder>(gltfFile.as<std::string>());
+                    if (builder->ParseGLTF())
+                    {
+                        m_Builders.push_back(std::move(builder));
+                    }
+                }
+                else
+                {
+                    LOG_CORE_CRITICAL("Prefab::Load could not find file {0}", gltfFile.as<std::string>());
+                }
+            }
+        }
+
+        if (yamlNode["prefabs"])
+        {
+            const auto& prefabsFileList = yamlNode["prefabs"];
+            for (const auto& prefabFile : prefabsFileList)
+            {
+                m_NestedPrefabs.push_back(prefabFile.as<std::string>());
+            }
+        }
+
+        if (yamlNode["script-components"])
+        {
+            const auto& scriptFileList = yamlNode["script-components"];
+            for(YAML::const_iterator it=scriptFileList.begin();it!=scriptFileList.end();++it)
+            {
+                std::string entityName = it->first.as<std::string>();
+                std::string filepath = it->second.as<std::string>();
+                LOG_CORE_INFO("found script '{0} for entity '{1}' in prefab", filepath, entityName);
+                m_Scripts.push_back({entityName, filepath});
+            }
+        }
+
+        m_Parsed = true;
+        return true;
+    }
+
+    bool Prefab::Build(Scene& scene)
+    {
+        if (!m_Parsed)
+        {
+            return false;
+        }
+        // consumed: a prefab that references itself is not built again
+        m_Parsed = false;
+
+        for (auto& builder : m_Builders)
+        {
+            builder->BuildGLTF(m_Registry, m_Root, m_Dictionary);
+        }
+        m_Builders.clear();
+
+        for (auto& prefabFile : m_NestedPrefabs)
+        {
+            auto prefab = scene.GetPrefab(prefabFile);
+            if (prefab)
+            {
+                TransformComponent transform{};
+                prefab->Instantiate(m_Registry, m_Root, m_Dictionary, transform);
+            }
+        }
+        m_NestedPrefabs.clear();
+
+        for (auto& [entityName, filepath] : m_Scripts)
+        {
+            entt::entity gameObject = m_Dictionary.Retrieve(entityName);
+            if (gameObject != entt::null)
+            {
+                ScriptComponent scriptComponent(filepath);
+                m_Registry.emplace<ScriptComponent>(gameObject, scriptComponent);
+            }
+        }
+        m_Scripts.clear();
+
+        m_Loaded = true;
+        return true;
+    }
+
+    entt::entity Prefab::Instantiate(entt::registry& registry, TreeNode& parent, Dictionary& dictionary,
+                                     const TransformComponent& transform)
+    {
+        ASSERT(m_Loaded);
+        std::string suffix = m_InstanceCount ? "#" + std::to_string(m_InstanceCount) : "";
+        m_InstanceCount++;
+
+        // the instance root carries the fresh transform, the prefab's own nodes keep theirs
+        auto entity = registry.create();
+        registry.emplace<TransformComponent>(entity, transform);
+        registry.get<TransformComponent>(entity).SetDirtyFlag();
+
+        auto shortName = EngineCore::GetFilenameWithoutPath(m_Filepath) + suffix;
+        auto longName = m_Filepath + suffix;
+        TreeNode sceneHierarchyNode{entity, shortName, longName};
+        TreeNode* instanceNode = parent.AddChild(sceneHierarchyNode, dictionary);
+
+        CloneChildren(m_Root, registry, *instanceNode, dictionary, suffix);
+        return entity;
+    }
+
+    void Prefab::CloneChildren(TreeNode& templateNode, entt::registry& registry, TreeNode& parent,
+                               Dictionary& dictionary, const std::string& suffix)
+    {
+        for (uint index = 0; index < templateNode.Children(); index++)
+        {
+            auto& templateChild = templateNode.GetChild(index);
+
+            auto entity = registry.create();
+            CloneComponents(templateChild.GetGameObject(), registry, entity);
+
+            TreeNode sceneHierarchyNode{entity, templateChild.GetName(), templateChild.GetLongName() + suffix};
+            TreeNode* newNode = parent.AddChild(sceneHierarchyNode, dictionary);
+            CloneChildren(templateChild, registry, *newNode, dictionary, suffix);
+        }
+    }
+
+    void Prefab::CloneComponents(entt::entity source, entt::registry& registry, entt::entity destination)
+    {
+        // meshes and materials are shared handles, copying them does not load or upload anything
+        CloneComponent<TransformComponent>(source, registry, destination);
+        CloneComponent<MeshComponent>(source, registry, destination);
+        CloneComponent<PointLightComponent>(source, registry, destination);
+        CloneComponent<ScriptComponent>(source, registry, destination);
+        CloneComponent<DefaultDiffuseComponent>(source, registry, destination);
+        CloneComponent<PbrNoMapComponent>(source, registry, destination);
+        CloneComponent<PbrDiffuseComponent>(source, registry, destination);
+        CloneComponent<PbrDiffuseNormalComponent>(source, registry, destination);
+        CloneComponent<PbrDiffuseNormalRoughnessMetallicComponent>(source, registry, destination);
+        CloneComponent<PbrDiffuseRoughnessMetallicComponent>(source, registry, destination);
+    }
+}
@@ -0,0 +1,105 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+
+#include "engine.h"
+#include "entt.hpp"
+#include "scene/treeNode.h"
+#include "scene/dictionary.h"
+#include "scene/components.h"
+
+namespace GfxRenderEngine
+{
+    class Scene;
+    class Builder;
+
+    // a prefab file loaded once into a private registry and hierarchy:
+    // components, mesh handles and material handles; instances are cloned
+    // from this template without touching the file system or the GPU
+    class Prefab
+    {
+
+    public:
+
+        Prefab(const std::string& filepath);
+        ~Prefab();
+
+        Prefab(const Prefab&) = delete;
+        Prefab& operator=(const Prefab&) = delete;
+
+        // nested prefabs are resolved through the scene's prefab templates
+        bool Load(Scene& scene);
+
+        // Parse reads the file and prepares the glTF data and may run on a worker thread,
+        // Build creates the template on the main thread; Load() is Parse() followed by Build()
+        bool Parse();
+        bool Build(Scene& scene);
+        bool IsLoaded() const { return m_Loaded; }
+        bool IsParsed() const { return m_Parsed; }
+
+        // returns the root game object of the new instance; the first instance
+        // keeps the long names of the prefab file, later ones get a "#<n>" suffix
+        entt::entity Instantiate(entt::registry& registry, TreeNode& parent, Dictionary& dictionary,
+                                 const TransformComponent& transform);
+
+        const std::string& GetFilepath() const { return m_Filepath; }
+        uint GetInstanceCount() const { return m_InstanceCount; }
+
+    private:
+
+        void CloneChildren(TreeNode& templateNode, entt::registry& registry, TreeNode& parent,
+                           Dictionary& dictionary, const std::string& suffix);
+        void CloneComponents(entt::entity source, entt::registry& registry, entt::entity destination);
+
+        template<typename T>
+        void CloneComponent(entt::entity source, entt::registry& registry, entt::entity destination)
+        {
+            if (auto component = m_Registry.try_get<T>(source))
+            {
+                registry.emplace<T>(destination, *component);
+            }
+        }
+
+    private:
+
+        std::string m_Filepath;
+        bool m_Parsed{false};
+        bool m_Loaded{false};
+        uint m_InstanceCount{0};
+
+        entt::registry m_Registry;
+        TreeNode m_Root{(entt::entity)-1, "root", "prefabRoot"};
+        Dictionary m_Dictionary;
+
+        // parse results, consumed by Build()
+        std::vector<std::unique_ptr<Builder>> m_Builders;
+        std::vector<std::string> m_NestedPrefabs;
+        std::vector<std::pair<std::string, std::string>> m_Scripts;
+
+    };
+}
@@ -75,4 +75,39 @@ namespace GfxRenderEngine
         m_Registry.emplace<PointLightComponent>(pointLight, pointLightComponent);
         return pointLight;
     }
+
+    Prefab* Scene::GetPrefab(const std::string& filepath)
+    {
+        auto iterator = m_Prefabs.find(filepath);
+        if (iterator == m_Prefabs.end())
+        {
+            auto& prefab = m_Prefabs[filepath] = std::make_unique<Prefab>(filepath);
+            prefab->Load(*this);
+            iterator = m_Prefabs.find(filepath);
+        }
+        else if (iterator->second->IsParsed())
+        {
+            // parsed ahead of time by the scene loader
+            iterator->second->Build(*this);
+        }
+
+        // not loaded: the file is missing or the prefab references itself
+        if (!iterator->second->IsLoaded())
+        {
+            LOG_CORE_CRITICAL("Scene::GetPrefab: prefab {0} is not available", filepath);
+            return nullptr;
+        }
+        return iterator->second.get();
+    }
+
+    entt::entity Scene::InstantiatePrefab(const std::string& filepath, const TransformComponent& transform,
+                                          TreeNode* parent)
+    {
+        auto prefab = GetPrefab(filepath);
+        if (!prefab)
+        {
+            return entt::null;
+        }
+        return prefab->Instantiate(m_Registry, parent ? *parent : m_SceneHierarchy, m_Dictionary, transform);
+    }
 }
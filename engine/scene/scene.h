@@ -24,6 +24,7 @@
 
 #include <iostream>
 #include <unordered_map>
+#include <memory>
 #include <vulkan/vulkan.h>
 
 #include "engine.h"
@@ -32,6 +33,7 @@
 #include "scene/entity.h"
 #include "scene/treeNode.h"
 #include "scene/dictionary.h"
+#include "scene/prefab.h"
 #include "auxiliary/timestep.h"
 #include "renderer/camera.h"
 
@@ -66,6 +68,11 @@ namespace GfxRenderEngine
         entt::entity CreatePointLight(const float intensity = 1.0f, const float radius = 0.1f,
                                       const glm::vec3& color = glm::vec3{1.0f, 1.0f, 1.0f});
 
+        // prefab files are loaded once per scene, every further instance is cloned from the template
+        Prefab* GetPrefab(const std::string& filepath);
+        entt::entity InstantiatePrefab(const std::string& filepath, const TransformComponent& transform = {},
+                                       TreeNode* parent = nullptr);
+
         bool IsFinished() const { return !m_IsRunning; }
         entt::registry& GetRegistry() { return m_Registry; };
         Dictionary& GetDictionary() { return m_Dictionary; };
@@ -77,9 +84,11 @@ namespace GfxRenderEngine
         entt::registry m_Registry;
         TreeNode m_SceneHierarchy{(entt::entity)-1, "root", "sceneRoot"};
         Dictionary m_Dictionary;
+        std::unordered_map<std::string, std::unique_ptr<Prefab>> m_Prefabs;
         bool m_IsRunning;
 
         friend class SceneLoader;
+        friend class SceneSnapshot;
         
     };
 }
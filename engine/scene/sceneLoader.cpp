@@ -20,9 +20,15 @@
    TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
    SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
 
+#include <memory>
+#include <vector>
+
+#include "core.h"
 #include "auxiliary/file.h"
+#include "auxiliary/assetSystem.h"
 #include "scene/components.h"
 #include "scene/sceneLoader.h"
+#include "scene/sceneSnapshot.h"
 
 namespace GfxRenderEngine
 {
@@ -36,10 +42,12 @@ namespace GfxRenderEngine
         YAML::Node yamlNode;
         auto& filepath = m_Scene.m_Filepath;
 
-        if (EngineCore::FileExists(filepath))
+        AssetData yamlData;
+        if (AssetSystem::Load(filepath, yamlData))
         {
             LOG_CORE_WARN("Loading scene {0}", filepath);
-            yamlNode = YAML::LoadFile(filepath);
+            AssetStream yamlStream(yamlData);
+            yamlNode = YAML::Load(yamlStream);
         }
         else
         {
@@ -47,17 +55,18 @@ namespace GfxRenderEngine
             return;
         }
 
-
+        // the glTF files and new prefabs are independent: parse and decode them on the job system,
+        // then merge them into the scene in file order on this thread
+        std::vector<std::unique_ptr<Builder>> builders;
         if (yamlNode["glTF-files"])
         {
             const auto& gltfFileList = yamlNode["glTF-files"];
             for (const auto& gltfFile : gltfFileList)
             {
-                if (EngineCore::FileExists(gltfFile.as<std::string>()))
+                if (AssetSystem::Exists(gltfFile.as<std::string>()))
                 {
                     LOG_CORE_WARN("Scene loader found {0}", gltfFile.as<std::string>());
-                    Builder builder{gltfFile.as<std::string>()};
-                    builder.LoadGLTF(m_Scene.m_Registry, m_Scene.m_SceneHierarchy, m_Scene.m_Dictionary);
+                    builders.push_back(std::make_unique<Builder>(gltfFile.as<std::string>()));
                 }
                 else
                 {
@@ -66,13 +75,52 @@ namespace GfxRenderEngine
             }
         }
 
+        std::vector<std::string> prefabFiles;
+        std::vector<Prefab*> newPrefabs;
         if (yamlNode["prefabs"])
         {
             const auto& prefabsFileList = yamlNode["prefabs"];
-            for (const auto& prefab : prefabsFileList)
+            for (const auto& prefabFile : prefabsFileList)
+            {
+                auto prefabFilepath = prefabFile.as<std::string>();
+                prefabFiles.push_back(prefabFilepath);
+                if (m_Scene.m_Prefabs.find(prefabFilepath) == m_Scene.m_Prefabs.end())
+                {
+                    auto& prefab = m_Scene.m_Prefabs[prefabFilepath] = std::make_unique<Prefab>(prefabFilepath);
+                    newPrefabs.push_back(prefab.get());
+                }
+            }
+        }
+
+        uint builderCount = static_cast<uint>(builders.size());
+        uint fileCount = builderCount + static_cast<uint>(newPrefabs.size());
+        Engine::m_Engine->GetJobSystem().ParallelFor("SceneLoader::Parse", fileCount, 1, [&](uint begin, uint end)
+        {
+            for (uint index = begin; index < end; index++)
             {
-                LoadPrefab(prefab.as<std::string>());
+                if (index < builderCount)
+                {
+                    builders[index]->ParseGLTF();
+                }
+                else
+                {
+                    newPrefabs[index - builderCount]->Parse();
+                }
             }
+        });
+
+        // record all buffer and texture uploads of this scene into one submission
+        Engine::m_Engine->BeginUploadBatch();
+
+        for (auto& builder : builders)
+        {
+            builder->BuildGLTF(m_Scene.m_Registry, m_Scene.m_SceneHierarchy, m_Scene.m_Dictionary);
+        }
+        builders.clear();
+
+        for (auto& prefabFile : prefabFiles)
+        {
+            LoadPrefab(prefabFile);
         }
 
         if (yamlNode["script-components"])
@@ -89,67 +137,48 @@ namespace GfxRenderEngine
                 m_Scene.m_Registry.emplace<ScriptComponent>(gameObject, scriptComponent);
             }
         }
+
+        Engine::m_Engine->EndUploadBatch();
     }
 
     void SceneLoader::LoadPrefab(const std::string& filepath)
     {
-        YAML::Node yamlNode;
-
-        if (EngineCore::FileExists(filepath))
-        {
-            LOG_CORE_WARN("Scene loader found {0}", filepath);
-            yamlNode = YAML::LoadFile(filepath);
-        }
-        else
+        // the prefab file and its glTF files are read only for the first instance
+        if (m_Scene.InstantiatePrefab(filepath) == entt::null)
         {
-            LOG_CORE_CRITICAL("Scene loader could not find file {0}", filepath);
-            return;
+            LOG_CORE_CRITICAL("Scene loader could not instantiate prefab {0}", filepath);
         }
+    }
 
-        if (yamlNode["glTF-files"])
+    void SceneLoader::Serialize()
+    {
+        SceneSnapshot snapshot;
+        snapshot.Capture(m_Scene);
+
+        auto filepath = GetSnapshotFilepath();
+        if (snapshot.Save(filepath))
         {
-            const auto& gltfFileList = yamlNode["glTF-files"];
-            for (const auto& gltfFile : gltfFileList)
-            {
-                if (EngineCore::FileExists(gltfFile.as<std::string>()))
-                {
-                    LOG_CORE_WARN("Scene loader found {0}", gltfFile.as<std::string>());
-                    Builder builder{gltfFile.as<std::string>()};
-                    builder.LoadGLTF(m_Scene.m_Registry, m_Scene.m_SceneHierarchy, m_Scene.m_Dictionary);
-                }
-                else
-                {
-                    LOG_CORE_CRITICAL("Scene loader could not find file {0}", gltfFile.as<std::string>());
-                }
-            }
+            LOG_CORE_INFO("Scene loader saved {0} ({1} bytes)", filepath, snapshot.Size());
         }
-
-        if (yamlNode["prefabs"])
+        else
         {
-            const auto& prefabsFileList = yamlNode["prefabs"];
-            for (const auto& prefab : prefabsFileList)
-            {
-                LoadPrefab(prefab.as<std::string>());
-            }
+            LOG_CORE_CRITICAL("Scene loader could not save {0}", filepath);
         }
+    }
 
-        if (yamlNode["script-components"])
+    bool SceneLoader::DeserializeSnapshot()
+    {
+        auto filepath = GetSnapshotFilepath();
+        if (!EngineCore::FileExists(filepath))
         {
-            const auto& scriptFileList = yamlNode["script-components"];
-            for(YAML::const_iterator it=scriptFileList.begin();it!=scriptFileList.end();++it)
-            {
-                std::string entityName = it->first.as<std::string>();
-                std::string filepath = it->second.as<std::string>();
-                LOG_CORE_INFO("found script '{0} for entity '{1}' in prefab", filepath, entityName);
-                entt::entity gameObject = m_Scene.m_Dictionary.Retrieve(entityName);
-
-                ScriptComponent scriptComponent(filepath);
-                m_Scene.m_Registry.emplace<ScriptComponent>(gameObject, scriptComponent);
-            }
+            return false;
         }
+        LOG_CORE_WARN("Restoring scene snapshot {0}", filepath);
+        return SceneSnapshot::Load(m_Scene, filepath);
     }
 
-    void SceneLoader::Serialize()
+    std::string SceneLoader::GetSnapshotFilepath() const
     {
+        return std::string(SceneSnapshot::CACHE_DIRECTORY) + m_Scene.m_Name + ".snapshot";
     }
 }
@@ -39,8 +39,14 @@ namespace GfxRenderEngine
         void Deserialize();
         void Serialize();
 
+        // binary snapshot written by Serialize(); models must already be loaded
+        // (no load path uses the file snapshot yet, MainScene keeps its checkpoint in memory)
+        bool DeserializeSnapshot();
+
     private:
 
+        std::string GetSnapshotFilepath() const;
+
         void LoadPrefab(const std::string& filepath);
 
     private:
@@ -0,0 +1,673 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include <cstring>
+#include <random>
+#include <fstream>
+#include <unordered_set>
+#include <unordered_map>
+#include <type_traits>
+
+#include "core.h"
+#include "auxiliary/file.h"
+#include "auxiliary/mappedFile.h"
+#include "auxiliary/instrumentation.h"
+#include "renderer/modelCache.h"
+#include "scene/components.h"
+#include "scene/scene.h"
+#include "scene/sceneSnapshot.h"
+
+namespace GfxRenderEngine
+{
+    static_assert(sizeof(entt::entity) == sizeof(uint), "snapshot records store 32-bit entity ids");
+
+    namespace
+    {
+        uint64 GenerateSession()
+        {
+            std::random_device randomDevice;
+            return (static_cast<uint64>(randomDevice()) << 32) | randomDevice();
+        }
+
+        inline uint ToRecord(entt::entity entity)
+        {
+            return static_cast<uint>(entt::to_integral(entity));
+        }
+
+        inline entt::entity ToEntity(uint record)
+        {
+            return static_cast<entt::entity>(record);
+        }
+    }
+
+    const uint64 SceneSnapshot::m_Session = GenerateSession();
+
+    class SceneSnapshot::Writer
+    {
+
+    public:
+
+        StringRef AddString(const std::string& str)
+        {
+            StringRef stringRef{static_cast<uint>(m_Strings.size()), static_cast<uint>(str.size())};
+            m_Strings += str;
+            return stringRef;
+        }
+
+        template<typename T>
+        void AddSection(uint type, const std::vector<T>& records)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "snapshot records must be trivially copyable");
+            auto& section = m_Sections.emplace_back();
+            section.m_Type = type;
+            section.m_Count = static_cast<uint>(records.size());
+            section.m_Bytes.resize(records.size() * sizeof(T));
+            memcpy(section.m_Bytes.data(), records.data(), section.m_Bytes.size());
+        }
+
+        template<typename T>
+        void AddComponents(entt::registry& registry, uint type)
+        {
+            std::vector<ComponentRecord<T>> records;
+            auto view = registry.view<T>();
+            records.reserve(view.size());
+            for (auto entity : view)
+            {
+                ComponentRecord<T> record;
+                memset(&record, 0, sizeof(record));
+                record.m_Entity = ToRecord(entity);
+                record.m_Component = view.template get<T>(entity);
+                records.push_back(record);
+            }
+            AddSection(type, records);
+        }
+
+        void Finish(std::vector<uchar>& data, uint64 session)
+        {
+            auto& strings = m_Sections.emplace_back();
+            strings.m_Type = STRINGS;
+            strings.m_Count = static_cast<uint>(m_Strings.size());
+            strings.m_Bytes.assign(m_Strings.begin(), m_Strings.end());
+
+            uint sectionCount = static_cast<uint>(m_Sections.size());
+            uint64 offset = Align(sizeof(Header) + sectionCount * sizeof(Section));
+            std::vector<Section> sectionTable(sectionCount);
+            for (uint index = 0; index < sectionCount; index++)
+            {
+                sectionTable[index].m_Type   = m_Sections[index].m_Type;
+                sectionTable[index].m_Count  = m_Sections[index].m_Count;
+                sectionTable[index].m_Offset = offset;
+                sectionTable[index].m_Size   = m_Sections[index].m_Bytes.size();
+                offset = Align(offset + m_Sections[index].m_Bytes.size());
+            }
+
+            Header header;
+            memset(&header, 0, sizeof(header));
+            header.m_Magic        = MAGIC;
+            header.m_Version      = VERSION;
+            header.m_Session      = session;
+            header.m_SectionCount = sectionCount;
+            header.m_EntitySize   = sizeof(entt::entity);
+
+            data.assign(offset, 0);
+            memcpy(data.data(), &header, sizeof(Header));
+            memcpy(data.data() + sizeof(Header), sectionTable.data(), sectionCount * sizeof(Section));
+            for (uint index = 0; index < sectionCount; index++)
+            {
+                auto& bytes = m_Sections[index].m_Bytes;
+                if (!bytes.empty())
+                {
+                    memcpy(data.data() + sectionTable[index].m_Offset, bytes.data(), bytes.size());
+                }
+            }
+        }
+
+    private:
+
+        static uint64 Align(uint64 offset)
+        {
+            return (offset + ALIGNMENT - 1) & ~static_cast<uint64>(ALIGNMENT - 1);
+        }
+
+    private:
+
+        struct PendingSection
+        {
+            uint m_Type;
+            uint m_Count;
+            std::vector<uchar> m_Bytes;
+        };
+
+        std::vector<PendingSection> m_Sections;
+        std::string m_Strings;
+
+    };
+
+    class SceneSnapshot::Reader
+    {
+
+    public:
+
+        Reader(const uchar* data, size_t size)
+            : m_Data(data), m_Size(size)
+        {
+            if (!data || (size < sizeof(Header)))
+            {
+                return;
+            }
+            memcpy(&m_Header, data, sizeof(Header));
+            if ((m_Header.m_Magic != MAGIC) || (m_Header.m_Version != VERSION) ||
+                (m_Header.m_EntitySize != sizeof(entt::entity)) ||
+                (sizeof(Header) + static_cast<uint64>(m_Header.m_SectionCount) * sizeof(Section) > size))
+            {
+                return;
+            }
+
+            m_Sections.resize(m_Header.m_SectionCount);
+            memcpy(m_Sections.data(), data + sizeof(Header), m_Sections.size() * sizeof(Section));
+            for (auto& section : m_Sections)
+            {
+                if ((section.m_Offset > size) || (section.m_Size > size - section.m_Offset))
+                {
+                    return;
+                }
+            }
+            m_Valid = true;
+        }
+
+        bool IsValid() const { return m_Valid; }
+        uint64 GetSession() const { return m_Header.m_Session; }
+
+        // an absent section reads as empty
+        template<typename T>
+        bool GetSection(uint type, std::vector<T>& records) const
+        {
+            records.clear();
+            for (auto& section : m_Sections)
+            {
+                if (section.m_Type == type)
+                {
+                    if (section.m_Size != static_cast<uint64>(section.m_Count) * sizeof(T))
+                    {
+                        LOG_CORE_WARN("SceneSnapshot: corrupt section {0}", type);
+                        return false;
+                    }
+                    records.resize(section.m_Count);
+                    memcpy(records.data(), m_Data + section.m_Offset, section.m_Size);
+                    return true;
+                }
+            }
+            return true;
+        }
+
+        template<typename T>
+        void RestoreComponents(entt::registry& registry, uint type) const
+        {
+            std::vector<ComponentRecord<T>> records;
+            GetSection(type, records);
+            registry.clear<T>();
+            for (auto& record : records)
+            {
+                registry.emplace<T>(ToEntity(record.m_Entity), record.m_Component);
+            }
+        }
+
+        std::string GetString(const StringRef& stringRef) const
+        {
+            for (auto& section : m_Sections)
+            {
+                if ((section.m_Type == STRINGS) && (static_cast<uint64>(stringRef.m_Offset) + stringRef.m_Length <= section.m_Size))
+                {
+                    return std::string(reinterpret_cast<const char*>(m_Data + section.m_Offset + stringRef.m_Offset), stringRef.m_Length);
+                }
+            }
+            return std::string();
+        }
+
+    private:
+
+        const uchar* m_Data;
+        size_t m_Size;
+        bool m_Valid{false};
+        Header m_Header{};
+        std::vector<Section> m_Sections;
+
+    };
+
+    void SceneSnapshot::Capture(Scene& scene)
+    {
+        PROFILE_SCOPE("SceneSnapshot::Capture");
+        auto& registry = scene.m_Registry;
+        Writer writer;
+
+        { // entities
+            std::vector<uint> entities;
+            entities.reserve(registry.alive());
+            registry.each([&entities](auto entity) { entities.push_back(ToRecord(entity)); });
+            writer.AddSection(ENTITIES, entities);
+        }
+
+        { // models and meshes
+            m_Models.clear();
+            std::unordered_map<Model*, uint> modelIndices;
+            std::vector<uint64> modelKeys;
+            std::vector<MeshRecord> meshes;
+
+            auto view = registry.view<MeshComponent>();
+            meshes.reserve(view.size());
+            for (auto entity : view)
+            {
+                auto& mesh = view.get<MeshComponent>(entity);
+                auto iterator = modelIndices.find(mesh.m_Model.get());
+                if (iterator == modelIndices.end())
+                {
+                    uint64 key = mesh.m_Model ? mesh.m_Model->GetCacheKey() : 0;
+                    iterator = modelIndices.emplace(mesh.m_Model.get(), static_cast<uint>(modelKeys.size())).first;
+                    modelKeys.push_back(key);
+                    m_Models.push_back(mesh.m_Model);
+                }
+
+                MeshRecord record;
+                memset(&record, 0, sizeof(record));
+                record.m_Entity  = ToRecord(entity);
+                record.m_Model   = iterator->second;
+                record.m_Name    = writer.AddString(mesh.m_Name);
+                record.m_Enabled = mesh.m_Enabled;
+                meshes.push_back(record);
+            }
+            writer.AddSection(MODELS, modelKeys);
+            writer.AddSection(MESHES, meshes);
+        }
+
+        { // transforms
+            std::vector<TransformRecord> transforms;
+            auto view = registry.view<TransformComponent>();
+            transforms.reserve(view.size());
+            for (auto entity : view)
+            {
+                auto& transform = view.get<TransformComponent>(entity);
+                TransformRecord record;
+                memset(&record, 0, sizeof(record));
+                record.m_Entity      = ToRecord(entity);
+                record.m_Scale       = transform.GetScale();
+                record.m_Rotation    = transform.GetRotation();
+                record.m_Translation = transform.GetTranslation();
+                transforms.push_back(record);
+            }
+            writer.AddSection(TRANSFORMS, transforms);
+        }
+
+        { // scripts, the script instances stay with the scene
+            std::vector<ScriptRecord> scripts;
+            auto view = registry.view<ScriptComponent>();
+            for (auto entity : view)
+            {
+                ScriptRecord record;
+                memset(&record, 0, sizeof(record));
+                record.m_Entity   = ToRecord(entity);
+                record.m_Filepath = writer.AddString(view.get<ScriptComponent>(entity).m_Filepath);
+                scripts.push_back(record);
+            }
+            writer.AddSection(SCRIPTS, scripts);
+        }
+
+        { // rigid bodies
+            std::vector<RigidbodyRecord> rigidbodies;
+            auto view = registry.view<RigidbodyComponent>();
+            for (auto entity : view)
+            {
+                auto& rigidbody = view.get<RigidbodyComponent>(entity);
+                RigidbodyRecord record;
+                memset(&record, 0, sizeof(record));
+                record.m_Entity = ToRecord(entity);
+                record.m_Type   = rigidbody.m_Type;
+                record.m_Body   = reinterpret_cast<uint64>(rigidbody.m_Body);
+                rigidbodies.push_back(record);
+            }
+            writer.AddSection(RIGIDBODIES, rigidbodies);
+        }
+
+        writer.AddComponents<PointLightComponent>(registry, POINT_LIGHTS);
+        writer.AddComponents<DefaultDiffuseComponent>(registry, DEFAULT_DIFFUSE);
+        writer.AddComponents<PbrNoMapComponent>(registry, PBR_NO_MAP);
+        writer.AddComponents<PbrDiffuseComponent>(registry, PBR_DIFFUSE);
+        writer.AddComponents<PbrDiffuseNormalComponent>(registry, PBR_DIFFUSE_NORMAL);
+        writer.AddComponents<PbrDiffuseNormalRoughnessMetallicComponent>(registry, PBR_DIFFUSE_NORMAL_ROUGHNESS_METALLIC);
+        writer.AddComponents<PbrDiffuseRoughnessMetallicComponent>(registry, PBR_DIFFUSE_ROUGHNESS_METALLIC);
+
+        { // hierarchy
+            std::vector<HierarchyRecord> hierarchy;
+            std::vector<TreeNode*> stack{&scene.m_SceneHierarchy};
+            while (!stack.empty())
+            {
+                TreeNode* node = stack.back();
+                stack.pop_back();
+
+                HierarchyRecord record;
+                memset(&record, 0, sizeof(record));
+                record.m_Entity   = ToRecord(node->GetGameObject());
+                record.m_Children = node->Children();
+                record.m_Name     = writer.AddString(node->GetName());
+                record.m_LongName = writer.AddString(node->GetLongName());
+                hierarchy.push_back(record);
+
+                // reversed, so that children are visited in order
+                for (uint index = node->Children(); index > 0; index--)
+                {
+                    stack.push_back(&node->GetChild(index - 1));
+                }
+            }
+            writer.AddSection(HIERARCHY, hierarchy);
+        }
+
+        { // dictionary
+            auto& dictionary = scene.m_Dictionary;
+            std::vector<DictionaryRecord> entries;
+            auto addEntry = [&](entt::entity entity, uint map, const std::string& key)
+            {
+                DictionaryRecord record;
+                memset(&record, 0, sizeof(record));
+                record.m_Entity = ToRecord(entity);
+                record.m_Map    = map;
+                record.m_Key    = writer.AddString(key);
+                entries.push_back(record);
+            };
+            for (auto& it : dictionary.m_DictStr2GameObject)
+            {
+                addEntry(it.second, DictionaryRecord::NAME_TO_GAME_OBJECT, it.first);
+            }
+            for (auto& it : dictionary.m_GameObject2ShortStr)
+            {
+                addEntry(it.first, DictionaryRecord::SHORT_NAME, it.second);
+            }
+            for (auto& it : dictionary.m_GameObject2LongStr)
+            {
+                addEntry(it.first, DictionaryRecord::LONG_NAME, it.second);
+            }
+            writer.AddSection(DICTIONARY, entries);
+        }
+
+        writer.Finish(m_Data, m_Session);
+    }
+
+    bool SceneSnapshot::Restore(Scene& scene) const
+    {
+        if (!IsValid())
+        {
+            LOG_CORE_WARN("SceneSnapshot::Restore: nothing captured");
+            return false;
+        }
+        return Restore(scene, m_Data.data(), m_Data.size(), m_Models);
+    }
+
+    bool SceneSnapshot::Save(const std::string& filepath) const
+    {
+        if (!IsValid())
+        {
+            return false;
+        }
+
+        auto directory = std::filesystem::path(filepath).parent_path();
+        if (!directory.empty() && !EngineCore::IsDirectory(directory.string()))
+        {
+            std::error_code errorCode;
+            std::filesystem::create_directories(directory, errorCode);
+        }
+
+        // write to a temporary file first so that a crash never leaves a partial snapshot behind
+        std::string tmpFilepath = filepath + ".tmp";
+        {
+            std::ofstream outputFile(tmpFilepath, std::ios::binary | std::ios::trunc);
+            if (!outputFile.is_open())
+            {
+                LOG_CORE_WARN("SceneSnapshot::Save: could not open {0}", tmpFilepath);
+                return false;
+            }
+            outputFile.write(reinterpret_cast<const char*>(m_Data.data()), m_Data.size());
+            if (!outputFile.good())
+            {
+                LOG_CORE_WARN("SceneSnapshot::Save: could not write {0}", tmpFilepath);
+                return false;
+            }
+        }
+
+        std::error_code errorCode;
+        std::filesystem::rename(tmpFilepath, filepath, errorCode);
+        if (errorCode)
+        {
+            LOG_CORE_WARN("SceneSnapshot::Save: could not rename {0} ({1})", tmpFilepath, errorCode.message());
+            std::filesystem::remove(tmpFilepath, errorCode);
+            return false;
+        }
+        return true;
+    }
+
+    bool SceneSnapshot::Load(Scene& scene, const std::string& filepath)
+    {
+        MappedFile file(filepath);
+        if (!file.IsValid())
+        {
+            LOG_CORE_WARN("SceneSnapshot::Load: could not open {0}", filepath);
+            return false;
+        }
+        return Restore(scene, file.Data(), file.Size(), {});
+    }
+
+    bool SceneSnapshot::Restore(Scene& scene, const uchar* data, size_t size, const std::vector<std::shared_ptr<Model>>& models)
+    {
+        PROFILE_SCOPE("SceneSnapshot::Restore");
+        Reader reader(data, size);
+        if (!reader.IsValid())
+        {
+            LOG_CORE_WARN("SceneSnapshot::Restore: invalid or outdated snapshot");
+            return false;
+        }
+        bool sameSession = (reader.GetSession() == m_Session);
+        auto& registry = scene.m_Registry;
+
+        { // entities: same ids as when captured, components of other types survive
+            std::vector<uint> entities;
+            if (!reader.GetSection(ENTITIES, entities))
+            {
+                return false;
+            }
+            std::unordered_set<uint> snapshotEntities(entities.begin(), entities.end());
+            std::vector<entt::entity> obsoleteEntities;
+            registry.each([&](auto entity)
+            {
+                if (snapshotEntities.find(ToRecord(entity)) == snapshotEntities.end())
+                {
+                    obsoleteEntities.push_back(entity);
+                }
+            });
+            registry.destroy(obsoleteEntities.begin(), obsoleteEntities.end());
+
+            for (auto record : entities)
+            {
+                auto entity = ToEntity(record);
+                if (!registry.valid(entity))
+                {
+                    [[maybe_unused]] auto created = registry.create(entity);
+                    ASSERT(created == entity);
+                }
+            }
+        }
+
+        { // transforms
+            std::vector<TransformRecord> transforms;
+            reader.GetSection(TRANSFORMS, transforms);
+            registry.clear<TransformComponent>();
+            for (auto& record : transforms)
+            {
+                TransformComponent transform{};
+                transform.SetScale(record.m_Scale);
+                transform.SetRotation(record.m_Rotation);
+                transform.SetTranslation(record.m_Translation);
+                registry.emplace<TransformComponent>(ToEntity(record.m_Entity), transform);
+            }
+        }
+
+        { // meshes
+            std::vector<uint64> modelKeys;
+            std::vector<MeshRecord> meshes;
+            reader.GetSection(MODELS, modelKeys);
+            reader.GetSection(MESHES, meshes);
+
+            std::vector<std::shared_ptr<Model>> resolvedModels(modelKeys.size());
+            for (uint index = 0; index < modelKeys.size(); index++)
+            {
+                if ((index < models.size()) && models[index])
+                {
+                    resolvedModels[index] = models[index];
+                }
+                else if (modelKeys[index])
+                {
+                    resolvedModels[index] = ModelCache::Get(modelKeys[index]);
+                }
+            }
+
+            registry.clear<MeshComponent>();
+            for (auto& record : meshes)
+            {
+                if ((record.m_Model >= resolvedModels.size()) || !resolvedModels[record.m_Model])
+                {
+                    LOG_CORE_WARN("SceneSnapshot::Restore: model of mesh '{0}' is not loaded", reader.GetString(record.m_Name));
+                    continue;
+                }
+                MeshComponent mesh{reader.GetString(record.m_Name), resolvedModels[record.m_Model], record.m_Enabled != 0};
+                registry.emplace<MeshComponent>(ToEntity(record.m_Entity), mesh);
+            }
+        }
+
+        { // scripts: running script instances are kept if their file did not change
+            std::vector<ScriptRecord> scripts;
+            reader.GetSection(SCRIPTS, scripts);
+            std::unordered_set<uint> scriptEntities;
+            for (auto& record : scripts)
+            {
+                auto entity = ToEntity(record.m_Entity);
+                auto filepath = reader.GetString(record.m_Filepath);
+                scriptEntities.insert(record.m_Entity);
+
+                auto scriptComponent = registry.try_get<ScriptComponent>(entity);
+                if (!scriptComponent || (scriptComponent->m_Filepath != filepath))
+                {
+                    registry.emplace_or_replace<ScriptComponent>(entity, ScriptComponent(filepath));
+                }
+            }
+            std::vector<entt::entity> obsoleteScripts;
+            for (auto entity : registry.view<ScriptComponent>())
+            {
+                if (scriptEntities.find(ToRecord(entity)) == scriptEntities.end())
+                {
+                    obsoleteScripts.push_back(entity);
+                }
+            }
+            registry.remove<ScriptComponent>(obsoleteScripts.begin(), obsoleteScripts.end());
+        }
+
+        reader.RestoreComponents<PointLightComponent>(registry, POINT_LIGHTS);
+        reader.RestoreComponents<DefaultDiffuseComponent>(registry, DEFAULT_DIFFUSE);
+        reader.RestoreComponents<PbrNoMapComponent>(registry, PBR_NO_MAP);
+
+        // descriptor sets, texture slots and rigid bodies are only valid in the process that captured them
+        if (sameSession)
+        {
+            reader.RestoreComponents<PbrDiffuseComponent>(registry, PBR_DIFFUSE);
+            reader.RestoreComponents<PbrDiffuseNormalComponent>(registry, PBR_DIFFUSE_NORMAL);
+            reader.RestoreComponents<PbrDiffuseNormalRoughnessMetallicComponent>(registry, PBR_DIFFUSE_NORMAL_ROUGHNESS_METALLIC);
+            reader.RestoreComponents<PbrDiffuseRoughnessMetallicComponent>(registry, PBR_DIFFUSE_ROUGHNESS_METALLIC);
+
+            std::vector<RigidbodyRecord> rigidbodies;
+            reader.GetSection(RIGIDBODIES, rigidbodies);
+            registry.clear<RigidbodyComponent>();
+            for (auto& record : rigidbodies)
+            {
+                RigidbodyComponent rigidbody{static_cast<RigidbodyComponent::Type>(record.m_Type), reinterpret_cast<void*>(record.m_Body)};
+                registry.emplace<RigidbodyComponent>(ToEntity(record.m_Entity), rigidbody);
+            }
+        }
+        else
+        {
+            LOG_CORE_WARN("SceneSnapshot::Restore: snapshot of another session, keeping textured materials and rigid bodies");
+        }
+
+        { // hierarchy
+            std::vector<HierarchyRecord> hierarchy;
+            reader.GetSection(HIERARCHY, hierarchy);
+            if (!hierarchy.empty())
+            {
+                Dictionary dictionary;
+                auto& root = hierarchy[0];
+                scene.m_SceneHierarchy = TreeNode{ToEntity(root.m_Entity), reader.GetString(root.m_Name), reader.GetString(root.m_LongName)};
+                uint index = 0;
+                RestoreHierarchy(scene.m_SceneHierarchy, hierarchy, index, reader, dictionary);
+            }
+        }
+
+        { // dictionary
+            std::vector<DictionaryRecord> entries;
+            reader.GetSection(DICTIONARY, entries);
+            auto& dictionary = scene.m_Dictionary;
+            dictionary.m_DictStr2GameObject.clear();
+            dictionary.m_GameObject2ShortStr.clear();
+            dictionary.m_GameObject2LongStr.clear();
+            for (auto& record : entries)
+            {
+                auto entity = ToEntity(record.m_Entity);
+                switch (record.m_Map)
+                {
+                    case DictionaryRecord::NAME_TO_GAME_OBJECT:
+                        dictionary.m_DictStr2GameObject[reader.GetString(record.m_Key)] = entity;
+                        break;
+                    case DictionaryRecord::SHORT_NAME:
+                        dictionary.m_GameObject2ShortStr[entity] = reader.GetString(record.m_Key);
+                        break;
+                    case DictionaryRecord::LONG_NAME:
+                        dictionary.m_GameObject2LongStr[entity] = reader.GetString(record.m_Key);
+                        break;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void SceneSnapshot::RestoreHierarchy(TreeNode& parent, const std::vector<HierarchyRecord>& records, uint& index,
+                                         const Reader& reader, Dictionary& dictionary)
+    {
+        uint children = records[index].m_Children;
+        for (uint child = 0; child < children; child++)
+        {
+            index++;
+            if (index >= records.size())
+            {
+                LOG_CORE_WARN("SceneSnapshot::Restore: truncated hierarchy");
+                return;
+            }
+            auto& record = records[index];
+            TreeNode node{ToEntity(record.m_Entity), reader.GetString(record.m_Name), reader.GetString(record.m_LongName)};
+            TreeNode* newNode = parent.AddChild(node, dictionary);
+            RestoreHierarchy(*newNode, records, index, reader, dictionary);
+        }
+    }
+}
@@ -0,0 +1,195 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "engine.h"
+#include "entt.hpp"
+#include "renderer/model.h"
+
+namespace GfxRenderEngine
+{
+    class Scene;
+    class TreeNode;
+    class Dictionary;
+
+    // versioned binary image of a scene: the engine components of the registry,
+    // the scene hierarchy and the dictionary; every section is an aligned array
+    // of fixed-size records, so a memory-mapped file restores with bulk copies
+    //
+    // models are referenced by their model cache key (content hash), in-memory
+    // checkpoints additionally keep their models alive; descriptor sets, texture
+    // slots and rigid bodies are process-local handles and are only restored
+    // into the process that captured them
+    class SceneSnapshot
+    {
+
+    public:
+
+        static constexpr uint MAGIC = 0x50414e53; // "SNAP"
+        static constexpr uint VERSION = 1;
+        static constexpr uint ALIGNMENT = 16;
+        static constexpr const char* CACHE_DIRECTORY = "bin/cache/scenes/";
+
+    public:
+
+        SceneSnapshot() {}
+        ~SceneSnapshot() {}
+
+        // in-memory checkpoint; entity ids are preserved by Restore()
+        void Capture(Scene& scene);
+        bool Restore(Scene& scene) const;
+
+        bool Save(const std::string& filepath) const;
+        // restores directly from a memory mapping of the file
+        static bool Load(Scene& scene, const std::string& filepath);
+
+        bool IsValid() const { return !m_Data.empty(); }
+        size_t Size() const { return m_Data.size(); }
+
+    private:
+
+        enum SectionType : uint
+        {
+            ENTITIES = 0,
+            MODELS,
+            TRANSFORMS,
+            MESHES,
+            POINT_LIGHTS,
+            SCRIPTS,
+            DEFAULT_DIFFUSE,
+            PBR_NO_MAP,
+            PBR_DIFFUSE,
+            PBR_DIFFUSE_NORMAL,
+            PBR_DIFFUSE_NORMAL_ROUGHNESS_METALLIC,
+            PBR_DIFFUSE_ROUGHNESS_METALLIC,
+            RIGIDBODIES,
+            HIERARCHY,
+            DICTIONARY,
+            STRINGS,
+            NUMBER_OF_SECTIONS
+        };
+
+        struct Header
+        {
+            uint m_Magic;
+            uint m_Version;
+            uint64 m_Session;
+            uint m_SectionCount;
+            uint m_EntitySize;
+        };
+
+        struct Section
+        {
+            uint m_Type;
+            uint m_Count;
+            uint64 m_Offset;
+            uint64 m_Size;
+        };
+
+        struct StringRef
+        {
+            uint m_Offset;
+            uint m_Length;
+        };
+
+        struct TransformRecord
+        {
+            uint m_Entity;
+            glm::vec3 m_Scale;
+            glm::vec3 m_Rotation;
+            glm::vec3 m_Translation;
+        };
+
+        struct MeshRecord
+        {
+            uint m_Entity;
+            uint m_Model; // index into the model section
+            StringRef m_Name;
+            uint m_Enabled;
+        };
+
+        struct ScriptRecord
+        {
+            uint m_Entity;
+            StringRef m_Filepath;
+        };
+
+        struct RigidbodyRecord
+        {
+            uint m_Entity;
+            uint m_Type;
+            uint64 m_Body;
+        };
+
+        // pre-order, each node is followed by its subtrees
+        struct HierarchyRecord
+        {
+            uint m_Entity;
+            uint m_Children;
+            StringRef m_Name;
+            StringRef m_LongName;
+        };
+
+        struct DictionaryRecord
+        {
+            enum Map : uint
+            {
+                NAME_TO_GAME_OBJECT = 0,
+                SHORT_NAME,
+                LONG_NAME
+            };
+
+            uint m_Entity;
+            uint m_Map;
+            StringRef m_Key;
+        };
+
+        template<typename T>
+        struct ComponentRecord
+        {
+            uint m_Entity;
+            T m_Component;
+        };
+
+        class Reader;
+        class Writer;
+
+    private:
+
+        static bool Restore(Scene& scene, const uchar* data, size_t size, const std::vector<std::shared_ptr<Model>>& models);
+        static void RestoreHierarchy(TreeNode& parent, const std::vector<HierarchyRecord>& records, uint& index,
+                                     const Reader& reader, Dictionary& dictionary);
+
+    private:
+
+        std::vector<uchar> m_Data;
+        std::vector<std::shared_ptr<Model>> m_Models;
+
+        static const uint64 m_Session;
+
+    };
+}
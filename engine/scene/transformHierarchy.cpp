@@ -0,0 +1,114 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#include "core.h"
+#include "scene/components.h"
+#include "scene/transformHierarchy.h"
+
+namespace GfxRenderEngine
+{
+
+    void TransformHierarchy::Build(TreeNode& sceneHierarchy)
+    {
+        m_GameObjects.clear();
+        m_Parents.clear();
+        m_LevelOffsets.clear();
+
+        // breadth-first: parents precede their children, levels are contiguous
+        std::vector<TreeNode*> nodes{&sceneHierarchy};
+        m_GameObjects.push_back(sceneHierarchy.GetGameObject());
+        m_Parents.push_back(NO_PARENT);
+        m_LevelOffsets.push_back(0);
+
+        uint levelBegin = 0;
+        while (levelBegin < nodes.size())
+        {
+            uint levelEnd = static_cast<uint>(nodes.size());
+            m_LevelOffsets.push_back(levelEnd);
+            for (uint parent = levelBegin; parent < levelEnd; parent++)
+            {
+                TreeNode* node = nodes[parent];
+                for (uint index = 0; index < node->Children(); index++)
+                {
+                    TreeNode& child = node->GetChild(index);
+                    nodes.push_back(&child);
+                    m_GameObjects.push_back(child.GetGameObject());
+                    m_Parents.push_back(parent);
+                }
+            }
+            levelBegin = levelEnd;
+        }
+
+        // all nodes are updated after a rebuild
+        m_GlobalMatrices.assign(m_GameObjects.size(), glm::mat4(1.0f));
+        m_DirtyFlags.assign(m_GameObjects.size(), false);
+        m_ForceUpdate = true;
+
+        m_Root = &sceneHierarchy;
+        m_StructureRevision = TreeNode::GetStructureRevision();
+    }
+
+    void TransformHierarchy::Update(entt::registry& registry, TreeNode& sceneHierarchy)
+    {
+        bool rebuild = (m_Root != &sceneHierarchy) || (m_StructureRevision != TreeNode::GetStructureRevision());
+        if (rebuild)
+        {
+            Build(sceneHierarchy);
+        }
+
+        // nodes of one level only depend on the previous level
+        auto& jobSystem = Engine::m_Engine->GetJobSystem();
+        for (uint level = 0; level < Levels(); level++)
+        {
+            uint begin = m_LevelOffsets[level];
+            uint end = m_LevelOffsets[level + 1];
+            jobSystem.ParallelFor("TransformHierarchy::UpdateLevel", end - begin, NODES_PER_JOB, [&](uint first, uint last)
+            {
+                UpdateLevel(registry, begin + first, begin + last);
+            });
+        }
+        m_ForceUpdate = false;
+    }
+
+    void TransformHierarchy::UpdateLevel(entt::registry& registry, uint begin, uint end)
+    {
+        auto view = registry.view<TransformComponent>();
+        for (uint index = begin; index < end; index++)
+        {
+            auto& transform = view.get<TransformComponent>(m_GameObjects[index]);
+            uint parent = m_Parents[index];
+
+            bool parentDirtyFlag = (parent != NO_PARENT) && m_DirtyFlags[parent];
+            bool dirtyFlag = m_ForceUpdate || transform.GetDirtyFlag() || parentDirtyFlag;
+
+            if (dirtyFlag)
+            {
+                // GetMat4() recalculates the local matrix from scale, rotation, and translation
+                transform.SetDirtyFlag();
+                const glm::mat4& localMat4 = transform.GetMat4();
+                m_GlobalMatrices[index] = (parent == NO_PARENT) ? localMat4 : m_GlobalMatrices[parent] * localMat4;
+                transform.SetMat4(m_GlobalMatrices[index]);
+            }
+            m_DirtyFlags[index] = dirtyFlag;
+        }
+    }
+}
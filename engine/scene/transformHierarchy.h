@@ -0,0 +1,74 @@
+/* Engine Copyright (c) 2022 Engine Development Team 
+   https://github.com/beaumanvienna/gfxRenderEngine
+
+   Permission is hereby granted, free of charge, to any person
+   obtaining a copy of this software and associated documentation files
+   (the "Software"), to deal in the Software without restriction,
+   including without limitation the rights to use, copy, modify, merge,
+   publish, distribute, sublicense, and/or sell copies of the Software,
+   and to permit persons to whom the Software is furnished to do so,
+   subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be
+   included in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS 
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+   MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+   IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+   CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+   TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+   SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE. */
+
+#pragma once
+
+#include <vector>
+
+#include "engine.h"
+#include "entt.hpp"
+#include "scene/treeNode.h"
+
+namespace GfxRenderEngine
+{
+
+    // flat copy of the scene hierarchy, sorted by depth so that parents
+    // always come before their children; global matrices are updated
+    // in one linear pass, only for dirty subtrees
+    class TransformHierarchy
+    {
+
+    public:
+
+        static constexpr uint NO_PARENT = static_cast<uint>(-1);
+        static constexpr uint NODES_PER_JOB = 1024;
+
+    public:
+
+        void Update(entt::registry& registry, TreeNode& sceneHierarchy);
+
+        uint Size() const { return static_cast<uint>(m_GameObjects.size()); }
+        uint Levels() const { return static_cast<uint>(m_LevelOffsets.size()) - 1; }
+
+    private:
+
+        void Build(TreeNode& sceneHierarchy);
+        void UpdateLevel(entt::registry& registry, uint begin, uint end);
+
+    private:
+
+        TreeNode* m_Root{nullptr};
+        uint64 m_StructureRevision{0};
+        bool m_ForceUpdate{false};
+
+        // structure of arrays, one entry per node
+        std::vector<entt::entity> m_GameObjects;
+        std::vector<uint> m_Parents;
+        std::vector<glm::mat4> m_GlobalMatrices;
+        std::vector<uchar> m_DirtyFlags;
+
+        // nodes of depth d are in [m_LevelOffsets[d], m_LevelOffsets[d+1])
+        // and can be updated independently of each other
+        std::vector<uint> m_LevelOffsets;
+
+    };
+}
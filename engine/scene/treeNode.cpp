@@ -24,6 +24,8 @@
 
 namespace GfxRenderEngine
 {
+    std::atomic<uint64> TreeNode::m_StructureRevision{0};
+
     TreeNode::TreeNode(entt::entity gameObject,
                        const std::string& name,
                        const std::string& longName)
@@ -65,12 +67,14 @@ namespace GfxRenderEngine
         dictionary.InsertShort(node.GetName(), node.GetGameObject());
         dictionary.InsertLong(node.GetLongName(), node.GetGameObject());
         m_Children.push_back(node);
+        m_StructureRevision.fetch_add(1, std::memory_order_release);
         return &m_Children.back();
     }
 
     void TreeNode::SetGameObject(entt::entity gameObject)
     {
         m_GameObject = gameObject;
+        m_StructureRevision.fetch_add(1, std::memory_order_release);
     }
 
     void TreeNode::Traverse(TreeNode& node, uint indent)
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "engine.h"
@@ -51,6 +52,10 @@ namespace GfxRenderEngine
 
         static void Traverse(TreeNode& node, uint indent = 0);
 
+        // incremented whenever any hierarchy changes its structure,
+        // atomic because scenes are built on worker threads
+        static uint64 GetStructureRevision() { return m_StructureRevision.load(std::memory_order_acquire); }
+
     private:
 
         std::string m_Name;
@@ -58,5 +63,7 @@ namespace GfxRenderEngine
         entt::entity m_GameObject;
         std::vector<TreeNode> m_Children;
 
+        static std::atomic<uint64> m_StructureRevision;
+
     };
 }
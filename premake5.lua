@@ -180,4 +180,5 @@ project "lucre"
         kind "WindowedApp"
 
     include "engine.lua"
-
+    include "benchmark.lua"
+    include "assetcooker.lua"